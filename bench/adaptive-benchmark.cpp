@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/render.hpp"
+#include "../lib/sample_buffer.hpp"
+
+namespace {
+
+    struct ImageError {
+        double rmse;
+        double worst_block_rmse;
+    };
+
+    // Erro médio quadrático entre duas imagens já com a correção gamma, isto é, na escala em que a
+    // imagem é vista (e quantizada para 8 bits). Além do erro da imagem inteira, mede o erro do pior
+    // bloco de BLOCK x BLOCK pixels: o ruído é percebido onde ele é mais visível, não na média.
+    ImageError display_error(const SampleBuffer &image, const SampleBuffer &reference) {
+        constexpr int BLOCK = 16;
+
+        double squared_error = 0.0;
+        double worst_block = 0.0;
+
+        for (int block_j = 0; block_j < image.height(); block_j += BLOCK) {
+            for (int block_i = 0; block_i < image.width(); block_i += BLOCK) {
+                double block_error = 0.0;
+                int block_pixels = 0;
+
+                for (int j = block_j; j < std::min(block_j + BLOCK, image.height()); ++j) {
+                    for (int i = block_i; i < std::min(block_i + BLOCK, image.width()); ++i) {
+                        auto a = image.pixel(i, j).mean();
+                        auto b = reference.pixel(i, j).mean();
+
+                        for (int axis = 0; axis < 3; ++axis) {
+                            auto difference = std::sqrt(std::max(a[axis], 0.0)) - std::sqrt(std::max(b[axis], 0.0));
+                            block_error += difference * difference;
+                        }
+                        ++block_pixels;
+                    }
+                }
+
+                squared_error += block_error;
+                worst_block = std::max(worst_block, block_error / (3.0 * block_pixels));
+            }
+        }
+
+        return ImageError{std::sqrt(squared_error / (3.0 * image.width() * image.height())), std::sqrt(worst_block)};
+    }
+
+} // namespace
+
+// Compara a amostragem fixa com a adaptativa na cena padrão: tempo, amostras por pixel e erro em
+// relação a uma referência com 2048 amostras por pixel (semente diferente, para não correlacionar)
+RT_BENCHMARK(adaptive_sampling) {
+    constexpr int WIDTH = 240;
+
+    auto world = Render::default_scene();
+
+    SampleBuffer reference;
+    {
+        Render render{WIDTH};
+        render.set_seed(99);
+        render.set_samples_per_pixel(2048);
+        render.render(world, reference);
+    }
+
+    auto measure = [&](const std::string &name, int max_samples, int min_samples, double threshold) {
+        Render render{WIDTH};
+        render.set_samples_per_pixel(max_samples);
+        render.set_adaptive_sampling(min_samples, threshold);
+
+        SampleBuffer image;
+        double seconds = Bench::elapsed_seconds([&]() { render.render(world, image); });
+
+        auto error = display_error(image, reference);
+
+        Bench::report("adaptive_sampling/" + name, {
+            {"seconds", seconds},
+            {"mean_spp", double(image.total_samples()) / (double(image.width()) * image.height())},
+            {"display_rmse", error.rmse},
+            {"worst_block_rmse", error.worst_block_rmse},
+        });
+    };
+
+    for (int samples : {50, 100, 200, 400})
+        measure("fixed_" + std::to_string(samples), samples, samples, 0.0);
+
+    for (double threshold : {0.02, 0.01, 0.005, 0.0025})
+        measure("adaptive_" + std::to_string(threshold), 400, 16, threshold);
+}
@@ -0,0 +1,42 @@
+#ifndef _BENCHMARK_HPP_
+#define _BENCHMARK_HPP_
+
+#include <chrono>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+// Infraestrutura mínima dos benchmarks: cada arquivo em bench/ registra as suas funções com
+// RT_BENCHMARK e o main executa todas (ou apenas as que contêm o filtro passado na linha de comando).
+namespace Bench {
+
+    using Function = void (*)();
+
+    bool register_benchmark(const char *name, Function function);
+
+    // Imprime uma linha de resultado no formato "nome  métrica=valor métrica=valor ..." e guarda o
+    // resultado para o relatório em JSON (--json)
+    void report(const std::string &name, std::initializer_list<std::pair<const char *, double>> metrics);
+
+    // Tempo de parede, em segundos, para executar function uma vez
+    template <typename Callable>
+    double elapsed_seconds(Callable &&function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    // Resultados acumulados aqui impedem que o compilador descarte o cálculo medido
+    inline volatile double g_sink = 0.0;
+
+    inline void keep(double value) { g_sink = g_sink + value; }
+
+} // namespace
+
+#define RT_BENCHMARK(function)                                                                   \
+    static void function();                                                                      \
+    static const bool function##_registered = Bench::register_benchmark(#function, function);   \
+    static void function()
+
+#endif // _BENCHMARK_HPP_
@@ -0,0 +1,92 @@
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../lib/bvh.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/random.hpp"
+
+namespace {
+
+    // Esferas espalhadas uniformemente no cubo [-1, 1]³. O raio diminui com N^(-1/3), de modo que a
+    // fração do volume ocupada pelas esferas é a mesma para todo N (como em uma cena real sendo
+    // refinada): o raio percorre sempre "o mesmo número de esferas" até acertar uma, e a única coisa
+    // que muda entre as medições é o custo de encontrar a esfera certa.
+    std::vector<std::shared_ptr<Hittable>> random_spheres(std::size_t count, Pcg32 &generator) {
+        std::vector<std::shared_ptr<Hittable>> spheres;
+        spheres.reserve(count);
+
+        double radius = 0.5 / std::cbrt(double(count));
+
+        for (std::size_t k = 0; k < count; ++k) {
+            Vec3 center{2 * generator.next_double() - 1, 2 * generator.next_double() - 1, 2 * generator.next_double() - 1};
+            spheres.push_back(std::make_shared<Sphere>(center, radius, 0));
+        }
+
+        return spheres;
+    }
+
+    // Raios partindo de fora do cubo em direção a pontos aleatórios dentro dele
+    std::vector<Ray> random_rays(std::size_t count, Pcg32 &generator) {
+        std::vector<Ray> rays;
+        rays.reserve(count);
+
+        for (std::size_t k = 0; k < count; ++k) {
+            Vec3 origin{2 * generator.next_double() - 1, 2 * generator.next_double() - 1, 2 * generator.next_double() - 1};
+            origin = 3.0 * origin.unit();
+
+            Vec3 target{generator.next_double() - 0.5, generator.next_double() - 0.5, generator.next_double() - 0.5};
+            rays.emplace_back(origin, target - origin);
+        }
+
+        return rays;
+    }
+
+    template <typename World>
+    double nanoseconds_per_ray(const World &world, const std::vector<Ray> &rays) {
+        std::size_t hits = 0;
+
+        double seconds = Bench::elapsed_seconds([&]() {
+            HitRecord record;
+            for (const auto &ray : rays)
+                hits += world.hit(ray, Interval(0.001, Utility::INFTY), record);
+        });
+
+        Bench::keep(double(hits));
+        return 1e9 * seconds / rays.size();
+    }
+
+} // namespace
+
+// Compara o custo por raio do laço linear de HittableList com a BVH conforme o número de esferas
+// cresce. O laço linear só é medido até 10^4 esferas, a partir daí ele levaria tempo demais.
+RT_BENCHMARK(bvh_vs_linear) {
+    constexpr std::size_t RAY_COUNT = 20000;
+    constexpr std::size_t MAX_LINEAR_OBJECTS = 10000;
+
+    Pcg32 generator{2024};
+    auto rays = random_rays(RAY_COUNT, generator);
+
+    for (std::size_t count : {10, 100, 1000, 10000, 100000, 1000000}) {
+        HittableList world;
+        world.objects = random_spheres(count, generator);
+
+        double linear_ns = 0.0;
+        if (count <= MAX_LINEAR_OBJECTS)
+            linear_ns = nanoseconds_per_ray(world, rays);
+
+        std::unique_ptr<BVH> bvh;
+        double build_seconds = Bench::elapsed_seconds([&]() { bvh = std::make_unique<BVH>(world.objects); });
+
+        double bvh_ns = nanoseconds_per_ray(*bvh, rays);
+
+        Bench::report("bvh_vs_linear/" + std::to_string(count), {
+            {"linear_ns_per_ray", linear_ns},
+            {"bvh_ns_per_ray", bvh_ns},
+            {"build_ms", 1e3 * build_seconds},
+            {"nodes", double(bvh->node_count())},
+        });
+    }
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/denoiser.hpp"
+#include "../lib/render.hpp"
+
+namespace {
+
+    // Erro quadrático médio em relação à referência, depois da correção gamma
+    double display_rmse(const Framebuffer &image, const Framebuffer &reference) {
+        double sum = 0.0;
+        for (int j = 0; j < image.height(); ++j) {
+            for (int i = 0; i < image.width(); ++i) {
+                for (int channel = 0; channel < 3; ++channel) {
+                    double difference = std::sqrt(std::max(image.pixel(i, j)[channel], 0.0))
+                                      - std::sqrt(std::max(reference.pixel(i, j)[channel], 0.0));
+                    sum += difference * difference;
+                }
+            }
+        }
+        return std::sqrt(sum / (3.0 * image.width() * image.height()));
+    }
+
+    SampleBuffer render_samples(const HittableList &world, int width, int samples, std::uint64_t seed) {
+        Render render{width};
+        render.set_samples_per_pixel(samples);
+        render.set_seed(seed);
+        render.set_quiet(true);
+
+        SampleBuffer buffer;
+        while (!render.render(world, buffer)) {}
+        return buffer;
+    }
+
+} // namespace
+
+// Qualidade da cena padrão com poucas amostras filtradas contra muitas amostras sem filtro, medida
+// pelo erro em relação a uma referência de 1024 amostras por pixel, e o tempo do filtro
+RT_BENCHMARK(denoiser) {
+    constexpr int WIDTH = 320;
+
+    auto world = Render::default_scene();
+
+    Framebuffer reference;
+    render_samples(world, WIDTH, 1024, 99).resolve(reference);
+
+    for (int samples : {8, 16, 64, 128}) {
+        auto buffer = render_samples(world, WIDTH, samples, 3);
+
+        Framebuffer raw, denoised;
+        buffer.resolve(raw);
+
+        ThreadPool pool;
+        double seconds = Bench::elapsed_seconds([&]() { Denoiser{}.apply(buffer, denoised, &pool); });
+
+        Bench::report("denoiser/" + std::to_string(samples) + "spp", {
+            {"raw_rmse", display_rmse(raw, reference)},
+            {"denoised_rmse", display_rmse(denoised, reference)},
+            {"denoise_ms", 1e3 * seconds},
+        });
+    }
+}
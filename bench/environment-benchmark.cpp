@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/environment.hpp"
+#include "../lib/render.hpp"
+
+namespace {
+
+    // Céu de 512 x 256 pixels: gradiente do horizonte (claro) ao zênite (azul), chão escuro abaixo do
+    // horizonte e um sol de meio grau de diâmetro com quase toda a energia do mapa
+    std::shared_ptr<EnvironmentMap> sunny_sky() {
+        constexpr int WIDTH = 512, HEIGHT = 256;
+        const Vec3 sun_direction = Vec3{0.6, 0.5, -0.4}.unit();
+
+        std::vector<float> rgb(3 * std::size_t(WIDTH) * HEIGHT);
+        for (int y = 0; y < HEIGHT; ++y) {
+            for (int x = 0; x < WIDTH; ++x) {
+                double theta = Utility::PI * (y + 0.5) / HEIGHT;
+                double phi = 2.0 * Utility::PI * ((x + 0.5) / WIDTH - 0.5);
+                Vec3 direction{std::sin(theta) * std::sin(phi), std::cos(theta), -std::sin(theta) * std::cos(phi)};
+
+                double a = std::max(direction.y(), 0.0);
+                Vec3 color = direction.y() < 0.0 ? Vec3{0.1, 0.1, 0.1} : (1.0 - a) * Vec3{0.8, 0.85, 0.9} + a * Vec3{0.3, 0.5, 0.9};
+
+                if (direction * sun_direction > std::cos(Utility::degrees_to_radian(0.5)))
+                    color = Vec3{50000, 47000, 42000};
+
+                float *pixel = &rgb[3 * (std::size_t(y) * WIDTH + x)];
+                pixel[0] = float(color.x());
+                pixel[1] = float(color.y());
+                pixel[2] = float(color.z());
+            }
+        }
+
+        auto environment = std::make_shared<EnvironmentMap>();
+        environment->assign(WIDTH, HEIGHT, std::move(rgb));
+        return environment;
+    }
+
+    // Erro quadrático médio em relação à referência, depois da correção gamma e do corte em 1
+    double display_rmse(const Framebuffer &image, const Framebuffer &reference) {
+        auto display = [](double value) { return std::sqrt(std::clamp(value, 0.0, 1.0)); };
+
+        double sum = 0.0;
+        for (int j = 0; j < image.height(); ++j) {
+            for (int i = 0; i < image.width(); ++i) {
+                for (int channel = 0; channel < 3; ++channel) {
+                    double difference = display(image.pixel(i, j)[channel]) - display(reference.pixel(i, j)[channel]);
+                    sum += difference * difference;
+                }
+            }
+        }
+        return std::sqrt(sum / (3.0 * image.width() * image.height()));
+    }
+
+    Framebuffer render_image(const HittableList &world, int width, int samples, std::uint64_t seed) {
+        Render render{width};
+        render.set_samples_per_pixel(samples);
+        render.set_seed(seed);
+        render.set_quiet(true);
+
+        Framebuffer framebuffer;
+        render.render(world, framebuffer);
+        return framebuffer;
+    }
+
+} // namespace
+
+// Cena padrão iluminada pelo céu com sol: erro em relação a uma referência de 1024 amostras por pixel
+// com o mapa amostrado pela distribuição tabelada e com o mapa encontrado apenas pelos quiques
+RT_BENCHMARK(environment_sampling) {
+    constexpr int WIDTH = 160;
+
+    auto environment = sunny_sky();
+
+    auto world = Render::default_scene();
+    world.lights.set_environment(environment);
+
+    auto background_only = Render::default_scene();
+    background_only.lights.set_environment(environment, false);
+
+    auto reference = render_image(world, WIDTH, 1024, 99);
+
+    for (int samples : {4, 16, 64}) {
+        for (const auto *variant : {&world, &background_only}) {
+            Framebuffer image;
+            double seconds = Bench::elapsed_seconds([&]() { image = render_image(*variant, WIDTH, samples, 3); });
+
+            Bench::report(std::string("environment_sampling/") + (variant == &world ? "importance" : "bounces") + "/" + std::to_string(samples) + "spp", {
+                {"rmse", display_rmse(image, reference)},
+                {"render_ms", 1e3 * seconds},
+            });
+        }
+    }
+
+    // Montagem das tabelas da distribuição de um mapa de 2048 x 1024 pixels
+    std::vector<float> large(3 * 2048 * 1024, 1.0f);
+    EnvironmentMap map;
+    double seconds = Bench::elapsed_seconds([&]() { map.assign(2048, 1024, large); });
+    Bench::report("environment_sampling/build_2048x1024", {{"ms", 1e3 * seconds}});
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/render.hpp"
+
+namespace {
+
+    // Sala fechada iluminada apenas por uma lâmpada pequena (a mesma de scenes/lamp.txt)
+    HittableList lamp_scene() {
+        HittableList world;
+
+        auto wall = world.materials.add(Lambertian{Vec3{0.7, 0.7, 0.7}});
+        auto floor = world.materials.add(Lambertian{Vec3{0.8, 0.5, 0.3}});
+        auto blue = world.materials.add(Lambertian{Vec3{0.1, 0.2, 0.5}});
+        auto mirror = world.materials.add(Metal{Vec3{0.8, 0.8, 0.8}});
+        auto lamp = world.materials.add(Emissive{Vec3{80, 72, 60}});
+
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0,     0.0,  0.0),    4.0, wall));
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0, -1000.5,  0.0), 1000.0, floor));
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0,     0.0, -1.2),    0.5, blue));
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 1.1,     0.0, -1.5),    0.5, mirror));
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3(-0.6,     1.2, -0.8),    0.1, lamp));
+
+        world.build_acceleration();
+        world.lights.add_emissive(world.objects, world.materials);
+        return world;
+    }
+
+    // Erro quadrático médio em relação à referência, depois da correção gamma e do corte em 1 da imagem
+    // gravada (a própria lâmpada, muito mais clara que o resto, não domina o erro)
+    double display_rmse(const Framebuffer &image, const Framebuffer &reference) {
+        auto display = [](double value) { return std::sqrt(std::clamp(value, 0.0, 1.0)); };
+
+        double sum = 0.0;
+        for (int j = 0; j < image.height(); ++j) {
+            for (int i = 0; i < image.width(); ++i) {
+                for (int channel = 0; channel < 3; ++channel) {
+                    double difference = display(image.pixel(i, j)[channel]) - display(reference.pixel(i, j)[channel]);
+                    sum += difference * difference;
+                }
+            }
+        }
+        return std::sqrt(sum / (3.0 * image.width() * image.height()));
+    }
+
+    Framebuffer render_image(const HittableList &world, int width, int samples, std::uint64_t seed) {
+        Render render{width};
+        render.set_samples_per_pixel(samples);
+        render.set_seed(seed);
+        render.set_quiet(true);
+
+        Framebuffer framebuffer;
+        render.render(world, framebuffer);
+        return framebuffer;
+    }
+
+} // namespace
+
+// Erro da sala com a lâmpada em relação a uma referência de 1024 amostras por pixel, com e sem a
+// amostragem direta das luzes, e o tempo de cada renderização (os raios de sombra custam a mais). Os
+// reflexos da lâmpada na esfera metálica (difuso -> metal -> lâmpada) só são encontrados pelos quiques e
+// ficam como o ruído que sobra com a amostragem direta.
+RT_BENCHMARK(light_sampling) {
+    constexpr int WIDTH = 160;
+
+    auto world = lamp_scene();
+    auto reference = render_image(world, WIDTH, 1024, 99);
+
+    auto without_lights = world;
+    without_lights.lights.clear();
+
+    for (int samples : {4, 16, 64}) {
+        for (const auto *variant : {&world, &without_lights}) {
+            Framebuffer image;
+            double seconds = Bench::elapsed_seconds([&]() { image = render_image(*variant, WIDTH, samples, 3); });
+
+            Bench::report(std::string("light_sampling/") + (variant == &world ? "nee" : "bounces") + "/" + std::to_string(samples) + "spp", {
+                {"rmse", display_rmse(image, reference)},
+                {"render_ms", 1e3 * seconds},
+            });
+        }
+    }
+}
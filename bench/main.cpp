@@ -0,0 +1,139 @@
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace {
+
+    struct RegisteredBenchmark {
+        const char *name;
+        Bench::Function function;
+    };
+
+    struct Result {
+        std::string name;
+        std::vector<std::pair<std::string, double>> metrics;
+    };
+
+    // NOTE: função com variável estática para não depender da ordem de inicialização entre arquivos
+    std::vector<RegisteredBenchmark> &registry() {
+        static std::vector<RegisteredBenchmark> benchmarks;
+        return benchmarks;
+    }
+
+    std::vector<Result> &results() {
+        static std::vector<Result> reported;
+        return reported;
+    }
+
+    std::string json_string(const std::string &text) {
+        std::string escaped = "\"";
+
+        for (char c : text) {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+            escaped += c;
+        }
+
+        return escaped + '"';
+    }
+
+    // JSON não representa NaN nem infinito
+    std::string json_number(double value) {
+        if (!std::isfinite(value))
+            return "null";
+
+        std::ostringstream out;
+        out << std::setprecision(9) << value;
+        return out.str();
+    }
+
+    // Um objeto por execução: informações da compilação e da máquina, seguidas de todos os resultados
+    // na ordem em que foram reportados, para comparar o desempenho entre versões do programa
+    bool write_json(const char *filename) {
+        std::ofstream out{filename};
+
+#ifdef __VERSION__
+        const char *compiler = __VERSION__;
+#else
+        const char *compiler = "desconhecido";
+#endif
+
+#ifdef NDEBUG
+        bool optimized = true;
+#else
+        bool optimized = false;
+#endif
+
+        out << "{\n";
+        out << "  \"compiler\": " << json_string(compiler) << ",\n";
+        out << "  \"ndebug\": " << (optimized ? "true" : "false") << ",\n";
+        out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "  \"benchmarks\": [";
+
+        for (std::size_t k = 0; k < results().size(); ++k) {
+            const auto &result = results()[k];
+
+            out << (k == 0 ? "\n" : ",\n") << "    {\"name\": " << json_string(result.name) << ", \"metrics\": {";
+            for (std::size_t m = 0; m < result.metrics.size(); ++m) {
+                out << (m == 0 ? "" : ", ") << json_string(result.metrics[m].first) << ": "
+                    << json_number(result.metrics[m].second);
+            }
+            out << "}}";
+        }
+
+        out << "\n  ]\n}\n";
+        return bool(out);
+    }
+
+} // namespace
+
+bool Bench::register_benchmark(const char *name, Function function) {
+    registry().push_back(RegisteredBenchmark{name, function});
+    return true;
+}
+
+void Bench::report(const std::string &name, std::initializer_list<std::pair<const char *, double>> metrics) {
+    std::cout << std::left << std::setw(40) << name;
+
+    Result result{name, {}};
+    for (const auto &metric : metrics) {
+        std::cout << ' ' << metric.first << '=' << metric.second;
+        result.metrics.emplace_back(metric.first, metric.second);
+    }
+
+    std::cout << std::endl;
+    results().push_back(std::move(result));
+}
+
+// Uso: ./ray_tracing_bench [--json arquivo] [filtro]
+auto main(int argc, char *argv[]) -> int {
+    const char *filter = "";
+    const char *json_filename = nullptr;
+
+    for (int k = 1; k < argc; ++k) {
+        if (std::strcmp(argv[k], "--json") == 0 && k + 1 < argc)
+            json_filename = argv[++k];
+        else
+            filter = argv[k];
+    }
+
+    for (const auto &benchmark : registry()) {
+        if (std::strstr(benchmark.name, filter) != nullptr)
+            benchmark.function();
+    }
+
+    if (json_filename != nullptr && !write_json(json_filename)) {
+        std::cerr << "[ERRO] não foi possível escrever " << json_filename << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/instance.hpp"
+#include "../lib/random.hpp"
+#include "../lib/triangle_mesh.hpp"
+
+namespace {
+
+    // Esfera "ondulada" com 2 * rings * segments triângulos, centrada em (0, 0, -3)
+    void wavy_sphere(int rings, int segments, std::vector<double> &vertices, std::vector<std::uint32_t> &indices) {
+        for (int ring = 0; ring <= rings; ++ring) {
+            double theta = Utility::PI * ring / rings;
+
+            for (int segment = 0; segment <= segments; ++segment) {
+                double phi = 2 * Utility::PI * segment / segments;
+                double radius = 1.0 + 0.05 * std::sin(7 * theta) * std::cos(9 * phi);
+
+                vertices.push_back(radius * std::sin(theta) * std::cos(phi));
+                vertices.push_back(radius * std::cos(theta));
+                vertices.push_back(radius * std::sin(theta) * std::sin(phi) - 3.0);
+            }
+        }
+
+        for (int ring = 0; ring < rings; ++ring) {
+            for (int segment = 0; segment < segments; ++segment) {
+                std::uint32_t a = ring * (segments + 1) + segment;
+                std::uint32_t b = a + segments + 1;
+                indices.insert(indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+            }
+        }
+    }
+
+} // namespace
+
+// Construção da BVH, importação do OBJ e carregamento da malha binária mapeada, e a vazão de
+// interseções de raios aleatórios apontados para a malha
+RT_BENCHMARK(triangle_mesh) {
+    auto directory = std::filesystem::temp_directory_path();
+    auto obj_filename = (directory / "ray_tracing_bench_mesh.obj").string();
+    auto binary_filename = (directory / "ray_tracing_bench_mesh.rtmesh").string();
+
+    for (int rings : {64, 512}) {
+        std::vector<double> vertices;
+        std::vector<std::uint32_t> indices;
+        wavy_sphere(rings, 2 * rings, vertices, indices);
+
+        {
+            std::ofstream obj(obj_filename);
+            for (std::size_t k = 0; k < vertices.size(); k += 3)
+                obj << "v " << vertices[k] << ' ' << vertices[k + 1] << ' ' << vertices[k + 2] << '\n';
+            for (std::size_t k = 0; k < indices.size(); k += 3)
+                obj << "f " << indices[k] + 1 << ' ' << indices[k + 1] + 1 << ' ' << indices[k + 2] + 1 << '\n';
+        }
+
+        TriangleMesh mesh;
+        double build_seconds = Bench::elapsed_seconds([&]() { mesh = TriangleMesh{vertices, indices, 0}; });
+
+        std::string error;
+        TriangleMesh imported;
+        double obj_seconds = Bench::elapsed_seconds([&]() { imported.load_obj(obj_filename.c_str(), 0, error); });
+
+        mesh.save_binary(binary_filename.c_str());
+
+        TriangleMesh mapped;
+        double binary_seconds = Bench::elapsed_seconds([&]() { mapped.load_binary(binary_filename.c_str(), 0, error); });
+
+        constexpr int RAY_COUNT = 1 << 19;
+        Pcg32 generator{5};
+        std::vector<Ray> rays;
+        rays.reserve(RAY_COUNT);
+        for (int k = 0; k < RAY_COUNT; ++k)
+            rays.emplace_back(Point3{0, 0, 0}, Vec3{0.8 * generator.next_double() - 0.4, 0.8 * generator.next_double() - 0.4, -1});
+
+        std::size_t hits = 0;
+        double hit_seconds = Bench::elapsed_seconds([&]() {
+            HitRecord record;
+            for (const auto &ray : rays)
+                hits += mapped.hit(ray, Interval(0.001, Utility::INFTY), record);
+        });
+
+        Bench::keep(double(hits + imported.triangle_count()));
+        Bench::report("triangle_mesh/" + std::to_string(mesh.triangle_count()), {
+            {"build_ms", 1e3 * build_seconds},
+            {"obj_ms", 1e3 * obj_seconds},
+            {"binary_ms", 1e3 * binary_seconds},
+            {"mrays_per_s", 1e-6 * RAY_COUNT / hit_seconds},
+        });
+    }
+
+    std::filesystem::remove(obj_filename);
+    std::filesystem::remove(binary_filename);
+}
+
+// Floresta de cópias da mesma malha: memória de cada instância contra a de uma cópia dos vértices,
+// índices e nós, e a vazão da BVH do mundo sobre as instâncias
+RT_BENCHMARK(mesh_instances) {
+    std::vector<double> vertices;
+    std::vector<std::uint32_t> indices;
+    wavy_sphere(64, 128, vertices, indices);
+
+    auto mesh = std::make_shared<TriangleMesh>(vertices, indices, 0);
+    double copy_bytes = double(mesh->vertex_count() * 3 * sizeof(double) + mesh->triangle_count() * 3 * sizeof(std::uint32_t)
+                               + mesh->node_count() * sizeof(BVHNode));
+
+    for (int side : {10, 40}) {
+        HittableList world;
+        Pcg32 generator{9};
+
+        // As malhas ficam em torno de (0, 0, -3); cada cópia é girada, escalada e levada para a grade
+        for (int k = 0; k < side * side; ++k) {
+            auto transform = Transform::translate(Vec3{2.5 * (k % side - side / 2), -1.0, -2.5 * (k / side) - 2.0})
+                             * Transform::rotate(Vec3{0, 1, 0}, 360 * generator.next_double())
+                             * Transform::scale(Vec3{0.6 + 0.4 * generator.next_double(), 1.0, 0.8})
+                             * Transform::translate(Vec3{0, 0, 3});
+            world.add_to_obj_list(std::make_shared<Instance>(mesh, transform));
+        }
+
+        double build_seconds = Bench::elapsed_seconds([&]() { world.build_acceleration(); });
+
+        constexpr int RAY_COUNT = 1 << 18;
+        std::vector<Ray> rays;
+        rays.reserve(RAY_COUNT);
+        for (int k = 0; k < RAY_COUNT; ++k)
+            rays.emplace_back(Point3{0, 1, 2}, Vec3{2 * generator.next_double() - 1, 0.4 * generator.next_double() - 0.5, -1});
+
+        std::size_t hits = 0;
+        double hit_seconds = Bench::elapsed_seconds([&]() {
+            HitRecord record;
+            for (const auto &ray : rays)
+                hits += world.hit(ray, Interval(0.001, Utility::INFTY), record);
+        });
+
+        Bench::keep(double(hits));
+        Bench::report("mesh_instances/" + std::to_string(side * side), {
+            {"instance_bytes", double(sizeof(Instance))},
+            {"copy_bytes", copy_bytes},
+            {"build_ms", 1e3 * build_seconds},
+            {"mrays_per_s", 1e-6 * RAY_COUNT / hit_seconds},
+        });
+    }
+}
@@ -0,0 +1,91 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/random.hpp"
+#include "../lib/ray_packet.hpp"
+#include "../lib/render.hpp"
+
+namespace {
+
+    // Campo de esferas pequenas diante da câmera, sobre o "chão" da cena padrão
+    HittableList sphere_field(std::size_t count) {
+        Pcg32 generator{99};
+        HittableList world;
+
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3(0.0, -100.5, -1.0), 100.0, 0));
+
+        for (std::size_t k = 0; k < count; ++k) {
+            Vec3 center{8 * generator.next_double() - 4, 2 * generator.next_double() - 0.5, -1 - 6 * generator.next_double()};
+            world.add_to_obj_list(std::make_shared<Sphere>(center, 0.02 + 0.05 * generator.next_double(), 0));
+        }
+
+        world.build_acceleration();
+        return world;
+    }
+
+    // Raios primários da imagem inteira, agrupados em blocos de block_width x block_height pixels
+    std::vector<RayPacket> primary_packets(const Render &render, int width, int height, int block_width, int block_height) {
+        std::vector<RayPacket> packets;
+        Random::begin_path(0, 0, 0);
+
+        for (int block_j = 0; block_j < height; block_j += block_height) {
+            for (int block_i = 0; block_i < width; block_i += block_width) {
+                RayPacket packet;
+
+                for (int j = block_j; j < block_j + block_height && j < height; ++j)
+                    for (int i = block_i; i < block_i + block_width && i < width; ++i)
+                        packet.add(render.get_ray(i, j));
+
+                packets.push_back(packet);
+            }
+        }
+
+        return packets;
+    }
+
+} // namespace
+
+// Visibilidade primária (apenas o primeiro hit de cada raio de câmera) de uma imagem 854x480,
+// traçando cada raio separadamente e em pacotes de 4, 8 e 16 raios
+RT_BENCHMARK(primary_visibility_packets) {
+    constexpr int WIDTH = 854;
+    constexpr int HEIGHT = 480;
+
+    Render render{WIDTH};
+
+    for (std::size_t count : {100, 10000}) {
+        auto world = sphere_field(count);
+        std::string prefix = "primary_visibility_packets/" + std::to_string(count) + "/";
+
+        for (int packet_size : {1, 4, 8, 16}) {
+            int block_width = packet_size >= 8 ? 4 : (packet_size == 4 ? 2 : 1);
+            int block_height = packet_size / block_width;
+            auto packets = primary_packets(render, WIDTH, HEIGHT, block_width, block_height);
+
+            std::size_t hit_count = 0;
+            double seconds = Bench::elapsed_seconds([&]() {
+                HitRecord records[RayPacket::MAX_SIZE];
+                bool hits[RayPacket::MAX_SIZE];
+
+                for (const auto &packet : packets) {
+                    if (packet_size == 1) {
+                        hits[0] = world.hit(packet.ray(0), Interval(0.001, Utility::INFTY), records[0]);
+                    }
+                    else {
+                        world.hit_packet(packet, Interval(0.001, Utility::INFTY), records, hits);
+                    }
+
+                    for (int k = 0; k < packet.size; ++k)
+                        hit_count += hits[k];
+                }
+            });
+
+            Bench::keep(double(hit_count));
+            Bench::report(prefix + (packet_size == 1 ? "single" : "packet" + std::to_string(packet_size)),
+                          {{"mrays_per_s", 1e-6 * WIDTH * HEIGHT / seconds}});
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include <memory>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../lib/material.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/random.hpp"
+#include "../lib/sampler.hpp"
+#include "../lib/utility.hpp"
+
+namespace {
+
+    constexpr std::size_t ITERATIONS = 10000000;
+
+    // Raios partindo da origem em direções aleatórias, parte deles em direção à esfera testada
+    std::vector<Ray> rays_towards_sphere(std::size_t count, Pcg32 &generator) {
+        std::vector<Ray> rays;
+        rays.reserve(count);
+
+        for (std::size_t k = 0; k < count; ++k) {
+            Vec3 direction{generator.next_double() - 0.5, generator.next_double() - 0.5, -1.0};
+            rays.emplace_back(Point3{0, 0, 0}, direction * 2.0);
+        }
+
+        return rays;
+    }
+
+} // namespace
+
+// Custo isolado de uma interseção raio-esfera (Sphere::hit, com o registro completo quando acerta)
+RT_BENCHMARK(sphere_hit) {
+    Pcg32 generator{11};
+    auto rays = rays_towards_sphere(4096, generator);
+
+    Sphere sphere{Vec3{0, 0, -2}, 0.5, 0};
+    std::size_t hits = 0;
+
+    double seconds = Bench::elapsed_seconds([&]() {
+        HitRecord record;
+        for (std::size_t k = 0; k < ITERATIONS; ++k)
+            hits += sphere.hit(rays[k & 4095], Interval(0.001, Utility::INFTY), record);
+    });
+
+    Bench::keep(double(hits));
+    Bench::report("sphere_hit", {
+        {"ns_per_op", 1e9 * seconds / ITERATIONS},
+        {"hit_fraction", double(hits) / ITERATIONS},
+    });
+}
+
+// Custo de desviar um raio em cada material (pela MaterialTable, como no integrador) e de sortear um
+// vetor unitário aleatório, usado pelo material difuso
+RT_BENCHMARK(material_scatter) {
+    MaterialTable materials;
+    auto lambertian = materials.add(Lambertian{Vec3{0.5, 0.5, 0.5}});
+    auto metal = materials.add(Metal{Vec3{0.8, 0.6, 0.2}});
+
+    HitRecord record;
+    record.point = Point3{0, 0, -1.5};
+    record.normal_sur_vector = Vec3{0, 0, 1};
+
+    Ray incoming{Point3{0, 0, 0}, Vec3{0.1, 0.2, -1}};
+    Random::begin_path(0, 0, 0);
+    Sampler sampler;
+
+    auto nanoseconds_per_scatter = [&](std::uint32_t material) {
+        Vec3 sum;
+        double seconds = Bench::elapsed_seconds([&]() {
+            Vec3 attenuation;
+            Ray scattered;
+            for (std::size_t k = 0; k < ITERATIONS; ++k) {
+                materials.scatter(material, incoming, record, sampler, attenuation, scattered);
+                sum += scattered.direction();
+            }
+        });
+
+        Bench::keep(sum.x() + sum.y() + sum.z());
+        return 1e9 * seconds / ITERATIONS;
+    };
+
+    double lambertian_ns = nanoseconds_per_scatter(lambertian);
+    double metal_ns = nanoseconds_per_scatter(metal);
+
+    Vec3 sum;
+    double unit_vec_seconds = Bench::elapsed_seconds([&]() {
+        for (std::size_t k = 0; k < ITERATIONS; ++k)
+            sum += Utility::random_unit_vec();
+    });
+    Bench::keep(sum.x() + sum.y() + sum.z());
+
+    double cosine_seconds = Bench::elapsed_seconds([&]() {
+        for (std::size_t k = 0; k < ITERATIONS; ++k)
+            sum += Sampling::cosine_hemisphere(Sampling::random_point2());
+    });
+    Bench::keep(sum.x() + sum.y() + sum.z());
+
+    Bench::report("material_scatter", {
+        {"lambertian_ns_per_op", lambertian_ns},
+        {"metal_ns_per_op", metal_ns},
+        {"random_unit_vec_ns_per_op", 1e9 * unit_vec_seconds / ITERATIONS},
+        {"cosine_hemisphere_ns_per_op", 1e9 * cosine_seconds / ITERATIONS},
+    });
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/random.hpp"
+#include "../lib/render.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    // Acessos à última cache e faltas nela, contados pelo processador (perf_event_open, no Linux) para esta
+    // thread e as que ela criar depois de start(). Em máquinas virtuais e com perf_event_paranoid alto os
+    // contadores não existem e available() é falso.
+    class CacheCounters {
+        public:
+            CacheCounters() {
+#ifdef __linux__
+                m_references = open_counter(PERF_COUNT_HW_CACHE_REFERENCES);
+                m_misses = open_counter(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+            }
+
+            ~CacheCounters() {
+#ifdef __linux__
+                if (m_references >= 0) close(m_references);
+                if (m_misses >= 0) close(m_misses);
+#endif
+            }
+
+            bool available() const { return m_references >= 0 && m_misses >= 0; }
+
+            void start() {
+#ifdef __linux__
+                for (int fd : {m_references, m_misses}) {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+#endif
+            }
+
+            // Fração dos acessos que encontraram o dado na cache desde start() (as threads criadas depois
+            // de start() só entram na conta quando terminam)
+            double hit_rate() const {
+                std::uint64_t references = read_counter(m_references), misses = read_counter(m_misses);
+                return references > 0 ? 1.0 - double(misses) / double(references) : 0.0;
+            }
+
+        private:
+#ifdef __linux__
+            static int open_counter(std::uint64_t config) {
+                perf_event_attr attributes;
+                std::memset(&attributes, 0, sizeof(attributes));
+                attributes.size = sizeof(attributes);
+                attributes.type = PERF_TYPE_HARDWARE;
+                attributes.config = config;
+                attributes.disabled = 1;
+                attributes.inherit = 1;
+                attributes.exclude_kernel = 1;
+                attributes.exclude_hv = 1;
+
+                return int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+            }
+#endif
+
+            static std::uint64_t read_counter(int fd) {
+                std::uint64_t value = 0;
+#ifdef __linux__
+                if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value))
+                    return 0;
+#endif
+                return value;
+            }
+
+            int m_references{-1};
+            int m_misses{-1};
+    };
+
+    // Um milhão de esferas pequenas, difusas e metálicas, sobre um chão, à frente da câmera padrão. As
+    // esferas e os nós da BVH ocupam mais de 100 MB, bem mais que a L2: cada raio secundário desce a BVH
+    // por um caminho próprio e, sem ordenação, quase todos os nós que ele lê já saíram da cache.
+    HittableList sphere_cloud_scene() {
+        HittableList world;
+
+        auto ground = world.materials.add(Lambertian{Vec3{0.5, 0.5, 0.5}});
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3(0.0, -1000.5, -1.0), 1000.0, ground));
+
+        std::uint32_t materials[4] = {
+            world.materials.add(Lambertian{Vec3{0.8, 0.3, 0.3}}),
+            world.materials.add(Lambertian{Vec3{0.3, 0.8, 0.3}}),
+            world.materials.add(Lambertian{Vec3{0.3, 0.3, 0.8}}),
+            world.materials.add(Metal{Vec3{0.8, 0.8, 0.8}}),
+        };
+
+        Pcg32 generator{12};
+        for (int k = 0; k < 1000000; ++k) {
+            Vec3 center{-3.0 + 6.0 * generator.next_double(), -0.5 + 2.0 * generator.next_double(), -6.0 + 5.0 * generator.next_double()};
+            world.add_to_obj_list(std::make_shared<Sphere>(center, 0.012, materials[k % 4]));
+        }
+
+        world.build_acceleration();
+        return world;
+    }
+
+} // namespace
+
+// Vazão do integrador wavefront com e sem a ordenação dos raios secundários pela chave de Morton, em uma
+// cena que cabe na cache (a padrão) e em outra muito maior que a L2, com uma thread (o menor tempo de 3
+// renderizações, já que a diferença esperada é pequena). Quando o processador expõe os contadores, também
+// a taxa de acertos na última cache.
+RT_BENCHMARK(ray_sorting) {
+    constexpr int WIDTH = 160;
+    constexpr int SAMPLES = 8;
+    constexpr int REPETITIONS = 3;
+
+    struct Case {
+        const char *name;
+        HittableList world;
+    };
+
+    Case cases[] = {
+        {"default", Render::default_scene()},
+        {"sphere_cloud_1m", sphere_cloud_scene()},
+    };
+
+    for (const auto &scene : cases) {
+        for (bool sort_rays : {false, true}) {
+            CacheCounters counters;
+            double seconds;
+            RenderStats::Totals totals;
+
+            {
+                // O contador é ligado antes de o Render criar as threads, que terminam no fim do bloco
+                counters.start();
+
+                Render render{WIDTH};
+                render.set_samples_per_pixel(SAMPLES);
+                render.set_thread_count(1);
+                render.set_integrator(Integrator::WAVEFRONT);
+                render.set_ray_sorting(sort_rays);
+                render.set_quiet(true);
+
+                seconds = Utility::INFTY;
+                for (int repetition = 0; repetition < REPETITIONS; ++repetition) {
+                    Framebuffer image;
+                    seconds = std::min(seconds, Bench::elapsed_seconds([&]() { render.render(scene.world, image); }));
+                    Bench::keep(image.pixel(WIDTH / 2, 0).x());
+                }
+
+                // Os contadores acumulam as repetições
+                totals = render.stats().totals();
+            }
+
+            auto rays = double(totals.primary_rays + totals.secondary_rays + totals.shadow_rays) / REPETITIONS;
+            auto name = std::string("ray_sorting/") + scene.name + (sort_rays ? "/morton" : "/unsorted");
+
+            if (counters.available()) {
+                Bench::report(name, {
+                    {"render_ms", 1e3 * seconds},
+                    {"mrays_per_s", 1e-6 * rays / seconds},
+                    {"cache_hit_rate", counters.hit_rate()},
+                });
+            }
+            else {
+                Bench::report(name, {
+                    {"render_ms", 1e3 * seconds},
+                    {"mrays_per_s", 1e-6 * rays / seconds},
+                });
+            }
+        }
+    }
+}
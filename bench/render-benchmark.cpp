@@ -0,0 +1,51 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../lib/framebuffer.hpp"
+#include "../lib/render.hpp"
+
+// Renderização completa da cena padrão (resolução, amostras e semente fixas) com 1, 2, 4, ... threads
+// até o número de threads do processador. mrays_per_s conta os raios de câmera (amostras) por segundo;
+// efficiency é o ganho em relação a uma thread dividido pelo número de threads.
+RT_BENCHMARK(render_scaling) {
+    constexpr int WIDTH = 400;
+    constexpr int SAMPLES = 16;
+
+    auto world = Render::default_scene();
+
+    int max_threads = int(std::thread::hardware_concurrency());
+    if (max_threads < 1)
+        max_threads = 1;
+
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    double single_thread_seconds = 0.0;
+
+    for (int threads : thread_counts) {
+        Render render{WIDTH};
+        render.set_samples_per_pixel(SAMPLES);
+        render.set_seed(1);
+        render.set_thread_count(threads);
+
+        Framebuffer framebuffer;
+        double seconds = Bench::elapsed_seconds([&]() { render.render(world, framebuffer); });
+
+        if (threads == 1)
+            single_thread_seconds = seconds;
+
+        double speedup = single_thread_seconds / seconds;
+        double rays = double(render.image_width()) * render.image_height() * SAMPLES;
+
+        Bench::report("render_scaling/" + std::to_string(threads), {
+            {"seconds", seconds},
+            {"mrays_per_s", 1e-6 * rays / seconds},
+            {"speedup", speedup},
+            {"efficiency", speedup / threads},
+        });
+    }
+}
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/material.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/random.hpp"
+#include "../lib/render.hpp"
+
+namespace {
+
+    // Repassa as consultas para a cena e conta quantas foram feitas: cada consulta é um trecho do caminho
+    class CountingHittable : public Hittable {
+        public:
+            explicit CountingHittable(const Hittable &world) : m_world{world} {}
+
+            bool hit(const Ray &r, Interval acceptable_t_interval, HitRecord &h_rec) const override {
+                ++m_queries;
+                return m_world.hit(r, acceptable_t_interval, h_rec);
+            }
+
+            AABB bounding_box() const override { return m_world.bounding_box(); }
+
+            std::size_t queries() const { return m_queries; }
+
+        private:
+            const Hittable &m_world;
+            mutable std::size_t m_queries{0};
+    };
+
+    // Câmera dentro de uma esfera difusa fechada: nenhum caminho escapa para o céu, então sem a roleta
+    // russa todos eles vão até o limite de profundidade
+    HittableList enclosed_scene() {
+        HittableList world;
+
+        auto walls = world.materials.add(Lambertian{Vec3{0.7, 0.7, 0.7}});
+        auto inside = world.materials.add(Lambertian{Vec3{0.5, 0.2, 0.1}});
+
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3(0.0, 0.0, 0.0), 10.0, walls));
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3(0.0, 0.0, -1.2), 0.5, inside));
+        world.build_acceleration();
+
+        return world;
+    }
+
+} // namespace
+
+// Trechos médios por caminho e custo por amostra, com a roleta russa desativada (profundidade mínima
+// igual ao limite de quiques) e a partir de alguns quiques, na cena padrão e em uma cena fechada
+RT_BENCHMARK(russian_roulette) {
+    constexpr int WIDTH = 160;
+    constexpr int HEIGHT = 90;
+    constexpr int SAMPLES = 8;
+
+    struct Scene { const char *name; HittableList world; };
+    Scene scenes[] = {{"default", Render::default_scene()}, {"enclosed", enclosed_scene()}};
+
+    for (auto &scene : scenes) {
+        for (int min_depth : {50, 5, 3}) {
+            Render render{WIDTH};
+            render.set_roulette_min_depth(min_depth);
+
+            CountingHittable world{scene.world};
+            Vec3 sum;
+
+            double seconds = Bench::elapsed_seconds([&]() {
+                for (int j = 0; j < HEIGHT; ++j) {
+                    for (int i = 0; i < WIDTH; ++i) {
+                        for (int sample = 0; sample < SAMPLES; ++sample) {
+                            Random::begin_path(0, std::uint64_t(j) * WIDTH + i, sample);
+                            sum += render.ray_color(render.get_ray(i, j), world, scene.world.materials, scene.world.lights, 50);
+                        }
+                    }
+                }
+            });
+
+            Bench::keep(sum.x() + sum.y() + sum.z());
+
+            double paths = double(WIDTH) * HEIGHT * SAMPLES;
+            Bench::report(std::string("russian_roulette/") + scene.name + "/min_depth_" + std::to_string(min_depth), {
+                {"segments_per_path", world.queries() / paths},
+                {"ns_per_sample", 1e9 * seconds / paths},
+                {"mean_luminance", (sum.x() + sum.y() + sum.z()) / (3 * paths)},
+            });
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/render.hpp"
+#include "../lib/sampler.hpp"
+
+namespace {
+
+    const std::pair<SamplerType, const char *> SAMPLERS[] = {
+        {SamplerType::INDEPENDENT, "independent"},
+        {SamplerType::SOBOL, "sobol"},
+        {SamplerType::BLUE_NOISE, "blue_noise"},
+    };
+
+    // Erro quadrático médio em relação à referência, depois da correção gamma. Com blurred, as duas
+    // imagens passam antes por um filtro 3x3 (1 2 1): sobra o erro de baixa frequência, o que o olho
+    // percebe como manchas; o ruído azul concentra o erro nas frequências altas, que o filtro remove.
+    double display_rmse(const Framebuffer &image, const Framebuffer &reference, bool blurred) {
+        auto value = [&](const Framebuffer &framebuffer, int i, int j, int channel) {
+            if (!blurred)
+                return framebuffer.pixel(i, j)[channel];
+
+            double sum = 0.0, weight_sum = 0.0;
+            for (int dj = -1; dj <= 1; ++dj) {
+                for (int di = -1; di <= 1; ++di) {
+                    int ni = std::clamp(i + di, 0, framebuffer.width() - 1);
+                    int nj = std::clamp(j + dj, 0, framebuffer.height() - 1);
+                    double weight = (di == 0 ? 2.0 : 1.0) * (dj == 0 ? 2.0 : 1.0);
+                    sum += weight * framebuffer.pixel(ni, nj)[channel];
+                    weight_sum += weight;
+                }
+            }
+            return sum / weight_sum;
+        };
+
+        double sum = 0.0;
+        for (int j = 0; j < image.height(); ++j) {
+            for (int i = 0; i < image.width(); ++i) {
+                for (int channel = 0; channel < 3; ++channel) {
+                    double difference = std::sqrt(std::max(value(image, i, j, channel), 0.0))
+                                      - std::sqrt(std::max(value(reference, i, j, channel), 0.0));
+                    sum += difference * difference;
+                }
+            }
+        }
+        return std::sqrt(sum / (3.0 * image.width() * image.height()));
+    }
+
+    Framebuffer render_image(const HittableList &world, int width, int samples, SamplerType sampler, std::uint64_t seed) {
+        Render render{width};
+        render.set_samples_per_pixel(samples);
+        render.set_sampler(sampler);
+        render.set_seed(seed);
+        render.set_quiet(true);
+
+        Framebuffer framebuffer;
+        render.render(world, framebuffer);
+        return framebuffer;
+    }
+
+} // namespace
+
+// Erro da cena padrão em relação a uma referência de 1024 amostras por pixel com cada amostrador e o
+// tempo da renderização (o custo a mais de gerar os números quase aleatórios)
+RT_BENCHMARK(sampler_convergence) {
+    constexpr int WIDTH = 320;
+
+    auto world = Render::default_scene();
+    auto reference = render_image(world, WIDTH, 1024, SamplerType::INDEPENDENT, 99);
+
+    for (const auto &[sampler, name] : SAMPLERS) {
+        for (int samples : {4, 16, 32, 64, 100}) {
+            Framebuffer image;
+            double seconds = Bench::elapsed_seconds([&]() { image = render_image(world, WIDTH, samples, sampler, 3); });
+
+            Bench::report(std::string("sampler/") + name + "/" + std::to_string(samples) + "spp", {
+                {"rmse", display_rmse(image, reference, false)},
+                {"blurred_rmse", display_rmse(image, reference, true)},
+                {"render_ms", 1e3 * seconds},
+            });
+        }
+    }
+}
+
+// Custo de uma dimensão 2D de cada amostrador
+RT_BENCHMARK(sampler_get_2d) {
+    constexpr std::uint32_t SAMPLES = 64;
+    constexpr int PIXELS = 20000;
+
+    for (const auto &[sampler, name] : SAMPLERS) {
+        Sampler generator{sampler, 1, 200, 100, int(SAMPLES)};
+        double sum = 0.0;
+
+        double seconds = Bench::elapsed_seconds([&]() {
+            for (int pixel = 0; pixel < PIXELS; ++pixel) {
+                for (std::uint32_t sample = 0; sample < SAMPLES; ++sample) {
+                    generator.start_pixel_sample(pixel % 200, pixel / 200, sample);
+                    auto point = generator.get_2d();
+                    sum += point.u + point.v;
+                }
+            }
+        });
+        Bench::keep(sum);
+
+        Bench::report(std::string("sampler_get_2d/") + name, {
+            {"ns_per_sample", 1e9 * seconds / (double(PIXELS) * SAMPLES)},
+        });
+    }
+}
@@ -0,0 +1,61 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/random.hpp"
+#include "../lib/scene.hpp"
+
+// Tempo até a cena estar pronta para renderizar (arquivo lido e BVH disponível), partindo do arquivo
+// de texto ou da cena compilada, para cenas com muitas esferas
+RT_BENCHMARK(scene_loading) {
+    auto directory = std::filesystem::temp_directory_path();
+    auto text_filename = (directory / "ray_tracing_bench_scene.txt").string();
+    auto compiled_filename = (directory / "ray_tracing_bench_scene.bin").string();
+
+    for (std::size_t count : {10000, 1000000}) {
+        {
+            Pcg32 generator{11};
+            std::ofstream text(text_filename);
+            text << "material a lambertian 0.5 0.5 0.5\nmaterial b metal 0.8 0.6 0.2\n";
+
+            for (std::size_t k = 0; k < count; ++k)
+                text << "sphere " << 20 * generator.next_double() - 10 << ' ' << 20 * generator.next_double() - 10 << ' '
+                     << 20 * generator.next_double() - 10 << ' ' << 0.01 << (k % 2 ? " a\n" : " b\n");
+        }
+
+        std::string error;
+        std::size_t objects = 0;
+
+        double text_seconds = Bench::elapsed_seconds([&]() {
+            Scene scene;
+            scene.load(text_filename.c_str(), error);
+            auto world = scene.world();
+            objects += world.objects.size();
+        });
+
+        double compile_seconds = Bench::elapsed_seconds([&]() {
+            Scene scene;
+            scene.load(text_filename.c_str(), error);
+            scene.compile(compiled_filename.c_str());
+        });
+
+        double compiled_seconds = Bench::elapsed_seconds([&]() {
+            Scene scene;
+            scene.load(compiled_filename.c_str(), error);
+            auto world = scene.world();
+            objects += scene.sphere_count();
+        });
+
+        Bench::keep(double(objects));
+        Bench::report("scene_loading/" + std::to_string(count), {
+            {"text_ms", 1e3 * text_seconds},
+            {"compile_ms", 1e3 * compile_seconds},
+            {"compiled_ms", 1e3 * compiled_seconds},
+        });
+    }
+
+    std::filesystem::remove(text_filename);
+    std::filesystem::remove(compiled_filename);
+}
@@ -0,0 +1,71 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/sphere_soa.hpp"
+#include "../lib/random.hpp"
+
+namespace {
+
+    const char *kernel_name(SphereSoA::Kernel kernel) {
+        switch (kernel) {
+            case SphereSoA::Kernel::AVX2: return "avx2";
+            case SphereSoA::Kernel::SSE2: return "sse2";
+            default: return "scalar";
+        }
+    }
+
+    // Intersecções raio-esfera por segundo (em milhões) testando todos os raios contra o mundo inteiro
+    template <typename World>
+    double million_intersections_per_second(const World &world, const std::vector<Ray> &rays, std::size_t sphere_count) {
+        std::size_t hits = 0;
+
+        double seconds = Bench::elapsed_seconds([&]() {
+            HitRecord record;
+            for (const auto &ray : rays)
+                hits += world.hit(ray, Interval(0.001, Utility::INFTY), record);
+        });
+
+        Bench::keep(double(hits));
+        return 1e-6 * double(rays.size()) * double(sphere_count) / seconds;
+    }
+
+} // namespace
+
+// Compara o laço atual (uma chamada virtual a Sphere::hit por esfera) com os kernels do SphereSoA
+RT_BENCHMARK(sphere_soa_intersections) {
+    constexpr std::size_t TESTS_PER_MEASUREMENT = 20000000;
+
+    Pcg32 generator{7};
+
+    for (std::size_t count : {4, 16, 64, 256, 1024}) {
+        HittableList list;
+        SphereSoA spheres;
+
+        for (std::size_t k = 0; k < count; ++k) {
+            Vec3 center{4 * generator.next_double() - 2, 4 * generator.next_double() - 2, -3 - 4 * generator.next_double()};
+            double radius = 0.05 + 0.2 * generator.next_double();
+
+            list.add_to_obj_list(std::make_shared<Sphere>(center, radius, 0));
+            spheres.add(center, radius, 0);
+        }
+
+        std::vector<Ray> rays;
+        for (std::size_t k = 0; k < TESTS_PER_MEASUREMENT / count; ++k)
+            rays.emplace_back(Point3{}, Vec3{generator.next_double() - 0.5, generator.next_double() - 0.5, -1});
+
+        Bench::report("sphere_soa_intersections/" + std::to_string(count) + "/virtual",
+                      {{"mintersections_per_s", million_intersections_per_second(list, rays, count)}});
+
+        for (auto kernel : {SphereSoA::Kernel::SCALAR, SphereSoA::Kernel::SSE2, SphereSoA::Kernel::AVX2}) {
+            if (!SphereSoA::kernel_supported(kernel))
+                continue;
+
+            spheres.set_kernel(kernel);
+            Bench::report("sphere_soa_intersections/" + std::to_string(count) + "/" + kernel_name(kernel),
+                          {{"mintersections_per_s", million_intersections_per_second(spheres, rays, count)}});
+        }
+    }
+}
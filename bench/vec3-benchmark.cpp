@@ -0,0 +1,67 @@
+#include <vector>
+
+#include "benchmark.hpp"
+#include "../lib/random.hpp"
+#include "../lib/render.hpp"
+#include "../lib/vector3d.hpp"
+
+namespace {
+
+    // Mesmas operações do laço interno de ray_color/scatter (soma, produto por escalar, produto
+    // escalar, normalização e produto componente a componente), sem interseção nem chamadas virtuais
+    double vec3_inner_loop(std::size_t iterations) {
+        Pcg32 generator{7};
+        std::vector<Vec3> normals;
+        for (int k = 0; k < 1024; ++k)
+            normals.push_back(Vec3{generator.next_double() - 0.5, generator.next_double() - 0.5, 1.0}.unit());
+
+        Vec3 direction{0.3, -0.2, -1.0};
+        Vec3 attenuation{1.0, 1.0, 1.0};
+        Vec3 albedo{0.8, 0.6, 0.2};
+
+        for (std::size_t k = 0; k < iterations; ++k) {
+            const Vec3 &normal = normals[k & 1023];
+            Vec3 reflected = direction - 2 * (direction * normal) * normal;
+            direction = (reflected + 0.1 * (normal % reflected)).unit();
+            attenuation = Vec3{attenuation.x() * albedo.x(), attenuation.y() * albedo.y(), attenuation.z() * albedo.z()};
+            if (attenuation.near_zero())
+                attenuation = Vec3{1.0, 1.0, 1.0};
+        }
+
+        return direction.x() + attenuation.y();
+    }
+
+} // namespace
+
+// Custo das operações de Vec3 isoladas e de um raio completo (ray_color com todos os rebotes) na
+// cena padrão
+RT_BENCHMARK(vec3_ray_color) {
+    constexpr std::size_t ITERATIONS = 20000000;
+
+    double seconds = Bench::elapsed_seconds([&]() { Bench::keep(vec3_inner_loop(ITERATIONS)); });
+
+    Render render{854};
+    auto world = Render::default_scene();
+
+    constexpr int WIDTH = 854;
+    constexpr int HEIGHT = 480;
+    constexpr int SAMPLES = 4;
+
+    double ray_seconds = Bench::elapsed_seconds([&]() {
+        Vec3 sum;
+        for (int j = 0; j < HEIGHT; ++j) {
+            for (int i = 0; i < WIDTH; ++i) {
+                for (int sample = 0; sample < SAMPLES; ++sample) {
+                    Random::begin_path(0, std::uint64_t(j) * WIDTH + i, sample);
+                    sum += render.ray_color(render.get_ray(i, j), world, 50);
+                }
+            }
+        }
+        Bench::keep(sum.x() + sum.y() + sum.z());
+    });
+
+    Bench::report("vec3_ray_color", {
+        {"inner_loop_ns_per_iteration", 1e9 * seconds / ITERATIONS},
+        {"ray_color_ns_per_sample", 1e9 * ray_seconds / (double(WIDTH) * HEIGHT * SAMPLES)},
+    });
+}
@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <string>
+
+#include "benchmark.hpp"
+#include "../lib/render.hpp"
+
+namespace {
+
+    // Sala fechada iluminada apenas por uma lâmpada pequena (a mesma de scenes/lamp.txt)
+    HittableList lamp_scene() {
+        HittableList world;
+
+        auto wall = world.materials.add(Lambertian{Vec3{0.7, 0.7, 0.7}});
+        auto floor = world.materials.add(Lambertian{Vec3{0.8, 0.5, 0.3}});
+        auto blue = world.materials.add(Lambertian{Vec3{0.1, 0.2, 0.5}});
+        auto mirror = world.materials.add(Metal{Vec3{0.8, 0.8, 0.8}});
+        auto lamp = world.materials.add(Emissive{Vec3{80, 72, 60}});
+
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0,     0.0,  0.0),    4.0, wall));
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0, -1000.5,  0.0), 1000.0, floor));
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0,     0.0, -1.2),    0.5, blue));
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 1.1,     0.0, -1.5),    0.5, mirror));
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3(-0.6,     1.2, -0.8),    0.1, lamp));
+
+        world.build_acceleration();
+        world.lights.add_emissive(world.objects, world.materials);
+        return world;
+    }
+
+    // Chão com uma grade de 40 x 40 esferas pequenas que alternam entre 8 materiais difusos e metálicos:
+    // os pontos tocados por caminhos vizinhos raramente são do mesmo material
+    HittableList sphere_grid_scene() {
+        HittableList world;
+
+        auto ground = world.materials.add(Lambertian{Vec3{0.5, 0.5, 0.5}});
+        world.add_to_obj_list(std::make_shared<Sphere>(Vec3(0.0, -1000.5, -1.0), 1000.0, ground));
+
+        std::uint32_t materials[8];
+        for (int m = 0; m < 8; ++m) {
+            Vec3 color{0.2 + 0.1 * m, 0.9 - 0.1 * m, 0.5};
+            materials[m] = m % 2 == 0 ? world.materials.add(Lambertian{color}) : world.materials.add(Metal{color});
+        }
+
+        for (int z = 0; z < 40; ++z)
+          for (int x = 0; x < 40; ++x)
+            world.add_to_obj_list(std::make_shared<Sphere>(Vec3(-4.0 + 0.2 * x, -0.42, -1.0 - 0.2 * z), 0.08, materials[(x + 3 * z) % 8]));
+
+        world.build_acceleration();
+        return world;
+    }
+
+} // namespace
+
+// Tempo de renderização e vazão do MEGAKERNEL e do WAVEFRONT, que geram a mesma imagem, com uma thread (o
+// custo de cada um, sem disputa pela memória) e com todas as threads
+RT_BENCHMARK(wavefront_integrator) {
+    constexpr int WIDTH = 320;
+    constexpr int SAMPLES = 16;
+
+    struct Case {
+        const char *name;
+        HittableList world;
+    };
+
+    Case cases[] = {
+        {"default", Render::default_scene()},
+        {"lamp", lamp_scene()},
+        {"sphere_grid", sphere_grid_scene()},
+    };
+
+    for (const auto &scene : cases) {
+        for (int threads : {1, 0}) {
+            for (auto integrator : {Integrator::MEGAKERNEL, Integrator::WAVEFRONT}) {
+                Render render{WIDTH};
+                render.set_samples_per_pixel(SAMPLES);
+                render.set_thread_count(threads);
+                render.set_integrator(integrator);
+                render.set_quiet(true);
+
+                Framebuffer image;
+                double seconds = Bench::elapsed_seconds([&]() { render.render(scene.world, image); });
+                Bench::keep(image.pixel(WIDTH / 2, 0).x());
+
+                auto totals = render.stats().totals();
+                auto rays = double(totals.primary_rays + totals.secondary_rays + totals.shadow_rays);
+
+                Bench::report(std::string("wavefront_integrator/") + scene.name + "/"
+                                  + (integrator == Integrator::WAVEFRONT ? "wavefront" : "megakernel")
+                                  + (threads == 1 ? "/1thread" : "/all_threads"), {
+                    {"render_ms", 1e3 * seconds},
+                    {"mrays_per_s", 1e-6 * rays / seconds},
+                });
+            }
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef _AABB_HPP_
+#define _AABB_HPP_
+
+#include <algorithm>
+
+#include "vector3d.hpp"
+#include "ray.hpp"
+#include "utility.hpp"
+
+// Caixa delimitadora alinhada aos eixos (axis-aligned bounding box). É o menor paralelepípedo, com
+// faces paralelas aos planos xy, yz e xz, que contém um objeto inteiro. Testar um raio contra a caixa
+// é muito mais barato do que contra o objeto, e se o raio não toca a caixa também não toca o objeto.
+class AABB {
+    public:
+        // Por padrão a caixa é "vazia" (min > max), de modo que expand() com qualquer outra caixa
+        // resulta na outra caixa
+        AABB() : m_min{+Utility::INFTY, +Utility::INFTY, +Utility::INFTY},
+                 m_max{-Utility::INFTY, -Utility::INFTY, -Utility::INFTY} {}
+
+        AABB(const Point3 &min, const Point3 &max) : m_min{min}, m_max{max} {}
+
+        const Point3 &min() const { return m_min; }
+        const Point3 &max() const { return m_max; }
+
+        bool is_empty() const { return m_min.x() > m_max.x() || m_min.y() > m_max.y() || m_min.z() > m_max.z(); }
+
+        // Aumenta a caixa para conter também box/point
+        void expand(const AABB &box) {
+            m_min = Point3{std::min(m_min.x(), box.m_min.x()), std::min(m_min.y(), box.m_min.y()), std::min(m_min.z(), box.m_min.z())};
+            m_max = Point3{std::max(m_max.x(), box.m_max.x()), std::max(m_max.y(), box.m_max.y()), std::max(m_max.z(), box.m_max.z())};
+        }
+
+        void expand(const Point3 &point) { expand(AABB{point, point}); }
+
+        Point3 centroid() const { return 0.5 * (m_min + m_max); }
+
+        // Eixo (0, 1 ou 2) em que a caixa é mais comprida
+        int longest_axis() const {
+            auto extent = m_max - m_min;
+
+            if (extent.x() > extent.y() && extent.x() > extent.z())
+                return 0;
+
+            return extent.y() > extent.z() ? 1 : 2;
+        }
+
+        // Área da superfície da caixa. A probabilidade de um raio aleatório que toca uma caixa "pai"
+        // também tocar uma caixa "filha" é proporcional à razão entre as áreas (base da heurística SAH)
+        double surface_area() const {
+            if (is_empty())
+                return 0.0;
+
+            auto extent = m_max - m_min;
+            return 2.0 * (extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x());
+        }
+
+        // Teste "slab": o raio atravessa cada par de planos paralelos em um intervalo de t; o raio toca
+        // a caixa se, e somente se, os três intervalos e (t_min, t_max) tiverem interseção não vazia.
+        // NOTE: inverse_direction = (1/dx, 1/dy, 1/dz) é calculado uma única vez por raio, fora do
+        // laço de travessia, trocando três divisões por nó por três multiplicações.
+        bool hit(const Point3 &origin, const Vec3 &inverse_direction, double t_min, double t_max) const {
+            for (int axis = 0; axis < 3; ++axis) {
+                double t0 = (m_min[axis] - origin[axis]) * inverse_direction[axis];
+                double t1 = (m_max[axis] - origin[axis]) * inverse_direction[axis];
+
+                if (inverse_direction[axis] < 0.0)
+                    std::swap(t0, t1);
+
+                t_min = t0 > t_min ? t0 : t_min;
+                t_max = t1 < t_max ? t1 : t_max;
+
+                if (t_max < t_min)
+                    return false;
+            }
+
+            return true;
+        }
+
+    private:
+        Point3 m_min;
+        Point3 m_max;
+};
+
+#endif // _AABB_HPP_
@@ -0,0 +1,105 @@
+#ifndef _ANIMATION_HPP_
+#define _ANIMATION_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "denoiser.hpp"
+#include "framebuffer.hpp"
+#include "objects.hpp"
+#include "render.hpp"
+#include "sample_buffer.hpp"
+#include "vector3d.hpp"
+
+struct CameraKeyframe {
+    double frame;
+    CameraSettings camera;
+};
+
+struct SphereKeyframe {
+    double frame;
+    Point3 center;
+};
+
+// Animação por quadros-chave: a câmera e os centros das esferas são definidos em alguns quadros e
+// interpolados nos demais por uma spline de Catmull-Rom, que passa por todos os quadros-chave sem
+// mudanças bruscas de velocidade (uma volta ao redor da cena com 8 quadros-chave já parece um círculo).
+// Antes do primeiro e depois do último quadro-chave, os valores ficam parados.
+class Animation {
+    public:
+        // Um quadro-chave em um quadro que já tem outro o substitui
+        void add_camera_key(double frame, const CameraSettings &camera);
+        void add_sphere_key(std::uint32_t sphere, double frame, const Point3 &center);
+
+        bool empty() const { return m_camera_keys.empty() && m_sphere_keys.empty(); }
+        bool has_camera() const { return !m_camera_keys.empty(); }
+
+        CameraSettings camera_at(double frame) const;
+        Point3 sphere_center_at(std::uint32_t sphere, double frame) const;
+
+        // Move as esferas animadas de world (world.objects[k] é a esfera k da cena) para as posições do
+        // quadro e ajusta a estrutura de aceleração, sem reconstruí-la. Retorna false se alguma esfera
+        // animada não existir em world.
+        bool apply(double frame, HittableList &world) const;
+
+    private:
+        std::vector<CameraKeyframe> m_camera_keys; // em ordem de quadro
+        std::map<std::uint32_t, std::vector<SphereKeyframe>> m_sphere_keys;
+};
+
+// Escreve os quadros em uma thread própria: enquanto o quadro N é convertido e gravado, o quadro N + 1
+// já está sendo renderizado. Há no máximo um quadro esperando, então a memória não cresce com o
+// tamanho da animação. Com um denoiser, cada quadro é filtrado (na thread de escrita) antes da gravação.
+class FrameWriter {
+    public:
+        explicit FrameWriter(const Denoiser *denoiser = nullptr);
+        ~FrameWriter() { finish(); }
+
+        FrameWriter(const FrameWriter &) = delete;
+        FrameWriter &operator=(const FrameWriter &) = delete;
+
+        // Entrega as amostras de um quadro para serem gravadas em filename. Em troca, samples recebe o
+        // buffer do quadro anterior (já gravado), que pode ser reaproveitado. Espera enquanto o quadro
+        // anterior ainda estiver sendo gravado.
+        void submit(SampleBuffer &samples, std::string filename, ImageFormat format);
+
+        // Espera a gravação do último quadro e encerra a thread. Retorna false se alguma escrita falhou.
+        bool finish();
+
+    private:
+        void run();
+
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+
+        // Quadro aguardando (ou em) gravação
+        SampleBuffer m_samples;
+        std::string m_filename;
+        ImageFormat m_format{ImageFormat::PPM_BINARY};
+        bool m_has_frame{false};
+
+        bool m_stop{false};
+        bool m_failed{false};
+
+        const Denoiser *m_denoiser;
+        Framebuffer m_framebuffer;
+        std::thread m_thread;
+};
+
+// Nome do arquivo de um quadro: a última sequência de '#' em pattern é trocada pelo número do quadro,
+// com zeros à esquerda ("quadro_####.ppm" => "quadro_0012.ppm"). Sem nenhum '#', o número (com 4
+// dígitos) é inserido antes da extensão.
+std::string frame_filename(const std::string &pattern, int frame);
+
+// Renderiza os quadros first_frame até last_frame (inclusive) com o mesmo Render (e portanto as mesmas
+// threads) e o mesmo mundo, que é apenas ajustado a cada quadro. A semente de cada quadro combina a
+// semente de render com o número do quadro, para que o ruído não fique parado sobre a imagem.
+bool render_animation(Render &render, HittableList &world, const Animation &animation, int first_frame, int last_frame,
+                      const std::string &filename_pattern, ImageFormat format);
+
+#endif // _ANIMATION_HPP_
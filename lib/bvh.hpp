@@ -0,0 +1,91 @@
+#ifndef _BVH_HPP_
+#define _BVH_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "aabb.hpp"
+#include "objects.hpp"
+#include "sphere_soa.hpp"
+
+// Nó da BVH "achatada": em vez de uma árvore de ponteiros, todos os nós ficam em um único vetor em
+// ordem de busca em profundidade. O filho esquerdo de um nó interno é sempre o nó seguinte no vetor,
+// então só é preciso guardar o índice do filho direito. Cada nó ocupa exatamente uma linha de cache.
+struct alignas(64) BVHNode {
+    AABB bounds;
+
+    // Nó interno: índice do filho direito. Folha: índice da primeira primitiva da folha.
+    std::uint32_t offset;
+
+    // Quantidade de primitivas na folha (0 para nós internos)
+    std::uint16_t primitive_count;
+
+    // Eixo em que os filhos foram separados, usado para visitar primeiro o filho mais próximo do raio
+    std::uint8_t split_axis;
+
+    bool is_leaf() const { return primitive_count > 0; }
+};
+
+// Tamanho da pilha de nós das travessias: a travessia empilha no máximo um nó por ancestral interno, então
+// nenhum nó interno pode estar a BVH_STACK_SIZE níveis ou mais da raiz
+constexpr std::size_t BVH_STACK_SIZE = 128;
+
+// Confere os nós de uma BVH lida de um arquivo, para que um arquivo corrompido não faça a travessia ler
+// fora dos vetores nem estourar a pilha: os dois filhos de cada nó interno existem e vêm depois dele, as
+// folhas referenciam apenas primitivas existentes e a altura da árvore cabe em BVH_STACK_SIZE.
+bool valid_bvh_nodes(const BVHNode *nodes, std::size_t node_count, std::uint64_t primitive_count);
+
+// Constrói a BVH sobre primitivas descritas apenas pelas suas caixas, de modo que a mesma construção
+// sirva para qualquer tipo de primitiva. A divisão de cada nó é escolhida pela heurística de área de
+// superfície (SAH) com "bins", e as subárvores grandes dos primeiros níveis são construídas em paralelo.
+//
+// Retorna os nós achatados; primitive_order[k] indica qual primitiva original ocupa a posição k, que
+// é a posição referenciada pelas folhas.
+std::vector<BVHNode> build_bvh(const std::vector<AABB> &primitive_bounds, std::vector<std::uint32_t> &primitive_order);
+
+// Hierarquia de volumes delimitadores sobre uma lista de objetos. Cada nó guarda a caixa que envolve
+// todos os objetos abaixo dele; se o raio não toca a caixa, nenhum desses objetos precisa ser testado.
+// O custo por raio passa a crescer com O(log N) em vez de O(N).
+//
+// Se todos os objetos forem esferas, elas são copiadas (na ordem das folhas) para um SphereSoA e cada
+// folha é testada com o kernel SIMD em vez de uma chamada virtual por esfera.
+class BVH : public Hittable {
+    public:
+        explicit BVH(const std::vector<std::shared_ptr<Hittable>> &objects);
+
+        // BVH já construída sobre esferas (nós de build_bvh e esferas na ordem das folhas), usada ao
+        // carregar uma cena compilada sem refazer a construção
+        BVH(std::vector<BVHNode> nodes, SphereSoA spheres) : m_nodes{std::move(nodes)}, m_spheres{std::move(spheres)} {}
+
+        bool hit(const Ray &r, Interval acceptable_t_interval, HitRecord &h_rec) const override;
+
+        // Travessia em pacote: todos os raios descem juntos pela árvore e um nó só é descartado quando
+        // nenhum raio do pacote toca a sua caixa. Para raios coerentes as decisões são praticamente as
+        // mesmas, então os nós são lidos uma única vez para o pacote inteiro.
+        void hit_packet(const RayPacket &packet, Interval acceptable_t_interval, HitRecord *h_recs, bool *hits) const override;
+
+        AABB bounding_box() const override { return m_nodes.empty() ? AABB{} : m_nodes.front().bounds; }
+
+        // Atualiza a árvore depois que os objetos (os mesmos passados ao construtor, na mesma ordem)
+        // se moveram: as posições das esferas são copiadas de novo e as caixas são recalculadas de
+        // baixo para cima, sem refazer a divisão dos nós. É muito mais barato que reconstruir, mas a
+        // qualidade da árvore cai se os objetos se afastarem muito das posições originais. Retorna
+        // false se a BVH não foi construída a partir de objects (por exemplo, a de uma cena compilada).
+        bool refit(const std::vector<std::shared_ptr<Hittable>> &objects);
+
+        std::size_t node_count() const { return m_nodes.size(); }
+
+    private:
+        std::vector<BVHNode> m_nodes;
+
+        // Objetos reordenados de forma que cada folha referencie um trecho contíguo. Fica vazio
+        // quando a cena é formada apenas por esferas, que ficam em m_spheres.
+        std::vector<std::shared_ptr<Hittable>> m_objects;
+        SphereSoA m_spheres;
+
+        // Posição, na lista passada ao construtor, do objeto que ocupa cada posição das folhas
+        std::vector<std::uint32_t> m_primitive_order;
+};
+
+#endif // _BVH_HPP_
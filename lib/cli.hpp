@@ -0,0 +1,94 @@
+#ifndef _CLI_HPP_
+#define _CLI_HPP_
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "framebuffer.hpp"
+#include "sampler.hpp"
+#include "wavefront.hpp"
+
+// Opções aceitas pela linha de comando do programa
+struct CliOptions {
+    const char *output_filename{nullptr};
+
+    // Cena em texto ou compilada; sem ela, a cena padrão é renderizada
+    const char *scene_filename{nullptr};
+
+    // Mapa de ambiente HDR (PFM em latitude-longitude) que ilumina a cena no lugar do céu
+    const char *environment_filename{nullptr};
+
+    // Se definido, a cena (ou a malha de mesh_filename) é apenas compilada para este arquivo
+    const char *compile_filename{nullptr};
+
+    // Malha OBJ a ser convertida para o formato binário com --compile
+    const char *mesh_filename{nullptr};
+
+    // Número de threads de renderização. 0 significa "usar todas as threads de hardware"
+    int thread_count{0};
+
+    // Semente dos números aleatórios: a mesma semente reproduz a mesma imagem
+    std::uint64_t seed{0};
+
+    // Origem dos números de cada amostra: independentes, Sobol ou ruído azul (ver Sampler)
+    SamplerType sampler{SamplerType::INDEPENDENT};
+
+    // Tamanho dos pacotes de raios primários (4, 8 ou 16); 0 traça cada raio separadamente
+    int packet_size{0};
+
+    // Caminhos seguidos um de cada vez (megakernel) ou todos juntos, estágio por estágio (wavefront)
+    Integrator integrator{Integrator::MEGAKERNEL};
+
+    // Ordena os raios secundários pela chave de Morton antes de testá-los (implica o integrador wavefront)
+    bool sort_rays{false};
+
+    // Amostras por pixel (0 mantém o valor da cena); com --adaptive, é o máximo e min_samples_per_pixel o mínimo
+    int samples_per_pixel{0};
+    int min_samples_per_pixel{16};
+
+    // Limite do erro estimado de cada pixel (0 desativa a amostragem adaptativa)
+    double adaptive_error_threshold{0.0};
+
+    // Arquivo opcional com o mapa do número de amostras de cada pixel
+    const char *sample_map_filename{nullptr};
+
+    // Filtra o ruído da imagem final (guiado pelo albedo, normal e profundidade do primeiro ponto tocado)
+    bool denoise{false};
+
+    // Renderização progressiva: checkpoint salvo a cada passada de samples_per_pass amostras por pixel
+    const char *checkpoint_filename{nullptr};
+    int samples_per_pass{16};
+    bool resume{false};
+
+    // Arquivo opcional com o relatório das estatísticas da renderização, em JSON
+    const char *stats_filename{nullptr};
+
+    // Renderização distribuída: worker_count processos locais (--workers), modo worker que recebe os
+    // tiles pela entrada padrão (--worker), apenas os tiles [first_tile, end_tile) gravados em um
+    // resultado parcial (--tiles A-B) ou a junção de resultados parciais (--merge, repetível)
+    int worker_count{0};
+    bool worker{false};
+    int first_tile{-1};
+    int end_tile{-1};
+    std::vector<const char *> merge_filenames;
+
+    // Animação: renderiza os quadros first_frame até last_frame (inclusive), cada um em um arquivo
+    // com o número do quadro no lugar dos '#' de output_filename
+    int first_frame{-1};
+    int last_frame{-1};
+
+    // Quiques antes de a roleta russa poder interromper um caminho
+    int roulette_min_depth{3};
+
+    // Se --format não for dado, o formato é deduzido pela extensão do arquivo de saída
+    bool has_format{false};
+    ImageFormat format{ImageFormat::PPM_BINARY};
+};
+
+// Interpreta argv e preenche options. Retorna false caso algum argumento seja inválido ou esteja faltando.
+bool parse_cli_options(int argc, char *argv[], CliOptions &options);
+
+void print_usage(std::ostream &out, const char *program_name);
+
+#endif // _CLI_HPP_
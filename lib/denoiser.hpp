@@ -0,0 +1,40 @@
+#ifndef _DENOISER_HPP_
+#define _DENOISER_HPP_
+
+#include "framebuffer.hpp"
+#include "sample_buffer.hpp"
+#include "thread_pool.hpp"
+
+// Filtro de ruído aplicado às médias dos pixels antes da escrita (e da quantização) da imagem. É uma
+// transformada "à-trous" com bordas preservadas (Dammertz et al., 2010), guiada pela variância como no
+// SVGF (Schied et al., 2017): ITERATIONS passadas de um núcleo B-spline 5x5 cujos pontos se afastam
+// (passo 1, 2, 4 e 8), cobrindo uma janela de 61 pixels com 25 leituras por pixel em cada passada.
+//
+// O peso de cada vizinho cai quando a normal, a distância até a câmera ou o albedo do primeiro ponto
+// tocado diferem dos do pixel (ver PixelEstimate), ou quando a diferença de luminância é grande perto
+// do desvio padrão estimado para o pixel: bordas de objetos e de sombras ficam nítidas enquanto o
+// ruído dentro de cada superfície é espalhado. O filtro atua sobre a iluminação (cor / albedo), para
+// que a cor dos materiais não seja borrada, e o albedo é multiplicado de volta no final.
+class Denoiser {
+    public:
+        static constexpr int ITERATIONS = 4;
+
+        // Filtra as médias de samples e escreve o resultado em framebuffer (redimensionado para o
+        // tamanho do buffer). Com pool, as linhas da imagem são divididas entre as threads.
+        void apply(const SampleBuffer &samples, Framebuffer &framebuffer, ThreadPool *pool = nullptr) const;
+
+    private:
+        // O peso das normais é max(0, n_p * n_q)^128, calculado com 7 quadrados em vez de pow()
+        static constexpr int NORMAL_POWER_SQUARINGS = 7;
+
+        // Diferença de luminância, em desvios padrão do pixel, em que o peso cai a 1/e
+        static constexpr double LUMINANCE_SIGMA = 4.0;
+
+        // Diferença de profundidade em relação à variação esperada pela inclinação da superfície
+        static constexpr double DEPTH_SIGMA = 1.0;
+
+        // Distância (RGB) entre albedos
+        static constexpr double ALBEDO_SIGMA = 0.1;
+};
+
+#endif // _DENOISER_HPP_
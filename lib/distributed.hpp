@@ -0,0 +1,55 @@
+#ifndef _DISTRIBUTED_HPP_
+#define _DISTRIBUTED_HPP_
+
+#include <string>
+#include <vector>
+
+#include "objects.hpp"
+#include "render.hpp"
+#include "sample_buffer.hpp"
+
+// Renderização de uma imagem dividida entre vários processos. Um coordenador inicia N processos do
+// próprio programa em modo "worker" (cada um monta a mesma cena com as mesmas opções), entrega a cada
+// um os índices dos tiles a renderizar e recebe de volta o estado dos pixels de cada tile.
+//
+// Protocolo, por pipes (os números seguem a ordem de bytes da máquina, os processos rodam na mesma):
+//
+//   coordenador -> worker: índice do tile (uint32)
+//   worker -> coordenador: índice do tile (uint32), número de pixels (uint32) e os registros dos pixels
+//                          do tile, linha a linha (SampleBuffer::pack_region)
+//
+// O worker termina quando a sua entrada é fechada. Como cada amostra depende apenas do pixel e da
+// semente, a imagem final é idêntica à renderizada por um único processo.
+namespace Distributed {
+
+    struct Worker {
+        int to_worker{-1};   // escrita: índices dos tiles
+        int from_worker{-1}; // leitura: resultados
+        int pid{-1};         // -1 quando o "worker" não é um processo (por exemplo, uma thread nos testes)
+    };
+
+    // Laço do worker: lê índices de tiles de input_fd até o fim da entrada, renderiza cada tile e
+    // escreve o resultado em output_fd. Retorna false em erros de leitura/escrita ou índices inválidos.
+    bool run_worker(Render &render, const HittableList &world, int input_fd, int output_fd);
+
+    // Inicia worker_count processos executando program com os argumentos arguments (sem o argv[0]),
+    // com a entrada e a saída padrão ligadas aos pipes do Worker. Retorna false se algum não puder ser iniciado.
+    bool spawn_workers(const std::string &program, const std::vector<std::string> &arguments, int worker_count,
+                       std::vector<Worker> &workers);
+
+    // Distribui os tiles de render entre os workers, mantendo cada um com até PIPELINE_DEPTH tiles
+    // pendentes para que nunca fique esperando o próximo. Se um worker falhar, os seus tiles são
+    // entregues aos outros, mesmo aos que já estavam sem trabalho: as entradas só são fechadas quando
+    // nenhum worker tem tiles pendentes. Retorna false se todos os workers falharem antes do fim.
+    constexpr int PIPELINE_DEPTH = 2;
+    bool distribute_tiles(const Render &render, std::vector<Worker> &workers, SampleBuffer &samples);
+
+    // Fecha os pipes e espera o fim dos processos. Retorna false se algum terminou com erro.
+    bool finish_workers(std::vector<Worker> &workers);
+
+    // Caminho do programa em execução (para iniciar os workers), ou argv0 se não for possível descobrir
+    std::string current_executable(const char *argv0);
+
+} // namespace
+
+#endif // _DISTRIBUTED_HPP_
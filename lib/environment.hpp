@@ -0,0 +1,74 @@
+#ifndef _ENVIRONMENT_HPP_
+#define _ENVIRONMENT_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sampling.hpp"
+#include "vector3d.hpp"
+
+// Mapa de ambiente HDR em projeção equirretangular (latitude-longitude): a luz que chega de cada direção
+// de fora da cena, no lugar do gradiente do céu. A coluna u vai de -π a π em torno do eixo y (o centro da
+// imagem fica na direção -z, para onde a câmera padrão olha) e a linha v, de cima (+y) para baixo (-y).
+//
+// Um sol ocupa poucos pixels do mapa e concentra quase toda a luz: um quique difuso raramente o encontra.
+// Por isso o mapa também é uma luz amostrada diretamente (ver LightList), com uma distribuição 2D
+// tabelada: cada pixel é sorteado com probabilidade proporcional à sua luminância vezes sin(θ) (a área
+// que ele ocupa na esfera). A linha é escolhida pela distribuição marginal das linhas e a coluna pela
+// distribuição da linha, cada uma por busca binária na sua função de distribuição acumulada.
+class EnvironmentMap {
+    public:
+        // Lê um PFM colorido ('PF'), de qualquer ordem de bytes. O arquivo é mapeado em memória e os
+        // pixels são copiados uma única vez, já na ordem de cima para baixo, enquanto as tabelas da
+        // distribuição são montadas (elas passam por todos os pixels de qualquer forma).
+        bool load(const char *filename, std::string &error);
+
+        // Mapa de width x height pixels com as cores (r, g, b) de rgb, linha por linha a partir de cima
+        void assign(int width, int height, std::vector<float> rgb);
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+
+        // Luz que chega da direção (não precisa ser unitária)
+        Vec3 radiance(const Vec3 &direction) const;
+
+        // Sorteia uma direção (unitária) com a distribuição tabelada e retorna a luz que chega dela e a
+        // densidade em ângulo sólido. Retorna false se o mapa for todo preto.
+        bool sample(const Sampling::Point2 &sample, Vec3 &direction, Vec3 &radiance, double &pdf) const;
+
+        // Densidade com que sample() sorteia a direção (unitária)
+        double pdf(const Vec3 &direction) const;
+
+        // Identifica o conteúdo do mapa (entra na chave dos checkpoints)
+        std::uint64_t hash() const { return m_hash; }
+
+    private:
+        // Pixel (x, y) que contém a direção unitária, com as coordenadas (u, v) dela em [0, 1]²
+        void texel(const Vec3 &direction, int &x, int &y, double &sin_theta) const;
+
+        Vec3 texel_radiance(int x, int y) const {
+            const float *rgb = &m_texels[3 * (std::size_t(y) * m_width + x)];
+            return Vec3{rgb[0], rgb[1], rgb[2]};
+        }
+
+        // Monta as tabelas de amostragem e o hash a partir de m_texels
+        void build_distribution();
+
+        int m_width{0};
+        int m_height{0};
+        std::vector<float> m_texels;
+
+        // Peso (luminância vezes sin(θ)) de cada pixel e as funções de distribuição acumulada: da linha y,
+        // em m_conditional_cdf[y * (width + 1)...], e das linhas, em m_marginal_cdf (height + 1 valores)
+        std::vector<double> m_weights;
+        std::vector<double> m_conditional_cdf;
+        std::vector<double> m_marginal_cdf;
+
+        // Média dos pesos sobre o quadrado [0, 1]²; a densidade no quadrado é peso / m_weight_integral
+        double m_weight_integral{0.0};
+
+        std::uint64_t m_hash{0};
+};
+
+#endif // _ENVIRONMENT_HPP_
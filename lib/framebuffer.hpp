@@ -0,0 +1,71 @@
+#ifndef _FRAMEBUFFER_HPP_
+#define _FRAMEBUFFER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "vector3d.hpp"
+
+// Formatos de imagem suportados na escrita do framebuffer
+enum class ImageFormat {
+    PPM_BINARY, // P6: 1 byte por canal, compacto e rápido de escrever
+    PPM_ASCII,  // P3: texto "r g b", apenas para depuração/compatibilidade
+    PFM         // Portable Float Map: cor linear em float, sem correção gamma nem quantização
+};
+
+// Retorna false caso o nome ("p6", "p3" ou "pfm") não corresponda a nenhum formato
+bool parse_image_format(const char *name, ImageFormat &format);
+
+// Escolhe o formato a partir da extensão do arquivo: ".pfm" => PFM, qualquer outra => PPM binário
+ImageFormat image_format_from_filename(const char *filename);
+
+// Imagem em memória com a cor linear (antes da correção gamma) de cada pixel, armazenada como
+// float RGB contíguo, linha por linha, de cima para baixo. Cada thread escreve diretamente nos
+// pixels do seu tile e a imagem só é convertida/escrita no disco uma única vez, no final.
+class Framebuffer {
+    public:
+        Framebuffer(int width = 0, int height = 0) { resize(width, height); }
+
+        void resize(int width, int height);
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+
+        void set_pixel(int i, int j, const Vec3 &color) {
+            float *pixel = &m_pixels[index(i, j)];
+            pixel[0] = float(color.x());
+            pixel[1] = float(color.y());
+            pixel[2] = float(color.z());
+        }
+
+        Vec3 pixel(int i, int j) const {
+            const float *pixel = &m_pixels[index(i, j)];
+            return Vec3{pixel[0], pixel[1], pixel[2]};
+        }
+
+        const float *data() const { return m_pixels.data(); }
+        float *data() { return m_pixels.data(); }
+
+        // Aplica a correção gamma e converte cada canal para um byte em [0, 255], numa única
+        // passada sobre o vetor contíguo de floats (o laço é simples o bastante para ser vetorizado
+        // pelo compilador)
+        void quantize(std::vector<std::uint8_t> &bytes) const;
+
+        void write_ppm_binary(std::ostream &out) const;
+        void write_ppm_ascii(std::ostream &out) const;
+        void write_pfm(std::ostream &out) const;
+
+        // Escreve a imagem no formato indicado. Retorna false se o arquivo não puder ser escrito.
+        bool write(const char *filename, ImageFormat format) const;
+
+    private:
+        std::size_t index(int i, int j) const { return 3 * (std::size_t(j) * m_width + i); }
+
+        int m_width{0};
+        int m_height{0};
+        std::vector<float> m_pixels;
+};
+
+#endif // _FRAMEBUFFER_HPP_
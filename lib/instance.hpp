@@ -0,0 +1,45 @@
+#ifndef _INSTANCE_HPP_
+#define _INSTANCE_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "objects.hpp"
+#include "transform.hpp"
+
+// Cópia posicionada de uma geometria compartilhada: em vez de duplicar os vértices (ou os objetos)
+// para cada cópia, a instância guarda apenas um ponteiro para a geometria e a transformação que a
+// leva do espaço do objeto para o mundo. Mil árvores iguais custam uma malha e mil instâncias.
+//
+// O raio é levado para o espaço do objeto pela transformação inversa, sem normalizar a direção, de
+// modo que o parâmetro t de uma interseção é o mesmo nos dois espaços e o intervalo de t aceitável
+// vale sem nenhuma conversão.
+class Instance : public Hittable {
+    public:
+        // Com esse valor em material, a instância usa o material da própria geometria
+        static constexpr std::uint32_t GEOMETRY_MATERIAL = std::numeric_limits<std::uint32_t>::max();
+
+        // NOTE: object_to_world precisa ser inversível (determinant() != 0)
+        Instance(std::shared_ptr<const Hittable> geometry, const Transform &object_to_world,
+                 std::uint32_t material = GEOMETRY_MATERIAL);
+
+        const Hittable &geometry() const { return *m_geometry; }
+        const Transform &world_to_object() const { return m_world_to_object; }
+
+        bool hit(const Ray &r, Interval acceptable_t_interval, HitRecord &h_rec) const override;
+
+        AABB bounding_box() const override { return m_bounds; }
+
+    private:
+        std::shared_ptr<const Hittable> m_geometry;
+
+        // Só a inversa é guardada: ela leva os raios ao espaço do objeto e, transposta, traz as normais
+        // de volta (ver Transform::apply_transposed); a transformação direta só é usada para a caixa
+        Transform m_world_to_object;
+        AABB m_bounds;
+
+        std::uint32_t m_material;
+};
+
+#endif // _INSTANCE_HPP_
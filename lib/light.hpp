@@ -0,0 +1,100 @@
+#ifndef _LIGHT_HPP_
+#define _LIGHT_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "environment.hpp"
+#include "ray.hpp"
+#include "sampling.hpp"
+#include "vector3d.hpp"
+
+class HitRecord;
+class Hittable;
+class MaterialTable;
+class Sampler;
+class Sphere;
+
+// Direção sorteada em direção a uma luz, vista de um ponto da cena
+struct LightSample {
+    Vec3 direction;  // unitária
+    double distance; // até a superfície da luz, ao longo de direction (infinita para o mapa de ambiente)
+    Vec3 emission;
+    double pdf;      // densidade em ângulo sólido, já incluindo a escolha da luz
+};
+
+// Luzes da cena que podem ser amostradas diretamente: as esferas com material Emissive. Uma lâmpada
+// pequena quase nunca é encontrada por um quique sorteado pelo material, então cada ponto difuso também
+// sorteia uma direção para uma das luzes e testa com um raio de sombra se ela está visível (next event
+// estimation, ver Render::shade_hit).
+//
+// A luz é escolhida com a mesma probabilidade entre as N da lista, e a direção é uniforme no cone que a
+// esfera ocupa vista do ponto: todo o sorteio cai sobre a luz, e o ângulo sólido do cone é o da esfera.
+// Outros objetos emissivos (malhas) continuam iluminando a cena, mas só quando um quique os encontra.
+//
+// O mapa de ambiente, se houver, é a luz que chega de fora da cena (no lugar do céu) e entra no sorteio
+// como mais uma luz, com a direção tirada da própria distribuição dele (ver EnvironmentMap).
+//
+// As esferas são compartilhadas com o mundo, então as luzes acompanham as esferas animadas.
+class LightList {
+    public:
+        void add(std::shared_ptr<const Sphere> sphere, const Vec3 &emission);
+
+        // Acrescenta as esferas de objects cujo material é Emissive
+        void add_emissive(const std::vector<std::shared_ptr<Hittable>> &objects, const MaterialTable &materials);
+
+        // Com sampled falso, o mapa só substitui o céu e é encontrado apenas pelos quiques (usado para comparações)
+        void set_environment(std::shared_ptr<const EnvironmentMap> environment, bool sampled = true) {
+            m_environment = std::move(environment);
+            m_sample_environment = sampled && m_environment != nullptr;
+        }
+
+        // O mapa de ambiente, ou nullptr se o fundo for o céu padrão
+        const EnvironmentMap *environment() const { return m_environment.get(); }
+
+        void clear() { m_lights.clear(); set_environment(nullptr); }
+
+        // Se não há nenhuma luz para amostrar diretamente
+        bool empty() const { return size() == 0; }
+
+        // Quantidade de luzes amostradas diretamente, contando o mapa de ambiente
+        std::size_t size() const { return m_lights.size() + (m_sample_environment ? 1 : 0); }
+
+        // Sorteia uma luz com choice (em [0, 1)) e uma direção para ela com sample. Retorna false se o
+        // ponto estiver dentro da esfera sorteada, que então não o ilumina por fora.
+        bool sample(const Point3 &point, double choice, const Sampling::Point2 &sample, LightSample &light) const;
+
+        // Next event estimation no ponto difuso de rec, de cor albedo, com os números de sampler. Retorna
+        // false se a luz sorteada não ilumina o ponto; caso contrário, a luz light chega ao ponto se
+        // shadow_ray estiver livre até shadow_distance, e é refletida na direção do raio que o tocou (já com
+        // o peso da heurística da potência, mas ainda sem o throughput do caminho). O raio de sombra fica a
+        // cargo de quem chama, que pode testá-lo na hora ou junto com os de outros caminhos.
+        bool sample_direct(const HitRecord &rec, const Vec3 &albedo, Sampler &sampler, Ray &shadow_ray, double &shadow_distance, Vec3 &light) const;
+
+        // Densidade com que sample() teria sorteado, a partir de origin, a direção que tocou a superfície
+        // descrita em rec; 0 se o ponto tocado não for de uma luz da lista
+        double pdf(const Point3 &origin, const HitRecord &rec) const;
+
+        // Densidade com que sample() teria sorteado a direção (unitária) de um raio que saiu da cena
+        double environment_pdf(const Vec3 &direction) const {
+            return m_sample_environment ? m_environment->pdf(direction) / double(size()) : 0.0;
+        }
+
+    private:
+        struct Light {
+            std::shared_ptr<const Sphere> sphere;
+            Vec3 emission;
+        };
+
+        // 1 - cos(θmax) do cone da esfera visto do ponto, a partir do quadrado da distância ao centro
+        // (sem perda de precisão para luzes distantes); 0 se o ponto estiver dentro dela
+        static double cone_one_minus_cos(double radius, double distance_squared);
+
+        std::vector<Light> m_lights;
+
+        std::shared_ptr<const EnvironmentMap> m_environment;
+        bool m_sample_environment{false};
+};
+
+#endif // _LIGHT_HPP_
@@ -0,0 +1,36 @@
+#ifndef _MAPPED_FILE_HPP_
+#define _MAPPED_FILE_HPP_
+
+#include <cstddef>
+
+// Arquivo mapeado em memória, somente leitura. O sistema operacional carrega as páginas sob demanda,
+// sem cópia para um buffer intermediário e sem chamadas de leitura; o mapeamento é desfeito no
+// destrutor.
+class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        // Retorna false se o arquivo não existir, estiver vazio ou não puder ser mapeado. Com populate, o
+        // arquivo inteiro é carregado já na abertura (MAP_POPULATE, no Linux), o que só compensa quando
+        // ele vai ser lido por inteiro logo em seguida; sem populate, cada página é lida no primeiro acesso.
+        bool open(const char *filename, bool populate = true);
+        void close();
+
+        const unsigned char *data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+
+    private:
+        const unsigned char *m_data{nullptr};
+        std::size_t m_size{0};
+
+#ifdef _WIN32
+        void *m_file_handle{nullptr};
+        void *m_mapping_handle{nullptr};
+#endif
+};
+
+#endif // _MAPPED_FILE_HPP_
@@ -1,43 +1,111 @@
 #ifndef _MATERIAL_HPP_
 #define _MATERIAL_HPP_
 
-#include "objects.hpp"
+#include <cstdint>
+#include <variant>
+#include <vector>
+
 #include "ray.hpp"
+#include "vector3d.hpp"
 
-class Material {
-    public:
-        virtual ~Material() = default;
+class HitRecord; // NOTE: Evita problemas de dependência ciclica entre os materiais e HitRecord
+class Sampler;
 
-        // Retorna se o raio de luz incidido na superfície é dividido em vários raios menores de direção aleatória
-        // ao ser refletido (true) ou não (false)
-        virtual bool scatter(const Ray &ray_in_sup, const HitRecord &rec, Vec3& color_attenuation, Ray &scattered) const {
-            return false;
-        }
-};
+// Os materiais são valores simples, sem classe base virtual: cada um implementa scatter(), que retorna se o
+// raio de luz incidido na superfície é desviado (true) ou absorvido (false), e a escolha do material é feita
+// por MaterialTable::scatter. Os números de um desvio aleatório vêm de sampler (ver sampler.hpp).
 
 // Implementação de material difuso. Esses objetos podem desviar a luz e absorver uma parte dela, sempre desviar ou
 // sempre absorver, para essa implementação escolheu-se sempre desviar para simplicidade.
-class Lambertian : public Material {
+class Lambertian {
     public:
-        Lambertian(const Vec3& color_albedo) :
+        explicit Lambertian(const Vec3& color_albedo) :
             m_color_albedo{color_albedo} {}
 
-        bool scatter(const Ray &ray_in_sup, const HitRecord &rec, Vec3& color_attenuation, Ray &scattered) const override;
+        bool scatter(const Ray &ray_in_sup, const HitRecord &rec, Sampler &sampler, Vec3& color_attenuation, Ray &scattered) const;
+
+        const Vec3 &albedo() const { return m_color_albedo; }
 
     private:
         // Albedo é um termo em latim que significa "intensidade da cor branca".
         Vec3 m_color_albedo;
 };
 
-class Metal : public Material {
+class Metal {
     public:
-        Metal(const Vec3 &color_albedo) :
+        explicit Metal(const Vec3 &color_albedo) :
             m_color_albedo{color_albedo} {}
 
-        bool scatter(const Ray &ray_in_sup, const HitRecord &rec, Vec3& color_attenuation, Ray &scattered) const override;
+        bool scatter(const Ray &ray_in_sup, const HitRecord &rec, Sampler &sampler, Vec3& color_attenuation, Ray &scattered) const;
+
+        const Vec3 &albedo() const { return m_color_albedo; }
 
     private:
         Vec3 m_color_albedo;
 };
 
+// Superfície que emite luz (uma lâmpada): emission é a radiância emitida em todas as direções, pelas duas
+// faces. Não desvia a luz que chega, então o caminho termina nela.
+class Emissive {
+    public:
+        explicit Emissive(const Vec3 &emission) :
+            m_emission{emission} {}
+
+        bool scatter(const Ray &ray_in_sup, const HitRecord &rec, Sampler &sampler, Vec3& color_attenuation, Ray &scattered) const {
+            return false;
+        }
+
+        // Para o Denoiser, a cor própria de uma lâmpada é a da luz que ela emite
+        const Vec3 &albedo() const { return m_emission; }
+        const Vec3 &emission() const { return m_emission; }
+
+    private:
+        Vec3 m_emission;
+};
+
+using Material = std::variant<Lambertian, Metal, Emissive>;
+
+// Tabela contígua com todos os materiais de uma cena. Os objetos e os registros de interseção guardam apenas
+// o índice (32 bits) do material nela, então uma interseção não copia nenhum shared_ptr (o que exigiria um
+// incremento e um decremento atômicos no contador de referências, disputado por todas as threads) e o
+// material é lido diretamente do vetor, sem seguir ponteiros nem chamar um método virtual.
+class MaterialTable {
+    public:
+        // Adiciona o material e retorna o seu índice
+        std::uint32_t add(const Material &material) {
+            m_materials.push_back(material);
+            return std::uint32_t(m_materials.size() - 1);
+        }
+
+        std::size_t size() const { return m_materials.size(); }
+        const Material &operator[](std::uint32_t material) const { return m_materials[material]; }
+
+        // Desvia o raio conforme o material de índice material
+        bool scatter(std::uint32_t material, const Ray &ray_in_sup, const HitRecord &rec, Sampler &sampler, Vec3& color_attenuation, Ray &scattered) const {
+            return std::visit([&](const auto &m) { return m.scatter(ray_in_sup, rec, sampler, color_attenuation, scattered); },
+                              m_materials[material]);
+        }
+
+        // Luz emitida pelo material; (0, 0, 0) para os que não são Emissive
+        Vec3 emission(std::uint32_t material) const {
+            auto *emissive = std::get_if<Emissive>(&m_materials[material]);
+            return emissive ? emissive->emission() : Vec3{0, 0, 0};
+        }
+
+        bool is_emissive(std::uint32_t material) const { return std::holds_alternative<Emissive>(m_materials[material]); }
+
+        // O material difuso de índice material, ou nullptr se ele for de outro tipo. Só nos difusos a
+        // luz que chega de qualquer direção é refletida para a câmera, então só neles vale a pena
+        // amostrar as luzes diretamente (ver Render::shade_hit)
+        const Lambertian *diffuse(std::uint32_t material) const { return std::get_if<Lambertian>(&m_materials[material]); }
+
+        // Cor própria do material (usada como atributo do primeiro ponto tocado pelo Denoiser)
+        const Vec3 &albedo(std::uint32_t material) const {
+            return std::visit([](const auto &m) -> const Vec3 & { return m.albedo(); }, m_materials[material]);
+        }
+
+    private:
+        std::vector<Material> m_materials;
+};
+
 #endif // _MATERIAL_HPP_
@@ -1,14 +1,17 @@
 #ifndef OBJECTS_H_
 #define OBJECTS_H_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "vector3d.hpp"
 #include "ray.hpp"
 #include "interval.hpp"
-
-class Material; // NOTE: Evita problemas de dependência ciclica entre as classes Material e HitRecord
+#include "aabb.hpp"
+#include "ray_packet.hpp"
+#include "material.hpp"
+#include "light.hpp"
 
 // Esse header contém os objetos que queremos renderizar. Todos serão deriváveis de uma classe
 // puramente virtul que servirar como base, chamada de "Hittable" (ou seja, tudo que pode ser
@@ -18,13 +21,14 @@ class Material; // NOTE: Evita problemas de dependência ciclica entre as classe
 // 1. O ponto em si
 // 2. O vetor normal ao ponto
 // 3. O valor do parâmetro t da equação da reta do raio de luz
+// 4. O índice do material do objeto na MaterialTable da cena
 class HitRecord {
     public:
         Point3 point;
         Vec3 normal_sur_vector;
         double t;
         bool is_front_face;
-        std::shared_ptr<Material> obj_material;
+        std::uint32_t material;
 
         // Por convenção, todos os vetores normais à superfície do objeto devem
         // apontar para fora (no mesmo sentido do vetor centro->ponto na superfície)
@@ -36,26 +40,45 @@ class HitRecord {
 class Hittable {
     public:
         virtual ~Hittable() = default;
+
+        // NOTE: h_rec só é modificado quando o raio toca o objeto (retorno true), então quem testa vários
+        // objetos pode passar o mesmo registro para todos, estreitando o intervalo a cada interseção.
         virtual bool hit(const Ray &r, Interval acceptable_t_interval, HitRecord &h_rec) const = 0;
+
+        // Caixa alinhada aos eixos que envolve todo o objeto, usada pelas estruturas de aceleração (BVH)
+        virtual AABB bounding_box() const = 0;
+
+        // Testa todos os raios do pacote de uma vez: hits[k] indica se o raio k tocou o objeto e, nesse
+        // caso, h_recs[k] recebe o registro. Por padrão, cada raio é testado separadamente com hit();
+        // estruturas que ganham com raios coerentes (BVH, SphereSoA) sobrescrevem este método.
+        virtual void hit_packet(const RayPacket &packet, Interval acceptable_t_interval, HitRecord *h_recs, bool *hits) const;
 };
 
 class Sphere : public Hittable {
     public:
         // NOTE: raio não pode ser negativo
-        Sphere(const Vec3 &center, double radius, std::shared_ptr<Material> material)
+        // material é o índice do material na MaterialTable da cena
+        Sphere(const Vec3 &center, double radius, std::uint32_t material)
                 : m_center(center), m_radius(fmax(0, radius)), m_material{material} {}
 
-        Vec3 center() { return m_center; };
-        double radius() { return m_radius; };
+        const Vec3 &center() const { return m_center; };
+        void set_center(const Vec3 &center) { m_center = center; }
+        double radius() const { return m_radius; };
+        std::uint32_t material() const { return m_material; }
 
         // O raio contará como "tocado" se o t obtido estiver contido no intervalo aberto (ray_tmin, ray_tmax)
         // isso é: ray_tmin < t < ray_tmax
         bool hit(const Ray& ray, Interval acceptable_t_interval, HitRecord &h_rec) const override;
 
+        AABB bounding_box() const override {
+            Vec3 radius_vec{m_radius, m_radius, m_radius};
+            return AABB{m_center - radius_vec, m_center + radius_vec};
+        }
+
     private:
         Vec3 m_center{};
         double m_radius;
-        std::shared_ptr<Material> m_material;
+        std::uint32_t m_material;
 };
 
 // Uma lista/coleção/agrupamento de todos os objetos que são "tocáveis". Seria uma espécie de "mundo" onde
@@ -64,13 +87,44 @@ class HittableList : public Hittable {
     public:
         std::vector<std::shared_ptr<Hittable>> objects;
 
+        // Materiais referenciados (pelo índice) pelos objetos da lista
+        MaterialTable materials;
+
+        // Luzes amostradas diretamente pela renderização. Não são montadas automaticamente: quem cria
+        // a lista chama lights.add_emissive(objects, materials) depois de adicionar os objetos.
+        LightList lights;
+
+        // A partir dessa quantidade de objetos, build_acceleration() troca o teste linear pela BVH
+        static constexpr std::size_t BVH_MIN_OBJECTS = 8;
+
         HittableList() {}
         explicit HittableList(std::shared_ptr<Hittable> object) { add_to_obj_list(object);  }
 
-        void clear() { objects.clear(); };
-        void add_to_obj_list(std::shared_ptr<Hittable> object) { objects.push_back(object); };
+        void clear() { objects.clear(); lights.clear(); m_acceleration.reset(); };
+        void add_to_obj_list(std::shared_ptr<Hittable> object) { objects.push_back(object); m_acceleration.reset(); };
+
+        // Testar todos os objetos para todo raio custa O(N). Para listas grandes, constrói uma BVH
+        // (O(log N) por raio) que passa a responder hit() no lugar do laço linear. Listas pequenas
+        // compostas apenas por esferas são convertidas em um SphereSoA, testado com SIMD.
+        // NOTE: deve ser chamada depois que todos os objetos foram adicionados e antes da renderização;
+        // modificar a lista (ou o vetor objects diretamente) depois disso invalida a estrutura.
+        void build_acceleration(std::size_t bvh_min_objects = BVH_MIN_OBJECTS);
+
+        // Atualiza a estrutura depois que objetos se moveram (sem adicionar nem remover nenhum): a BVH é
+        // ajustada às novas posições em vez de reconstruída
+        void refit_acceleration();
+
+        // Usa uma estrutura já pronta (por exemplo, a BVH de uma cena compilada) no lugar dos objetos
+        void set_acceleration(std::shared_ptr<Hittable> acceleration) { m_acceleration = std::move(acceleration); }
 
         bool hit(const Ray& r, Interval acceptable_t_interval, HitRecord &rec) const override;
+
+        void hit_packet(const RayPacket &packet, Interval acceptable_t_interval, HitRecord *h_recs, bool *hits) const override;
+
+        AABB bounding_box() const override;
+
+    private:
+        std::shared_ptr<Hittable> m_acceleration;
 };
 
 #endif // OBJECTS_H_
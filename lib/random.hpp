@@ -0,0 +1,110 @@
+#ifndef _RANDOM_HPP_
+#define _RANDOM_HPP_
+
+#include <cstdint>
+#include <cstring>
+
+#include "vector3d.hpp"
+
+// Gerador de números pseudo-aleatórios usado pelo renderizador. Diferente de std::rand(), que possui um
+// único estado global compartilhado por todas as threads, aqui cada thread tem o seu próprio gerador.
+//
+// Além disso, o gerador é reiniciado a partir de (semente, pixel, amostra, quique) antes de cada trecho
+// do caminho de um raio de luz. Assim, a sequência de números usada por um pixel não depende de qual
+// thread o renderizou nem da ordem em que os tiles foram processados: a mesma semente sempre produz a
+// mesma imagem, bit a bit.
+
+// PCG32 (https://www.pcg-random.org/): gerador congruencial linear de 64 bits cuja saída de 32 bits passa
+// por uma permutação (xorshift + rotação). É pequeno, rápido e com qualidade estatística muito superior a
+// de um LCG comum.
+class Pcg32 {
+    public:
+        constexpr Pcg32(std::uint64_t state = 0x853c49e6748fea9bULL, std::uint64_t sequence = 0xda3e39cb94b95bdbULL)
+            : m_state{0}, m_increment{(sequence << 1u) | 1u} {
+            next_u32();
+            m_state += state;
+            next_u32();
+        }
+
+        constexpr std::uint32_t next_u32() {
+            std::uint64_t old_state = m_state;
+            m_state = old_state * 6364136223846793005ULL + m_increment;
+
+            auto xorshifted = static_cast<std::uint32_t>(((old_state >> 18u) ^ old_state) >> 27u);
+            auto rotation = static_cast<std::uint32_t>(old_state >> 59u);
+            return (xorshifted >> rotation) | (xorshifted << ((-rotation) & 31u));
+        }
+
+        // Número no intervalo [0, 1)
+        constexpr double next_double() { return next_u32() * 0x1p-32; }
+
+    private:
+        std::uint64_t m_state;
+        std::uint64_t m_increment;
+};
+
+namespace Random {
+
+    // Finalizador do SplitMix64: espalha os bits da entrada de forma que entradas vizinhas (pixels
+    // vizinhos, por exemplo) gerem estados completamente diferentes.
+    constexpr std::uint64_t mix_bits(std::uint64_t value) {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebULL;
+        value ^= value >> 31;
+        return value;
+    }
+
+    // Acumulam os bits de um double (ou das três coordenadas de um vetor) em key, para identificar uma
+    // cena pelo seu conteúdo (ver Scene::update_hash)
+    inline void mix_double(std::uint64_t &key, double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        key = mix_bits(key ^ bits);
+    }
+
+    inline void mix_vector(std::uint64_t &key, const Vec3 &vector) {
+        mix_double(key, vector.x());
+        mix_double(key, vector.y());
+        mix_double(key, vector.z());
+    }
+
+    constexpr std::uint64_t hash_path(std::uint64_t seed, std::uint64_t pixel_index, std::uint64_t sample_index, std::uint64_t bounce) {
+        return mix_bits(seed ^ mix_bits(pixel_index ^ mix_bits(sample_index ^ mix_bits(bounce + 0x9e3779b97f4a7c15ULL))));
+    }
+
+    // Identifica o caminho que a thread está traçando no momento
+    struct PathContext {
+        std::uint64_t seed;
+        std::uint64_t pixel_index;
+        std::uint64_t sample_index;
+    };
+
+    // NOTE: ambos possuem inicialização constante, então o acesso não passa por nenhuma função de
+    // inicialização de thread_local
+    inline thread_local Pcg32 t_generator{};
+    inline thread_local PathContext t_path{0, 0, 0};
+
+    // Reinicia o gerador da thread para o primeiro trecho (quique 0) do caminho (pixel, amostra)
+    inline void begin_path(std::uint64_t seed, std::uint64_t pixel_index, std::uint64_t sample_index) {
+        t_path = PathContext{seed, pixel_index, sample_index};
+        t_generator = Pcg32{hash_path(seed, pixel_index, sample_index, 0)};
+    }
+
+    // Reinicia o gerador da thread diretamente no trecho de número "bounce" do caminho (pixel, amostra)
+    inline void begin_path(std::uint64_t seed, std::uint64_t pixel_index, std::uint64_t sample_index, std::uint64_t bounce) {
+        t_path = PathContext{seed, pixel_index, sample_index};
+        t_generator = Pcg32{hash_path(seed, pixel_index, sample_index, bounce)};
+    }
+
+    // Reinicia o gerador da thread para o trecho de número "bounce" do caminho atual
+    inline void begin_bounce(std::uint64_t bounce) {
+        t_generator = Pcg32{hash_path(t_path.seed, t_path.pixel_index, t_path.sample_index, bounce)};
+    }
+
+    inline double next_double() { return t_generator.next_double(); }
+
+} // namespace
+
+#endif // _RANDOM_HPP_
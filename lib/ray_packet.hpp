@@ -0,0 +1,39 @@
+#ifndef _RAY_PACKET_HPP_
+#define _RAY_PACKET_HPP_
+
+#include "ray.hpp"
+#include "vector3d.hpp"
+
+// Grupo de raios coerentes (raios primários de pixels vizinhos) traçados juntos pela cena. Os raios
+// ficam em "estrutura de vetores": cada componente em um vetor próprio, de forma que os laços sobre
+// os raios do pacote possam ser vetorizados pelo compilador.
+struct RayPacket {
+    static constexpr int MAX_SIZE = 16;
+
+    int size{0};
+
+    double origin_x[MAX_SIZE];
+    double origin_y[MAX_SIZE];
+    double origin_z[MAX_SIZE];
+
+    double direction_x[MAX_SIZE];
+    double direction_y[MAX_SIZE];
+    double direction_z[MAX_SIZE];
+
+    void add(const Ray &r) {
+        origin_x[size] = r.origin().x();
+        origin_y[size] = r.origin().y();
+        origin_z[size] = r.origin().z();
+        direction_x[size] = r.direction().x();
+        direction_y[size] = r.direction().y();
+        direction_z[size] = r.direction().z();
+        ++size;
+    }
+
+    Ray ray(int index) const {
+        return Ray{Point3{origin_x[index], origin_y[index], origin_z[index]},
+                   Vec3{direction_x[index], direction_y[index], direction_z[index]}};
+    }
+};
+
+#endif // _RAY_PACKET_HPP_
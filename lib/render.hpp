@@ -1,11 +1,39 @@
 #ifndef _RENDER_H_
 #define _RENDER_H_
 
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "vector3d.hpp"
 #include "ray.hpp"
 #include "objects.hpp"
+#include "thread_pool.hpp"
+#include "denoiser.hpp"
+#include "framebuffer.hpp"
+#include "sample_buffer.hpp"
+#include "render_stats.hpp"
+#include "sampler.hpp"
+#include "wavefront.hpp"
+
+// Câmera posicionável: olha de lookfrom para lookat, com vup indicando o "para cima" da imagem e vfov o
+// campo de visão vertical, em graus
+struct CameraSettings {
+    Point3 lookfrom{0, 0, 0};
+    Point3 lookat{0, 0, -1};
+    Vec3 vup{0, 1, 0};
+    double vfov{90.0};
+};
+
+// Região retangular da imagem, com pixels i em [start_i, end_i) e j em [start_j, end_j)
+struct Tile {
+    int start_i;
+    int start_j;
+    int end_i;
+    int end_j;
+};
 
 class Render {
     public:
@@ -25,19 +53,195 @@ class Render {
               // de modo que 16/9 é aprox imd_width / img_height
               m_viewport_width{m_viewport_height * (double(m_img_width) / m_img_height)} {}
 
-        void output_to_ppm(const char *filename);
-        void write_color(std::ostream &out, const Vec3 &color);
-        Vec3 ray_color(const Ray &r, const Hittable &world, int recursive_depth);
+        // Monta a cena, renderiza e escreve a imagem no formato pedido. Retorna false se a escrita falhar.
+        bool output_to_file(const char *filename, ImageFormat format);
+
+        // Mesmo que o anterior, mas com uma cena já montada (por exemplo, lida de um arquivo). scene_hash
+        // identifica a cena nos checkpoints da renderização progressiva.
+        bool output_to_file(const HittableList &world, std::uint64_t scene_hash, const char *filename, ImageFormat format);
+
+        // Cena padrão: chão, uma esfera difusa no centro e duas metálicas nas laterais
+        static HittableList default_scene();
+        static std::uint64_t default_scene_hash() { return world_hash(default_scene()); }
+
+        // Identifica uma cena montada em código pelo conteúdo: materiais, centro, raio e material de cada
+        // esfera (dos outros objetos, apenas a caixa), misturados como em Scene::update_hash
+        static std::uint64_t world_hash(const HittableList &world);
+
+        // Renderiza o mundo no framebuffer (que é redimensionado para o tamanho da imagem)
+        void render(const HittableList &world, Framebuffer &framebuffer);
+
+        // Acrescenta amostras a cada pixel de samples até que ele atinja o número máximo de amostras ou,
+        // com a amostragem adaptativa, até que o erro estimado fique abaixo do limite. As amostras já
+        // presentes em samples são mantidas (ele só é reiniciado se tiver outro tamanho).
+        //
+        // No modo progressivo (set_progressive) cada chamada faz uma única passada; retorna true
+        // quando nenhum pixel precisa de mais amostras.
+        bool render(const HittableList &world, SampleBuffer &samples);
+
+        // Mesmo que o anterior, mas apenas para os tiles de índices tile_indices (posições em
+        // split_into_tiles()), usado para dividir uma imagem entre processos ou máquinas. Como as
+        // amostras dependem só do pixel e da semente, e a amostragem adaptativa decide dentro de cada
+        // tile, juntar os tiles renderizados separadamente resulta na mesma imagem.
+        bool render(const HittableList &world, SampleBuffer &samples, const std::vector<int> &tile_indices);
+
+        Vec3 ray_color(const Ray &r, const HittableList &world, int recursive_depth) {
+            return ray_color(r, world, world.materials, world.lights, recursive_depth);
+        }
+
+        // Versão em que os objetos, a tabela de materiais (indexada por HitRecord::material) e as luzes
+        // amostradas diretamente são passados separadamente. Os quiques usam números independentes, do
+        // gerador da thread.
+        Vec3 ray_color(const Ray &r, const Hittable &world, const MaterialTable &materials, const LightList &lights, int recursive_depth);
+
+        // Cor resultante de um raio que já se sabe ter tocado o objeto descrito em rec. O caminho é
+        // seguido iterativamente (sem recursão) até sair da cena, ser absorvido (por exemplo, ao chegar
+        // a uma luz), ser interrompido pela roleta russa ou completar recursive_depth trechos, com os
+        // números de sampler. Em cada ponto difuso, uma das luzes de lights também é amostrada diretamente.
+        Vec3 shade_hit(const Ray &r, const HitRecord &rec, const Hittable &world, const MaterialTable &materials,
+                       const LightList &lights, int recursive_depth, Sampler &sampler);
+
+        // Cor do "céu", para raios que não tocam nenhum objeto
+        Vec3 background_color(const Ray &r) const;
 
-        // É interessante dividir a renderização em 4 quadrantes da imagem para diminuir o tempo de renderização
-        // por meio de multithreading
-        void render_quadrant(std::ostream &output_file, int quadrant, HittableList &world);
+        // Mesmo que o anterior, mas a partir do mapa de ambiente de lights, se houver um
+        Vec3 background_color(const Ray &r, const LightList &lights) const;
+
+        // A imagem é dividida em pequenos tiles quadrados que são distribuídos entre as threads do
+        // ThreadPool. Como cada tile é pequeno, a carga fica equilibrada mesmo quando uma região da
+        // cena é muito mais cara que outra. As amostras de cada pixel são acumuladas em samples, em
+        // rodadas, até que todos os pixels do tile tenham convergido (ver set_adaptive_sampling).
+        // Retorna false se algum pixel parou apenas por causa do limite da passada.
+        bool render_tile(const Tile &tile, const HittableList &world, SampleBuffer &samples);
+
+        // Uma rodada: amostra cada pixel do tile até que ele tenha targets[k] amostras (k é o índice
+        // do pixel dentro do tile, linha por linha)
+        void sample_tile(const Tile &tile, const HittableList &world, SampleBuffer &samples, const std::vector<std::uint32_t> &targets);
+
+        // Mesmo resultado de sample_tile, mas os raios primários de blocos de pixels vizinhos são
+        // traçados juntos como um RayPacket (ativado com set_packet_size)
+        void sample_tile_packets(const Tile &tile, const HittableList &world, SampleBuffer &samples, const std::vector<std::uint32_t> &targets);
+
+        // Mesmo resultado de sample_tile, mas com todos os caminhos da rodada avançando juntos, um
+        // estágio de cada vez (ver Integrator::WAVEFRONT e WavefrontPaths). Definido em wavefront.cpp.
+        void sample_tile_wavefront(const Tile &tile, const HittableList &world, SampleBuffer &samples, const std::vector<std::uint32_t> &targets);
+
+        // Acumula em estimate a cor da amostra cujo raio primário r já foi testado contra o mundo (hit
+        // e rec são o resultado do teste) e os atributos do primeiro ponto tocado
+        void add_sample(PixelEstimate &estimate, const Ray &r, bool hit, const HitRecord &rec, const HittableList &world, Sampler &sampler);
+
+        // Se o pixel (i, j) do tile já tem amostras suficientes
+        bool pixel_converged(const Tile &tile, int i, int j, const SampleBuffer &samples) const;
+
+        // Quantas amostras o pixel deve ter ao fim da próxima rodada
+        std::uint32_t next_sample_target(const PixelEstimate &estimate) const;
+
+        // Recalcula a altura da imagem, o viewport e a posição dos pixels depois que a largura ou a câmera mudam
+        void configure_view();
+
+        // Escreve o relatório de set_stats_output, se definido
+        bool write_stats() const;
+
+        // Escreve a imagem (e o mapa de amostras, se pedido) a partir das amostras acumuladas
+        bool write_images(const SampleBuffer &samples, const char *filename, ImageFormat format) const;
+
+        // Divide a imagem em tiles de m_tile_size x m_tile_size pixels (os das bordas podem ser menores)
+        std::vector<Tile> split_into_tiles() const;
 
         // A partir das coordenadas (i, j) produza raios de luz que interceptem o pixel de forma aleatória.
         // NOTE: vital para implementação de anti-aliasing
-        Ray get_ray(int i_coord, int j_coord) const;
+        Ray get_ray(int i_coord, int j_coord, Sampler &sampler) const;
+
+        // Mesmo que o anterior, com números independentes do gerador da thread
+        Ray get_ray(int i_coord, int j_coord) const {
+            Sampler independent;
+            return get_ray(i_coord, j_coord, independent);
+        }
+
+        // Amostrador das amostras de cada pixel nas próximas renderizações (ver Sampler)
+        void set_sampler(SamplerType type) { m_sampler_type = type; }
+        SamplerType sampler_type() const { return m_sampler_type; }
+
+        // Amostrador configurado para esta imagem (tamanho, semente e número de amostras)
+        Sampler make_sampler() const { return Sampler{m_sampler_type, m_seed, m_img_width, m_img_height, m_ray_sample_per_pixel}; }
 
-        void merge_renderized_cache_files(std::ostream &final_filename, std::vector<const char*> cache_filenames);
+        // 0 (padrão) utiliza todas as threads de hardware disponíveis
+        void set_thread_count(int thread_count) { m_thread_count = thread_count; }
+        void set_tile_size(int tile_size) { m_tile_size = (tile_size < 1) ? 1 : tile_size; }
+
+        // Traça os raios primários em pacotes de 4, 8 ou 16 raios; 0 desativa os pacotes
+        void set_packet_size(int packet_size) { m_packet_size = packet_size; }
+
+        // Forma de seguir os caminhos (ver Integrator). Com WAVEFRONT, os pacotes não são usados.
+        void set_integrator(Integrator integrator) { m_integrator = integrator; }
+        Integrator integrator() const { return m_integrator; }
+
+        // Com o integrador WAVEFRONT, ordena os raios secundários de cada trecho pela chave de Morton da
+        // origem e da direção antes de testá-los (a imagem não muda, ver sort_by_morton_key em wavefront.cpp)
+        void set_ray_sorting(bool sort_rays) { m_sort_rays = sort_rays; }
+
+        // A altura é recalculada a partir da largura, mantendo o aspect ratio 16:9
+        void set_image_width(int img_width) { m_img_width = (img_width < 1) ? 1 : img_width; configure_view(); }
+
+        // Sem uma câmera definida, a câmera fica na origem olhando para -z com um viewport de altura
+        // viewport_height (passada ao construtor) a uma distância 1
+        void set_camera(const CameraSettings &camera) { m_camera = camera; m_has_camera = true; configure_view(); }
+
+        void set_max_depth(int max_depth) { m_max_recursive_depth = (max_depth < 0) ? 0 : max_depth; }
+
+        int image_width() const { return m_img_width; }
+        int image_height() const { return m_img_height; }
+
+        // Número máximo de amostras por pixel (sem a amostragem adaptativa, todos os pixels recebem esse número)
+        void set_samples_per_pixel(int samples) { m_ray_sample_per_pixel = (samples < 1) ? 1 : samples; }
+
+        // Amostragem adaptativa: cada pixel recebe pelo menos min_samples amostras e depois lotes de
+        // ADAPTIVE_BATCH_SIZE, até que o erro padrão da luminância (já com a correção gamma) dele e
+        // dos vizinhos fique abaixo de error_threshold. Um limite <= 0 desativa a amostragem adaptativa.
+        void set_adaptive_sampling(int min_samples, double error_threshold) {
+            m_min_samples_per_pixel = (min_samples < 2) ? 2 : min_samples;
+            m_adaptive_error_threshold = error_threshold;
+        }
+
+        // Se definido, output_to_file também escreve o mapa do número de amostras de cada pixel
+        void set_sample_map_output(const char *filename) { m_sample_map_filename = filename; }
+
+        // Filtra o ruído da imagem (ver Denoiser) antes de escrevê-la; as amostras não são alteradas
+        void set_denoise(bool denoise) { m_denoise = denoise; }
+        const Denoiser *denoiser() const { return m_denoise ? &m_denoiser : nullptr; }
+
+        static constexpr int ADAPTIVE_BATCH_SIZE = 8;
+
+        // Renderização progressiva: passadas de até samples_per_pass amostras por pixel, com um
+        // checkpoint salvo (e a imagem parcial escrita) ao fim de cada uma. Com resume, output_to_file
+        // continua a partir do checkpoint existente em vez de começar do zero.
+        void set_progressive(int samples_per_pass, const char *checkpoint_filename, bool resume) {
+            m_samples_per_pass = (samples_per_pass < 0) ? 0 : samples_per_pass;
+            m_checkpoint_filename = checkpoint_filename;
+            m_resume = resume;
+        }
+
+        // Chave gravada no checkpoint: combina a cena com os parâmetros que determinam as amostras
+        std::uint64_t checkpoint_key(std::uint64_t scene_hash) const;
+
+        // Quantidade de quiques a partir da qual a roleta russa pode interromper um caminho
+        void set_roulette_min_depth(int min_depth) { m_roulette_min_depth = (min_depth < 1) ? 1 : min_depth; }
+
+        // A mesma semente sempre gera a mesma imagem, independente do número de threads
+        void set_seed(std::uint64_t seed) { m_seed = seed; }
+        std::uint64_t seed() const { return m_seed; }
+
+        // Se definido, output_to_file também escreve um relatório em JSON com as estatísticas da renderização
+        void set_stats_output(const char *filename) { m_stats_filename = filename; }
+
+        // Intervalo entre os relatos de progresso (vazão e tempo restante); 0 desativa os relatos
+        void set_progress_interval(std::chrono::milliseconds interval) { m_progress_interval = interval; }
+
+        // Sem nenhuma mensagem de progresso (usado pelos processos de renderização distribuída)
+        void set_quiet(bool quiet) { m_quiet = quiet; }
+
+        // Contadores acumulados desde o início de output_to_file (ou desde a primeira chamada de render())
+        const RenderStats &stats() const { return m_stats; }
 
     private:
         double m_aspect_ratio;
@@ -78,17 +282,54 @@ class Render {
         Vec3 m_viewport_upper_left{m_camera_center - Vec3(0, 0, m_focal_length) - m_viewport_i/2 - m_viewport_j/2};
         Vec3 m_pixel00_loc{m_viewport_upper_left + 0.5 * (m_pixel_delta_i + m_pixel_delta_j)};
 
+        // Câmera definida com set_camera (as contas acima valem para a câmera padrão)
+        bool m_has_camera{false};
+        CameraSettings m_camera;
+
         // Anti-aliasing, referente a quantos raios aleatórios irão atingir o pixel
         int m_ray_sample_per_pixel{100};
-        double m_ray_sample_scale{1.0 / m_ray_sample_per_pixel};
 
-        // Ao renderizar objetos difusos, é chamada uma função recursiva para o caso do raio de luz bata na forma espacial
-        // e a chamada da função recursiva só será parada quando o raio de luz não bater mais no objeto, o que pode levar
-        // bastante tempo e ocasionar um stack overflow, por isso é necessário limitar quantas chamadas recursivas ray_color()
-        // pode executar
+        // Amostragem adaptativa (desativada enquanto o limite de erro for 0)
+        int m_min_samples_per_pixel{16};
+        double m_adaptive_error_threshold{0.0};
+        const char *m_sample_map_filename{nullptr};
+
+        bool m_denoise{false};
+        Denoiser m_denoiser;
+
+        // Renderização progressiva (desativada enquanto m_samples_per_pass for 0)
+        int m_samples_per_pass{0};
+        const char *m_checkpoint_filename{nullptr};
+        bool m_resume{false};
+
+        // Ao renderizar objetos difusos, o raio de luz pode quicar entre os objetos indefinidamente, o que pode levar
+        // bastante tempo, por isso é necessário limitar quantos trechos cada caminho pode ter
         int m_max_recursive_depth{50};
 
+        // Os primeiros quiques nunca passam pela roleta russa: neles o throughput ainda é alto e
+        // interromper o caminho só aumentaria o ruído
+        int m_roulette_min_depth{3};
+
         Vec3 m_center{0,0,0};
+
+        // Paralelismo: quantidade de threads e tamanho (em pixels) do lado de cada tile
+        int m_thread_count{0};
+        int m_tile_size{16};
+        int m_packet_size{0};
+        Integrator m_integrator{Integrator::MEGAKERNEL};
+        bool m_sort_rays{false};
+
+        // Semente dos geradores de números aleatórios (ver random.hpp)
+        std::uint64_t m_seed{0};
+        SamplerType m_sampler_type{SamplerType::INDEPENDENT};
+
+        // Criado na primeira renderização e reaproveitado nas seguintes
+        std::unique_ptr<ThreadPool> m_thread_pool;
+
+        RenderStats m_stats;
+        const char *m_stats_filename{nullptr};
+        std::chrono::milliseconds m_progress_interval{500};
+        bool m_quiet{false};
 };
 
 #endif
@@ -0,0 +1,121 @@
+#ifndef _RENDER_STATS_HPP_
+#define _RENDER_STATS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Stats {
+
+    // Contadores da thread, incrementados durante o traçado. São variáveis comuns (sem atomics nem
+    // compartilhamento entre threads), então contar não custa mais que uma soma; RenderStats::publish
+    // os transfere para o relatório ao fim de cada tile.
+    struct RayCounters {
+        std::uint64_t primary_rays;
+        std::uint64_t secondary_rays;
+
+        // Raios que só testam se uma luz amostrada diretamente está visível
+        std::uint64_t shadow_rays;
+
+        // Interações com superfícies (cada chamada de scatter, inclusive as que encerram o caminho)
+        std::uint64_t bounces;
+
+        // Testes de interseção com caixas (nós da BVH) e com primitivas (esferas)
+        std::uint64_t box_tests;
+        std::uint64_t primitive_tests;
+    };
+
+    // NOTE: inicialização constante, como o gerador de Random
+    inline thread_local RayCounters t_counters{};
+
+} // namespace
+
+// Estatísticas de uma renderização. Cada thread de renderização tem o seu bloco de contadores,
+// atualizado apenas por ela ao fim de cada tile; uma única thread relatora lê todos os blocos em
+// intervalos fixos e imprime a vazão e o tempo restante estimado, de modo que as threads de
+// renderização nunca escrevem no terminal.
+class RenderStats {
+    public:
+        // NOTE: alinhado em 64 bytes para que os contadores de threads vizinhas não compartilhem uma
+        // linha de cache (false sharing) enquanto a thread relatora os lê
+        struct alignas(64) ThreadCounters {
+            std::atomic<std::uint64_t> primary_rays{0};
+            std::atomic<std::uint64_t> secondary_rays{0};
+            std::atomic<std::uint64_t> shadow_rays{0};
+            std::atomic<std::uint64_t> bounces{0};
+            std::atomic<std::uint64_t> box_tests{0};
+            std::atomic<std::uint64_t> primitive_tests{0};
+            std::atomic<std::uint64_t> tiles{0};
+            std::atomic<std::uint64_t> tile_nanoseconds{0};
+            std::atomic<std::uint64_t> max_tile_nanoseconds{0};
+        };
+
+        struct Totals {
+            std::uint64_t primary_rays{0};
+            std::uint64_t secondary_rays{0};
+            std::uint64_t shadow_rays{0};
+            std::uint64_t bounces{0};
+            std::uint64_t box_tests{0};
+            std::uint64_t primitive_tests{0};
+            std::uint64_t tiles{0};
+            double tile_seconds{0.0};
+            double max_tile_seconds{0.0};
+        };
+
+        RenderStats() = default;
+        ~RenderStats() { end_pass(); }
+
+        RenderStats(const RenderStats &) = delete;
+        RenderStats &operator=(const RenderStats &) = delete;
+
+        // Zera todas as estatísticas
+        void reset();
+
+        // Início de uma passada de tile_count tiles com thread_count threads: inicia a thread relatora,
+        // que imprime o progresso a cada report_interval (0 desativa os relatos intermediários)
+        void begin_pass(int thread_count, int tile_count, std::chrono::milliseconds report_interval);
+
+        // Encerra a thread relatora e acumula o tempo da passada
+        void end_pass();
+
+        // Chamada pela thread thread_index ao terminar um tile: transfere (e zera) os contadores de
+        // Stats::t_counters e registra o tempo do tile
+        void publish(int thread_index, std::chrono::nanoseconds tile_time);
+
+        // Soma dos contadores de todas as threads (ou apenas da thread thread_index)
+        Totals totals() const;
+        Totals thread_totals(int thread_index) const;
+
+        int thread_count() const { return m_thread_count; }
+
+        // Tempo de parede somado de todas as passadas
+        double seconds() const { return m_seconds; }
+
+        // Relatório final em JSON: totais, vazão, tempos dos tiles e os contadores de cada thread
+        bool write_json(const char *filename, int image_width, int image_height) const;
+
+    private:
+        void reporter_loop();
+
+        std::unique_ptr<ThreadCounters[]> m_threads;
+        int m_thread_count{0};
+
+        double m_seconds{0.0};
+
+        // Passada atual
+        std::chrono::steady_clock::time_point m_pass_start;
+        std::atomic<int> m_finished_tiles{0};
+        int m_pass_tiles{0};
+
+        std::thread m_reporter;
+        std::mutex m_mutex;
+        std::condition_variable m_wake_reporter;
+        std::chrono::milliseconds m_report_interval{0};
+        bool m_pass_running{false};
+};
+
+#endif // _RENDER_STATS_HPP_
@@ -0,0 +1,106 @@
+#ifndef _SAMPLE_BUFFER_HPP_
+#define _SAMPLE_BUFFER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "framebuffer.hpp"
+#include "vector3d.hpp"
+
+// Estado da estimativa de um pixel: soma das cores das amostras e média/variância da luminância,
+// atualizadas a cada amostra com o algoritmo de Welford (numericamente estável, sem guardar as amostras)
+//
+// Cada amostra também soma os atributos do primeiro ponto que o seu raio primário tocou (albedo do
+// material, normal e distância até a câmera), que guiam o Denoiser. Um raio que não toca nada conta
+// a cor do céu como albedo, normal nula e distância 0.
+struct PixelEstimate {
+    Vec3 sum{0, 0, 0};
+    double luminance_mean{0.0};
+    double luminance_m2{0.0};
+    std::uint32_t count{0};
+
+    Vec3 albedo_sum{0, 0, 0};
+    Vec3 normal_sum{0, 0, 0};
+    double depth_sum{0.0};
+
+    void add(const Vec3 &color);
+
+    // Deve ser chamada uma vez para cada add()
+    void add_features(const Vec3 &albedo, const Vec3 &normal, double depth) {
+        albedo_sum += albedo;
+        normal_sum += normal;
+        depth_sum += depth;
+    }
+
+    // Junta as amostras de other (de outro processo ou de outra semente) às deste pixel, como se
+    // todas tivessem sido adicionadas aqui
+    void merge(const PixelEstimate &other);
+
+    Vec3 mean() const { return count > 0 ? sum * (1.0 / count) : Vec3{}; }
+
+    Vec3 albedo() const { return count > 0 ? albedo_sum * (1.0 / count) : Vec3{}; }
+    Vec3 normal() const { return count > 0 ? normal_sum * (1.0 / count) : Vec3{}; }
+    double depth() const { return count > 0 ? depth_sum / count : 0.0; }
+
+    // Variância da média da luminância (0 com menos de duas amostras)
+    double variance_of_mean() const { return count > 1 ? luminance_m2 / (double(count - 1) * count) : 0.0; }
+
+    // Erro padrão da média da luminância, medido depois da correção gamma (raíz quadrada) feita na
+    // escrita da imagem. Pelo método delta, d(sqrt(L)) = dL / (2 sqrt(L)): o mesmo ruído absoluto é
+    // muito mais visível em regiões escuras do que em regiões claras.
+    double display_error() const;
+};
+
+// Acumulador de amostras de toda a imagem. Cada thread só toca os pixels do próprio tile; no final
+// as médias são copiadas para um Framebuffer.
+class SampleBuffer {
+    public:
+        void resize(int width, int height);
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+
+        PixelEstimate &pixel(int i, int j) { return m_pixels[std::size_t(j) * m_width + i]; }
+        const PixelEstimate &pixel(int i, int j) const { return m_pixels[std::size_t(j) * m_width + i]; }
+
+        // Escreve a média de cada pixel no framebuffer (redimensionado para o tamanho do buffer)
+        void resolve(Framebuffer &framebuffer) const;
+
+        // Mapa do número de amostras de cada pixel, em tons de cinza: count / max_count
+        void resolve_sample_map(Framebuffer &framebuffer, std::uint32_t max_count) const;
+
+        std::uint64_t total_samples() const;
+
+        // Checkpoint binário com o estado completo de cada pixel. Não é preciso guardar o estado dos
+        // geradores aleatórios: eles são reiniciados a partir de (semente, pixel, amostra), então o
+        // número de amostras de cada pixel já determina a sequência das próximas. scene_key identifica
+        // a cena e os parâmetros da renderização; load() rejeita checkpoints de outra cena.
+        //
+        // A escrita é feita em um arquivo temporário que depois substitui o anterior, de modo que
+        // interromper o programa no meio da escrita nunca deixa um checkpoint corrompido.
+        bool save(const char *filename, std::uint64_t scene_key) const;
+        bool load(const char *filename, std::uint64_t scene_key);
+
+        // Carrega um checkpoint (ou resultado parcial) de qualquer cena, devolvendo a sua chave em scene_key
+        bool load_any(const char *filename, std::uint64_t &scene_key);
+
+        // Junta as amostras de other, pixel a pixel: resultados parciais com tiles diferentes se
+        // completam. Retorna false se os tamanhos forem diferentes.
+        bool merge(const SampleBuffer &other);
+
+        // Estado dos pixels do retângulo [start_i, end_i) x [start_j, end_j), linha a linha, no mesmo
+        // formato do checkpoint (RECORD_SIZE bytes por pixel). Usado para enviar tiles entre processos.
+        static constexpr std::size_t RECORD_SIZE = 104;
+        void pack_region(int start_i, int start_j, int end_i, int end_j, unsigned char *records) const;
+        void unpack_region(int start_i, int start_j, int end_i, int end_j, const unsigned char *records);
+
+    private:
+        bool read_checkpoint(const char *filename, const std::uint64_t *expected_key, std::uint64_t &scene_key);
+
+        int m_width{0};
+        int m_height{0};
+        std::vector<PixelEstimate> m_pixels;
+};
+
+#endif // _SAMPLE_BUFFER_HPP_
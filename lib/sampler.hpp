@@ -0,0 +1,106 @@
+#ifndef _SAMPLER_HPP_
+#define _SAMPLER_HPP_
+
+#include <cstdint>
+
+#include "random.hpp"
+#include "sampling.hpp"
+
+// Origem dos números de cada caminho de luz (ver Sampler)
+enum class SamplerType {
+    // Números pseudo-aleatórios independentes (o gerador da thread, ver random.hpp)
+    INDEPENDENT,
+
+    // Sequência de Sobol com embaralhamento de Owen, independente em cada pixel
+    SOBOL,
+
+    // Sobol ordenada pela curva Z dos pixels: o erro que sobra forma um ruído azul na imagem
+    BLUE_NOISE,
+};
+
+// Fornece os números de cada amostra de um pixel, separados em dimensões: a câmera usa as primeiras do
+// trecho 0 e cada quique usa as do próprio trecho, na ordem em que são pedidas (a direção do desvio, a
+// roleta russa...). Como no gerador da thread, os valores dependem apenas de (semente, pixel, amostra,
+// trecho, dimensão), então a imagem não depende da ordem dos tiles nem do número de threads.
+//
+// Com números independentes, o erro de N amostras cai com 1/sqrt(N). As sequências de Sobol são
+// estratificadas: as 2^k primeiras amostras de cada par de dimensões formam uma rede (0, k, 2), com um
+// ponto em cada retângulo 2^-a x 2^-(k-a) do quadrado, e o erro cai mais rápido em integrandos suaves
+// (bordas e penumbras).
+// - SOBOL: as duas primeiras dimensões de Sobol, com a ordem das amostras e os bits de cada coordenada
+//   embaralhados por hashes diferentes para cada pixel e dimensão (Burley, "Practical Hash-based Owen
+//   Scrambling", 2020). Pixels e dimensões ficam descorrelacionados e qualquer número de amostras é válido.
+// - BLUE_NOISE: uma única sequência para a imagem toda, cujo índice é o da curva Z do pixel seguido do
+//   índice da amostra, com os dígitos de base 4 permutados por nível (Ahmed e Wonka, "Screen-Space
+//   Blue-Noise Diffusion of Monte Carlo Sampling Error via Hierarchical Ordering of Pixels", 2020). Cada
+//   bloco de 2x2 pixels vizinhos recebe juntos uma rede, o que empurra o erro para frequências altas, que
+//   o olho (e o Denoiser) percebem menos. Depende do número máximo de amostras por pixel: um checkpoint
+//   só pode ser continuado com um número de amostras que arredonde para a mesma potência de 2.
+class Sampler {
+    public:
+        // Amostrador independente, que usa o gerador da thread como ele estiver (ver Random::begin_path)
+        Sampler() = default;
+
+        Sampler(SamplerType type, std::uint64_t seed, int image_width, int image_height, int samples_per_pixel);
+
+        // Começa a amostra sample_index do pixel (i, j), no trecho 0 (o raio da câmera)
+        void start_pixel_sample(int i, int j, std::uint32_t sample_index);
+
+        // Passa para as dimensões do trecho de número bounce do caminho atual
+        void start_bounce(int bounce);
+
+        // O mesmo que start_pixel_sample(i, j, sample_index) seguido de start_bounce(bounce), reiniciando o
+        // gerador da thread uma única vez. Usado pelo integrador wavefront, que alterna entre os caminhos.
+        void resume(int i, int j, std::uint32_t sample_index, int bounce);
+
+        // Próxima dimensão do trecho atual, em [0, 1)
+        double get_1d() {
+            if (m_type == SamplerType::INDEPENDENT)
+                return Random::next_double();
+
+            return quasi_random_1d();
+        }
+
+        // Próximas duas dimensões do trecho atual, como um ponto de [0, 1)²
+        Sampling::Point2 get_2d() {
+            if (m_type == SamplerType::INDEPENDENT)
+                return Sampling::random_point2();
+
+            return quasi_random_2d();
+        }
+
+        SamplerType type() const { return m_type; }
+
+        // BLUE_NOISE: bits do índice reservados para as amostras de cada pixel (log2 de samples_per_pixel,
+        // arredondado para cima). Com outro valor a disposição do índice muda, então ele entra na chave do
+        // checkpoint (ver Render::checkpoint_key).
+        int log2_samples() const { return m_log2_samples; }
+
+    private:
+        double quasi_random_1d();
+        Sampling::Point2 quasi_random_2d();
+
+        // Hash da dimensão atual, base dos embaralhamentos (com SOBOL, também do pixel)
+        std::uint64_t dimension_hash() const;
+
+        // Índice da amostra na sequência de Sobol para a dimensão atual
+        std::uint64_t sobol_index(std::uint64_t dimension_hash) const;
+
+        SamplerType m_type{SamplerType::INDEPENDENT};
+        std::uint64_t m_seed{0};
+        int m_image_width{1};
+
+        // BLUE_NOISE: log2 do número de amostras e quantidade de dígitos de base 4 do índice (curva Z mais amostra)
+        int m_log2_samples{0};
+        int m_base4_digits{0};
+
+        // Amostra atual
+        std::uint64_t m_pixel_index{0};
+        std::uint64_t m_morton_index{0};
+        std::uint32_t m_sample_index{0};
+
+        // Trecho nos 16 bits de cima e a dimensão dentro dele nos de baixo, sem sobreposição entre trechos
+        std::uint32_t m_dimension{0};
+};
+
+#endif // _SAMPLER_HPP_
@@ -0,0 +1,138 @@
+#ifndef _SAMPLING_HPP_
+#define _SAMPLING_HPP_
+
+#include <algorithm>
+#include <cmath>
+
+#include "utility.hpp"
+
+// Transformações fechadas (sem tentativa e descarte) de um ponto do quadrado [0, 1)² em direções e pontos
+// com uma distribuição conhecida. Cada amostra consome exatamente dois números aleatórios e o custo não
+// depende da sorte: não há laço, e pontos vizinhos no quadrado continuam vizinhos depois da transformação
+// (o que preserva a estratificação de sequências melhores que a aleatória).
+namespace Sampling {
+
+    // Ponto de amostragem no quadrado unitário [0, 1)²
+    struct Point2 {
+        double u;
+        double v;
+    };
+
+    // Dois números do gerador da thread atual (ver random.hpp)
+    inline Point2 random_point2() {
+        double u = Utility::random_double();
+        return Point2{u, Utility::random_double()};
+    }
+
+    // Seno e cosseno de (π/4)·t para t em [-1, 1], pelas séries de Taylor até x^17 e x^16 (o primeiro termo
+    // desprezado é menor que 5e-17 neste intervalo). As transformações abaixo só precisam de ângulos em um
+    // oitavo de volta, e o polinômio custa bem menos que sin() e cos() da biblioteca, que reduzem o ângulo
+    // ao intervalo primeiro.
+    inline void sin_cos_quarter_pi(double t, double &sine, double &cosine) {
+        double x = 0.25 * Utility::PI * t;
+        double x2 = x * x;
+
+        sine = x * (1.0 + x2 * (-1.0 / 6 + x2 * (1.0 / 120 + x2 * (-1.0 / 5040 + x2 * (1.0 / 362880
+                 + x2 * (-1.0 / 39916800 + x2 * (1.0 / 6227020800 + x2 * (-1.0 / 1307674368000
+                 + x2 * (1.0 / 355687428096000)))))))));
+        cosine = 1.0 + x2 * (-1.0 / 2 + x2 * (1.0 / 24 + x2 * (-1.0 / 720 + x2 * (1.0 / 40320
+                 + x2 * (-1.0 / 3628800 + x2 * (1.0 / 479001600 + x2 * (-1.0 / 87178291200
+                 + x2 * (1.0 / 20922789888000))))))));
+    }
+
+    // Ponto no disco unitário pelo mapeamento concêntrico de Shirley e Chiu (1997): cada quadrado
+    // concêntrico de [-1, 1]² vira um círculo, sem a concentração no centro de r = sqrt(u) e com pouca
+    // distorção das áreas. Densidade 1 / π.
+    inline Point2 concentric_disk(const Point2 &sample) {
+        double a = 2.0 * sample.u - 1.0;
+        double b = 2.0 * sample.v - 1.0;
+
+        if (a == 0.0 && b == 0.0)
+            return Point2{0.0, 0.0};
+
+        // Ângulo (π/4)·(b/a) nos quadrantes da esquerda e da direita; em cima e embaixo é π/2 - (π/4)·(a/b),
+        // e o seno e o cosseno trocam de lugar. Escrito com seleções em vez de dois ramos, que o processador
+        // não teria como prever (metade dos pontos cai em cada caso).
+        bool horizontal = std::fabs(a) > std::fabs(b);
+        double r = horizontal ? a : b;
+
+        double sine, cosine;
+        sin_cos_quarter_pi((horizontal ? b : a) / r, sine, cosine);
+        return Point2{r * (horizontal ? cosine : sine), r * (horizontal ? sine : cosine)};
+    }
+
+    // Direção uniforme na esfera unitária. A metade u < 1/2 do quadrado vai para o hemisfério z > 0 e a
+    // outra para z < 0; em cada um, o ponto do disco concêntrico de raio r vira z = 1 - r², que é uniforme
+    // em [0, 1] (Arquimedes: faixas de mesma altura têm a mesma área), mantendo a direção em torno de z
+    // (mapeamento de mesma área de Shirley). Densidade 1 / 4π.
+    inline Vec3 uniform_sphere(const Point2 &sample) {
+        bool lower = sample.u >= 0.5;
+        auto disk = concentric_disk(Point2{lower ? 2.0 * sample.u - 1.0 : 2.0 * sample.u, sample.v});
+
+        double r2 = disk.u * disk.u + disk.v * disk.v;
+        double z = 1.0 - r2;
+        double scale = std::sqrt(std::max(0.0, 2.0 - r2));
+        return Vec3{disk.u * scale, disk.v * scale, lower ? -z : z};
+    }
+
+    inline double uniform_sphere_pdf() { return 0.25 / Utility::PI; }
+
+    // Direção no hemisfério z > 0 com densidade cos(θ) / π (método de Malley: o ponto do disco é projetado
+    // para cima, sobre o hemisfério)
+    inline Vec3 cosine_hemisphere(const Point2 &sample) {
+        auto disk = concentric_disk(sample);
+        double z = std::sqrt(std::max(0.0, 1.0 - disk.u * disk.u - disk.v * disk.v));
+        return Vec3{disk.u, disk.v, z};
+    }
+
+    inline double cosine_hemisphere_pdf(double cos_theta) { return cos_theta / Utility::PI; }
+
+    // Direção uniforme no cone em torno de z com abertura θmax, dada por k = 1 - cos(θmax) (que, para cones
+    // estreitos, perderia os dígitos significativos se fosse calculado a partir do cosseno). Como na esfera,
+    // o ponto do disco de raio r vai para a altura z = 1 - r²·k, uniforme em [cos(θmax), 1]. Densidade 1 / 2πk.
+    inline Vec3 uniform_cone(const Point2 &sample, double one_minus_cos_max) {
+        auto disk = concentric_disk(sample);
+        double r2k = (disk.u * disk.u + disk.v * disk.v) * one_minus_cos_max;
+
+        // sin²θ = (1 - z)(1 + z) = r²·k·(2 - r²·k), e a direção em torno de z é a do ponto do disco
+        double scale = std::sqrt(std::max(0.0, one_minus_cos_max * (2.0 - r2k)));
+        return Vec3{disk.u * scale, disk.v * scale, 1.0 - r2k};
+    }
+
+    inline double uniform_cone_pdf(double one_minus_cos_max) { return 0.5 / (Utility::PI * one_minus_cos_max); }
+
+    // Heurística da potência (Veach, 1995): peso de uma amostra sorteada com densidade pdf quando a mesma
+    // direção também poderia ter vindo da outra estratégia, de densidade other_pdf. Os pesos das duas
+    // estratégias para uma direção somam 1, então a média não muda, e cada direção fica com a estratégia
+    // que a sorteia com mais frequência.
+    inline double power_heuristic(double pdf, double other_pdf) {
+        double pdf2 = pdf * pdf;
+        return pdf2 / (pdf2 + other_pdf * other_pdf);
+    }
+
+    // Base ortonormal com o eixo z na direção de uma normal unitária, para levar as direções acima (geradas
+    // em torno de z) para a superfície. Construção sem ramos nem normalização de Duff et al. (2017).
+    class Frame {
+        public:
+            explicit Frame(const Vec3 &normal) : m_normal{normal} {
+                double sign = std::copysign(1.0, normal.z());
+                double a = -1.0 / (sign + normal.z());
+                double b = normal.x() * normal.y() * a;
+
+                m_tangent = Vec3{1.0 + sign * normal.x() * normal.x() * a, sign * b, -sign * normal.x()};
+                m_bitangent = Vec3{b, sign + normal.y() * normal.y() * a, -normal.y()};
+            }
+
+            Vec3 to_world(const Vec3 &local) const {
+                return local.x() * m_tangent + local.y() * m_bitangent + local.z() * m_normal;
+            }
+
+        private:
+            Vec3 m_tangent;
+            Vec3 m_bitangent;
+            Vec3 m_normal;
+    };
+
+} // namespace
+
+#endif // _SAMPLING_HPP_
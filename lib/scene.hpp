@@ -0,0 +1,136 @@
+#ifndef _SCENE_HPP_
+#define _SCENE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "animation.hpp"
+#include "bvh.hpp"
+#include "objects.hpp"
+#include "render.hpp"
+#include "transform.hpp"
+#include "triangle_mesh.hpp"
+#include "vector3d.hpp"
+
+struct MaterialDescription {
+    enum class Type : std::uint32_t { LAMBERTIAN, METAL, EMISSIVE };
+
+    Type type;
+    Vec3 albedo; // em EMISSIVE, a luz emitida (pode passar de 1)
+};
+
+struct SphereDescription {
+    Point3 center;
+    double radius;
+    std::uint32_t material; // índice em Scene::materials()
+};
+
+// Cópia de uma malha posicionada no mundo ('mesh' ou 'instance')
+struct InstanceDescription {
+    std::uint32_t mesh;     // índice em Scene::meshes()
+    Transform transform;    // do espaço da malha para o mundo
+    std::uint32_t material; // índice em Scene::materials()
+};
+
+// Cena lida de um arquivo, em um de dois formatos:
+//
+// 1. Texto, uma instrução por linha ('#' inicia um comentário):
+//
+//        image 854                               # largura da imagem (a altura segue o aspect ratio 16:9)
+//        samples 100                             # amostras por pixel
+//        depth 50                                # limite de trechos por caminho
+//        camera 0 0 0  0 0 -1  0 1 0  90         # origem, alvo, vetor "para cima" e campo de visão vertical
+//        material chao lambertian 0.8 0.8 0.0    # nome, tipo (lambertian, metal ou emissive) e albedo
+//        material lampada emissive 4 4 4         # em 'emissive', a cor é a luz emitida
+//        sphere 0 -100.5 -1  100  chao           # centro, raio e nome do material
+//        mesh modelos/bule.obj  chao             # malha de triângulos (OBJ ou binária) e nome do material
+//        instance modelos/arvore.obj  chao  rotate 0 1 0 30  scale 2  translate 4 0 -6
+//
+//    Todas as instruções são opcionais; os materiais precisam ser definidos antes do uso. Os
+//    arquivos das malhas são procurados a partir do diretório do arquivo da cena. As esferas com
+//    material emissive são as luzes amostradas diretamente (ver LightList).
+//
+//    'instance' posiciona uma cópia da malha com as transformações listadas, aplicadas na ordem em
+//    que aparecem: translate x y z, rotate (eixo x y z e ângulo em graus) e scale (um fator ou três).
+//    Cada arquivo é carregado uma única vez, por mais que apareça em 'mesh' e 'instance': as cópias
+//    compartilham os vértices e a BVH da malha (ver Instance).
+//
+//    Animações (renderizadas com --frames, ver Animation) são descritas por quadros-chave:
+//
+//        key 0 camera 0 0 0  0 0 -1  0 1 0  90   # quadro-chave da câmera (mesmos valores de 'camera')
+//        key 24 sphere 1  0 0.5 -1.2             # quadro-chave do centro da esfera 1 (contando a partir de 0)
+//
+//    As esferas precisam ser definidas antes dos quadros-chave que as movem.
+//
+// 2. Cena compilada (compile()): uma imagem binária com os materiais, as esferas já na ordem das
+//    folhas da BVH e os nós da BVH. O arquivo é mapeado em memória e os vetores são copiados em
+//    bloco para as estruturas de renderização, sem interpretar texto, sem um make_shared por objeto
+//    e sem reconstruir a BVH. A animação não é gravada, e cenas com malhas não podem ser compiladas
+//    (as malhas já têm o próprio formato binário, ver TriangleMesh).
+//
+// load() reconhece o formato pelo conteúdo do arquivo.
+class Scene {
+    public:
+        // Retorna false e descreve o problema (com o número da linha) em error. Os caminhos relativos
+        // das malhas partem de directory.
+        bool parse(std::string_view text, std::string &error, const std::string &directory = "");
+
+        bool load(const char *filename, std::string &error);
+
+        // Escreve a cena compilada. Retorna false se a cena tiver malhas ou se o arquivo não puder ser escrito.
+        bool compile(const char *filename) const;
+
+        // Monta o mundo renderizável
+        HittableList world() const;
+
+        // Aplica à renderização as configurações presentes no arquivo (largura, amostras, profundidade e câmera)
+        void configure(Render &render) const;
+
+        // Identifica o conteúdo da cena (usado pelos checkpoints); é o mesmo para o texto e a cena compilada
+        std::uint64_t hash() const { return m_hash; }
+
+        const std::vector<MaterialDescription> &materials() const { return m_materials; }
+        const Animation &animation() const { return m_animation; }
+        std::size_t sphere_count() const { return m_compiled ? m_compiled_sphere_count : m_spheres.size(); }
+        const std::vector<std::shared_ptr<TriangleMesh>> &meshes() const { return m_meshes; }
+        const std::vector<InstanceDescription> &instances() const { return m_instances; }
+
+    private:
+        bool load_compiled(const unsigned char *data, std::size_t size, std::string &error);
+
+        void update_hash();
+
+        MaterialTable make_materials() const;
+
+        // Configurações da renderização; 0 (ou m_has_camera falso) significa "não definido no arquivo"
+        int m_image_width{0};
+        int m_samples_per_pixel{0};
+        int m_max_depth{0};
+        bool m_has_camera{false};
+        CameraSettings m_camera;
+
+        std::vector<MaterialDescription> m_materials;
+
+        // Esferas da cena em texto; na cena compilada elas ficam diretamente na BVH
+        std::vector<SphereDescription> m_spheres;
+
+        // Malhas já carregadas (uma por arquivo) e as suas cópias no mundo. No mundo as cópias vêm
+        // depois das esferas, então world.objects[k] continua sendo a esfera k
+        std::vector<std::shared_ptr<TriangleMesh>> m_meshes;
+        std::vector<InstanceDescription> m_instances;
+
+        Animation m_animation;
+
+        std::shared_ptr<BVH> m_compiled;
+        std::size_t m_compiled_sphere_count{0};
+
+        // Esferas emissivas da cena compilada, que também formam a lista de luzes do mundo
+        std::vector<SphereDescription> m_compiled_lights;
+
+        std::uint64_t m_hash{0};
+};
+
+#endif // _SCENE_HPP_
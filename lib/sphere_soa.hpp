@@ -0,0 +1,97 @@
+#ifndef _SPHERE_SOA_HPP_
+#define _SPHERE_SOA_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "objects.hpp"
+#include "render_stats.hpp"
+
+// Coleção de esferas armazenada como "estrutura de vetores" (structure of arrays): em vez de um
+// vetor de objetos Sphere, cada atributo (x, y e z do centro, raio) fica em um vetor contíguo próprio.
+// Assim, as coordenadas de 4 esferas consecutivas podem ser carregadas em um único registrador SIMD
+// e um raio é testado contra várias esferas por instrução, sem chamada virtual nem shared_ptr por
+// esfera.
+//
+// O kernel de interseção (AVX2, SSE2 ou escalar) é escolhido em tempo de execução conforme o
+// processador.
+class SphereSoA : public Hittable {
+    public:
+        enum class Kernel { SCALAR, SSE2, AVX2 };
+
+        SphereSoA() : m_kernel{best_kernel()} {}
+
+        void reserve(std::size_t count);
+        void add(const Point3 &center, double radius, std::uint32_t material);
+
+        // Substitui o conteúdo por count esferas já em formato SoA (por exemplo, lidas de uma cena
+        // compilada). material_index[k] é o índice do material da esfera k na MaterialTable da cena.
+        void assign(std::size_t count, const double *center_x, const double *center_y, const double *center_z,
+                    const double *radius, const std::uint32_t *material_index);
+
+        // Copia todas as esferas de objects. Se algum objeto não for uma Sphere, nada é adicionado e
+        // retorna false.
+        bool add_if_all_spheres(const std::vector<std::shared_ptr<Hittable>> &objects);
+
+        std::size_t size() const { return m_count; }
+
+        Point3 center(std::size_t index) const { return Point3{m_center_x[index], m_center_y[index], m_center_z[index]}; }
+        void set_center(std::size_t index, const Point3 &center) {
+            m_center_x[index] = center.x();
+            m_center_y[index] = center.y();
+            m_center_z[index] = center.z();
+        }
+        double radius(std::size_t index) const { return m_radius[index]; }
+        AABB sphere_bounds(std::size_t index) const;
+
+        // Testa o raio apenas contra as esferas [first, first + count), usado pelas folhas da BVH
+        bool hit_range(const Ray &r, std::size_t first, std::size_t count, Interval acceptable_t_interval, HitRecord &h_rec) const;
+
+        bool hit(const Ray &r, Interval acceptable_t_interval, HitRecord &h_rec) const override {
+            Stats::t_counters.primitive_tests += size();
+            return hit_range(r, 0, size(), acceptable_t_interval, h_rec);
+        }
+
+        // Versão para pacotes: cada esfera do trecho é testada contra todos os raios do pacote, em um
+        // laço sobre os raios vetorizável. t_max[k] e closest[k] (índice da esfera ou -1) são
+        // atualizados para cada raio; o registro completo é montado depois, com fill_record().
+        void hit_range_packet(const RayPacket &packet, std::size_t first, std::size_t count, double t_min, double *t_max, long *closest) const;
+
+        void hit_packet(const RayPacket &packet, Interval acceptable_t_interval, HitRecord *h_recs, bool *hits) const override;
+
+        // Preenche o registro do raio r que tocou a esfera index no parâmetro t
+        void fill_record(const Ray &r, std::size_t index, double t, HitRecord &h_rec) const;
+
+        AABB bounding_box() const override;
+
+        // Permite forçar um kernel específico (usado nos benchmarks). Kernels não suportados pelo
+        // processador são ignorados.
+        void set_kernel(Kernel kernel) { if (kernel_supported(kernel)) m_kernel = kernel; }
+        Kernel kernel() const { return m_kernel; }
+
+        static bool kernel_supported(Kernel kernel);
+        static Kernel best_kernel();
+
+        // Quantidade de esferas testadas por iteração do kernel mais largo. Os vetores terminam com
+        // LANE_PADDING - 1 esferas inválidas (NaN), para que a última iteração nunca leia fora deles,
+        // mesmo quando o trecho testado começa em uma posição qualquer.
+        static constexpr std::size_t LANE_PADDING = 4;
+
+    private:
+        std::size_t m_count{0};
+
+        // NOTE: o tamanho destes vetores é m_count + LANE_PADDING - 1
+        std::vector<double> m_center_x;
+        std::vector<double> m_center_y;
+        std::vector<double> m_center_z;
+        std::vector<double> m_radius;
+
+        // Índice do material de cada esfera na MaterialTable da cena
+        std::vector<std::uint32_t> m_material_index;
+
+        Kernel m_kernel;
+};
+
+#endif // _SPHERE_SOA_HPP_
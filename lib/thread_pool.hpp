@@ -0,0 +1,63 @@
+#ifndef _THREAD_POOL_HPP_
+#define _THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Conjunto fixo de threads que executa lotes de tarefas independentes (no caso do renderizador, tiles
+// da imagem). Cada thread possui a sua própria fila de tarefas; quando ela esvazia, a thread "rouba"
+// tarefas do final da fila das outras, de modo que nenhuma fique ociosa enquanto ainda houver trabalho.
+//
+// As threads são criadas uma única vez e reaproveitadas em todas as chamadas de run().
+class ThreadPool {
+    public:
+        // Se thread_count <= 0, utiliza-se std::thread::hardware_concurrency()
+        explicit ThreadPool(int thread_count = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        int size() const { return static_cast<int>(m_workers.size()); }
+
+        // Executa task(índice_da_tarefa, índice_da_thread) para todo índice em [0, task_count) e só
+        // retorna quando todas as tarefas tiverem terminado.
+        void run(int task_count, const std::function<void(int, int)> &task);
+
+        // Número de threads de hardware disponíveis (nunca menor que 1)
+        static int default_thread_count();
+
+    private:
+        // NOTE: alinhado em 64 bytes (tamanho típico de uma linha de cache) para que o mutex de uma
+        // fila não compartilhe linha de cache com o da fila vizinha (false sharing)
+        struct alignas(64) WorkQueue {
+            std::mutex mutex;
+            std::deque<int> tasks;
+        };
+
+        void worker_loop(int worker_id);
+
+        // Retira uma tarefa da própria fila ou, se ela estiver vazia, rouba de outra thread
+        bool pop_task(int worker_id, int &task);
+
+        std::vector<std::thread> m_workers;
+        std::unique_ptr<WorkQueue[]> m_queues;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake_workers;
+        std::condition_variable m_workers_finished;
+
+        const std::function<void(int, int)> *m_task{nullptr};
+        std::uint64_t m_generation{0};
+        int m_finished_workers{0};
+        bool m_stop{false};
+};
+
+#endif // _THREAD_POOL_HPP_
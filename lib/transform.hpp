@@ -0,0 +1,137 @@
+#ifndef _TRANSFORM_HPP_
+#define _TRANSFORM_HPP_
+
+#include <cmath>
+
+#include "aabb.hpp"
+#include "utility.hpp"
+#include "vector3d.hpp"
+
+// Transformação afim p -> A p + b, guardada como uma matriz 3x4: as três primeiras colunas são a
+// parte linear A (rotação, escala, cisalhamento) e a última é a translação b. Pontos recebem a
+// translação; vetores (direções) apenas a parte linear.
+class Transform {
+    public:
+        // Identidade
+        Transform() : m_matrix{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}} {}
+
+        static Transform translate(const Vec3 &offset) {
+            Transform transform;
+            for (int row = 0; row < 3; ++row)
+                transform.m_matrix[row][3] = offset[row];
+            return transform;
+        }
+
+        static Transform scale(const Vec3 &factors) {
+            Transform transform;
+            for (int row = 0; row < 3; ++row)
+                transform.m_matrix[row][row] = factors[row];
+            return transform;
+        }
+
+        // Rotação de degrees graus em torno do eixo axis (não precisa ser unitário), pela fórmula de Rodrigues
+        static Transform rotate(const Vec3 &axis, double degrees) {
+            auto u = axis.unit();
+            double angle = Utility::degrees_to_radian(degrees);
+            double c = std::cos(angle), s = std::sin(angle), k = 1.0 - c;
+
+            Transform transform;
+            double rotation[3][3] = {{c + u.x() * u.x() * k, u.x() * u.y() * k - u.z() * s, u.x() * u.z() * k + u.y() * s},
+                                     {u.y() * u.x() * k + u.z() * s, c + u.y() * u.y() * k, u.y() * u.z() * k - u.x() * s},
+                                     {u.z() * u.x() * k - u.y() * s, u.z() * u.y() * k + u.x() * s, c + u.z() * u.z() * k}};
+
+            for (int row = 0; row < 3; ++row)
+                for (int column = 0; column < 3; ++column)
+                    transform.m_matrix[row][column] = rotation[row][column];
+
+            return transform;
+        }
+
+        // Composição: (a * b) aplica primeiro b e depois a
+        friend Transform operator*(const Transform &a, const Transform &b) {
+            Transform result;
+
+            for (int row = 0; row < 3; ++row) {
+                for (int column = 0; column < 4; ++column) {
+                    double value = column == 3 ? a.m_matrix[row][3] : 0.0;
+                    for (int k = 0; k < 3; ++k)
+                        value += a.m_matrix[row][k] * b.m_matrix[k][column];
+                    result.m_matrix[row][column] = value;
+                }
+            }
+
+            return result;
+        }
+
+        Point3 apply_point(const Point3 &point) const {
+            return Point3{row(0) * point + m_matrix[0][3], row(1) * point + m_matrix[1][3], row(2) * point + m_matrix[2][3]};
+        }
+
+        Vec3 apply_vector(const Vec3 &vector) const { return Vec3{row(0) * vector, row(1) * vector, row(2) * vector}; }
+
+        // Aplica a transposta da parte linear. Se esta é a transformação inversa M⁻¹, o resultado é a
+        // normal transformada por M: normais não acompanham M (a escala não uniforme as entortaria),
+        // e sim (M⁻¹)ᵀ, que as mantém perpendiculares à superfície transformada
+        Vec3 apply_transposed(const Vec3 &vector) const {
+            return vector.x() * column(0) + vector.y() * column(1) + vector.z() * column(2);
+        }
+
+        // Determinante da parte linear (0 quando a transformação não tem inversa)
+        double determinant() const {
+            return row(0) * (row(1) % row(2));
+        }
+
+        // NOTE: só faz sentido se determinant() != 0. A inversa da parte linear vem da matriz adjunta
+        // (cujas colunas são os produtos vetoriais das linhas) e a translação passa a ser -A⁻¹ b
+        Transform inverse() const {
+            auto r0 = row(0), r1 = row(1), r2 = row(2);
+            double inverse_determinant = 1.0 / determinant();
+            Vec3 columns[3] = {(r1 % r2) * inverse_determinant, (r2 % r0) * inverse_determinant, (r0 % r1) * inverse_determinant};
+
+            Transform result;
+            for (int row_index = 0; row_index < 3; ++row_index)
+                for (int column_index = 0; column_index < 3; ++column_index)
+                    result.m_matrix[row_index][column_index] = columns[column_index][row_index];
+
+            auto translation = result.apply_vector(Vec3{m_matrix[0][3], m_matrix[1][3], m_matrix[2][3]});
+            for (int row_index = 0; row_index < 3; ++row_index)
+                result.m_matrix[row_index][3] = -translation[row_index];
+
+            return result;
+        }
+
+        // Caixa que contém a caixa box transformada (a caixa dos seus 8 vértices transformados)
+        AABB apply_box(const AABB &box) const {
+            if (box.is_empty())
+                return box;
+
+            AABB result;
+            for (int corner = 0; corner < 8; ++corner) {
+                Point3 point{(corner & 1) ? box.max().x() : box.min().x(),
+                             (corner & 2) ? box.max().y() : box.min().y(),
+                             (corner & 4) ? box.max().z() : box.min().z()};
+                result.expand(apply_point(point));
+            }
+
+            return result;
+        }
+
+        double operator()(int row_index, int column_index) const { return m_matrix[row_index][column_index]; }
+
+        bool is_identity() const {
+            for (int row_index = 0; row_index < 3; ++row_index)
+                for (int column_index = 0; column_index < 4; ++column_index)
+                    if (m_matrix[row_index][column_index] != (row_index == column_index ? 1.0 : 0.0))
+                        return false;
+
+            return true;
+        }
+
+    private:
+        Vec3 row(int index) const { return Vec3{m_matrix[index][0], m_matrix[index][1], m_matrix[index][2]}; }
+        Vec3 column(int index) const { return Vec3{m_matrix[0][index], m_matrix[1][index], m_matrix[2][index]}; }
+
+        double m_matrix[3][4];
+};
+
+#endif // _TRANSFORM_HPP_
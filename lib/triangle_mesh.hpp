@@ -0,0 +1,105 @@
+#ifndef _TRIANGLE_MESH_HPP_
+#define _TRIANGLE_MESH_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "aabb.hpp"
+#include "bvh.hpp"
+#include "mapped_file.hpp"
+#include "objects.hpp"
+
+// Malha de triângulos com vértices compartilhados: um vetor com as coordenadas (x, y, z) de cada
+// vértice e, para cada triângulo, três índices nesse vetor. A malha tem a sua própria BVH (build_bvh
+// sobre as caixas dos triângulos, com os triângulos reordenados na ordem das folhas), então aparece
+// na cena como um único objeto, por maior que seja, em vez de um shared_ptr<Hittable> por triângulo.
+//
+// Os vetores podem pertencer à malha (construtor e load_obj) ou ficar em um arquivo binário mapeado
+// em memória (load_binary): nesse caso nada é copiado nem alocado por triângulo. A abertura lê os nós
+// da BVH uma vez, para validá-los; os vértices e os índices são carregados do disco só nas páginas que
+// a travessia toca, e as páginas lidas podem ser descartadas pelo sistema, então a malha pode ser
+// maior que a memória livre.
+//
+// Formato binário (save_binary): cabeçalho, vértices (3 doubles por vértice), índices (3 uint32 por
+// triângulo, na ordem das folhas) e os nós da BVH, cada seção alinhada a 64 bytes.
+class TriangleMesh : public Hittable {
+    public:
+        TriangleMesh() = default;
+
+        // vertices tem 3 coordenadas por vértice e indices 3 índices por triângulo
+        TriangleMesh(std::vector<double> vertices, std::vector<std::uint32_t> indices, std::uint32_t material);
+
+        // Os ponteiros apontam para os próprios vetores (ou para o arquivo mapeado), que continuam os
+        // mesmos depois de uma movimentação, mas não de uma cópia
+        TriangleMesh(const TriangleMesh &) = delete;
+        TriangleMesh &operator=(const TriangleMesh &) = delete;
+        TriangleMesh(TriangleMesh &&) = default;
+        TriangleMesh &operator=(TriangleMesh &&) = default;
+
+        // Importa as linhas 'v' e 'f' de um arquivo OBJ (as demais são ignoradas). Faces com mais de 3
+        // vértices são divididas em leque; índices negativos contam a partir do último vértice.
+        // Retorna false e descreve o problema (com o número da linha) em error.
+        bool load_obj(const char *filename, std::uint32_t material, std::string &error);
+
+        // Mapeia um arquivo escrito por save_binary. A BVH e os triângulos são usados diretamente do
+        // mapeamento, sem reconstrução nem cópia. A abertura lê todos os nós em sequência para validá-los,
+        // o que é a maior parte do arquivo (cada nó ocupa 64 bytes, mais que os vértices e índices de um
+        // triângulo); o restante só é lido pela travessia.
+        bool load_binary(const char *filename, std::uint32_t material, std::string &error);
+
+        // Reconhece o formato pelo conteúdo do arquivo
+        bool load(const char *filename, std::uint32_t material, std::string &error);
+
+        bool save_binary(const char *filename) const;
+
+        std::size_t vertex_count() const { return m_vertex_count; }
+        std::size_t triangle_count() const { return m_triangle_count; }
+        std::size_t node_count() const { return m_node_count; }
+        std::uint32_t material() const { return m_material; }
+
+        Point3 vertex(std::size_t index) const {
+            return Point3{m_vertices[3 * index], m_vertices[3 * index + 1], m_vertices[3 * index + 2]};
+        }
+
+        // Índice do vértice corner (0, 1 ou 2) do triângulo triangle, na ordem das folhas da BVH. Um
+        // índice inválido de um arquivo mapeado (que não é conferido na abertura) vira o último vértice.
+        std::uint32_t vertex_index(std::size_t triangle, int corner) const {
+            return std::uint32_t(std::min<std::size_t>(m_indices[3 * triangle + corner], m_vertex_count - 1));
+        }
+
+        // Teste "estanque" (watertight) de Woop, Benthin e Wald (2013): o raio é levado a um sistema de
+        // coordenadas em que ele aponta para +z, e cada aresta vira uma função 2D calculada da mesma
+        // forma (com o sinal trocado) pelos dois triângulos que a compartilham. Um raio que passa
+        // exatamente por uma aresta ou vértice toca pelo menos um dos triângulos: não há frestas na malha.
+        bool hit(const Ray &r, Interval acceptable_t_interval, HitRecord &h_rec) const override;
+
+        AABB bounding_box() const override { return m_node_count == 0 ? AABB{} : m_nodes[0].bounds; }
+
+    private:
+        // Aponta m_vertices, m_indices e m_nodes para os vetores próprios
+        void use_owned_buffers();
+
+        void build_bvh_and_reorder();
+
+        const double *m_vertices{nullptr};
+        const std::uint32_t *m_indices{nullptr};
+        const BVHNode *m_nodes{nullptr};
+
+        std::size_t m_vertex_count{0};
+        std::size_t m_triangle_count{0};
+        std::size_t m_node_count{0};
+
+        std::uint32_t m_material{0};
+
+        // Dados próprios (vazios quando a malha vem de um arquivo mapeado)
+        std::vector<double> m_owned_vertices;
+        std::vector<std::uint32_t> m_owned_indices;
+        std::vector<BVHNode> m_owned_nodes;
+
+        std::shared_ptr<MappedFile> m_file;
+};
+
+#endif // _TRIANGLE_MESH_HPP_
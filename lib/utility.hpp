@@ -2,9 +2,9 @@
 #define CONSTANTS_H_
 
 #include <limits>
-#include <cstdlib>
 
 #include "vector3d.hpp"
+#include "random.hpp"
 
 namespace Utility {
 
@@ -15,9 +15,9 @@ namespace Utility {
         return degrees * PI / 180.0;
     }
 
-    // É possível obter números aleatórios utilizando <random> nativo de C++
-    // mas para os fins de randomização de raios de luz, esse método serve
-    double random_double();
+    // Número aleatório em [0, 1) retirado do gerador da thread atual (ver random.hpp).
+    // NOTE: std::rand() não é utilizado porque compartilha estado entre as threads
+    inline double random_double() { return Random::next_double(); }
 
     // NOTE: Cuidado com a chamada de random_double()
     double random_double(double min, double max);
@@ -9,70 +9,125 @@
 /*
 Criaremos uma pequena biblioteca para representar um vetor tridimensional (um modo oportuno para representar raios de luz no
 espaço) junto com algumas operações fundamentais, como soma, normal, vetor oposto, etc.
+
+Todas as operações ficam no cabeçalho para que o compilador possa expandi-las inline em qualquer unidade de tradução (elas
+são executadas bilhões de vezes por imagem). O tipo do escalar é um parâmetro do template: Vec3 usa double e Vec3f usa float.
 */
 
-class Vec3 {
+template <typename T>
+class BasicVec3 {
     public:
-        explicit Vec3(double x = 0, double y = 0, double z = 0)
+        using value_type = T;
+
+        constexpr explicit BasicVec3(T x = 0, T y = 0, T z = 0) noexcept
             : m_vector{x, y, z} {}
 
-        double x() const { return m_vector[0]; }
-        double y() const { return m_vector[1]; }
-        double z() const { return m_vector[2]; }
+        constexpr T x() const noexcept { return m_vector[0]; }
+        constexpr T y() const noexcept { return m_vector[1]; }
+        constexpr T z() const noexcept { return m_vector[2]; }
+
+        // Componente pelo índice do eixo (0 = x, 1 = y, 2 = z)
+        constexpr T operator[](int axis) const noexcept { return m_vector[axis]; }
 
         // Vetor oposto (-v)
-        Vec3 operator-() const { return Vec3(-x(), -y(), -z()); }
+        constexpr BasicVec3 operator-() const noexcept { return BasicVec3(-x(), -y(), -z()); }
 
         // Soma entre vetores
-        Vec3& operator+=(const Vec3& vector);
+        constexpr BasicVec3& operator+=(const BasicVec3& vector) noexcept {
+            m_vector[0] += vector.x();
+            m_vector[1] += vector.y();
+            m_vector[2] += vector.z();
+
+            return *this;
+        }
 
         // Multiplicação entre um vetor um escalar real t
-        Vec3& operator*=(double t);
+        constexpr BasicVec3& operator*=(T t) noexcept {
+            m_vector[0] *= t;
+            m_vector[1] *= t;
+            m_vector[2] *= t;
+
+            return *this;
+        }
 
         // Retorna o módulo do vetor ao quadrado, para evitar custos de processamentos
         // relacionados a extrair a raíz quadrada em situações que não é necessário fazê-la
-        double squared_length() const;
+        constexpr T squared_length() const noexcept {
+            return (x() * x()) + (y() * y()) + (z() * z());
+        }
 
         // Norma do vetor tridimensional: d = sqrt(x^2 + y^2 + z^2)
-        double length() const;
+        T length() const noexcept { return std::sqrt(squared_length()); }
 
-        // Majoritariamente, usado para printar o objecto Vec3 na forma X Y Z 
-        friend std::ostream& operator<<(std::ostream& out, const Vec3& vetor);
+        // Majoritariamente, usado para printar o objecto Vec3 na forma X Y Z
+        friend std::ostream& operator<<(std::ostream& out, const BasicVec3& vetor) {
+            return out << vetor.x() << " " << vetor.y() << " " << vetor.z();
+        }
+
+        // NOTE: os operadores abaixo são definidos dentro da classe (e encontrados por ADL) em vez de
+        // serem templates livres, para que o escalar aceite conversões implícitas, como em v / int.
 
         // Subtração entre vetores
-        friend Vec3 operator-(const Vec3& vetor_u, const Vec3& vetor_v);
+        friend constexpr BasicVec3 operator-(const BasicVec3& vetor_u, const BasicVec3& vetor_v) noexcept {
+            return BasicVec3{ vetor_u.x() - vetor_v.x(), vetor_u.y() - vetor_v.y(), vetor_u.z() - vetor_v.z() };
+        }
 
         // Soma entre vetores
-        friend Vec3 operator+(const Vec3& vetor_u, const Vec3& vetor_v);
+        friend constexpr BasicVec3 operator+(const BasicVec3& vetor_u, const BasicVec3& vetor_v) noexcept {
+            return BasicVec3{ vetor_u.x() + vetor_v.x(), vetor_u.y() + vetor_v.y(), vetor_u.z() + vetor_v.z() };
+        }
 
         // Produto entre vetor e escalar, escalar e vetor, etc, todas as ordem
         // de operação são cobertas.
-        friend Vec3 operator*(const Vec3& vetor, double scalar);
-        friend Vec3 operator*(double scalar, const Vec3& vetor);
+        friend constexpr BasicVec3 operator*(const BasicVec3& vetor, T scalar) noexcept {
+            return BasicVec3{ scalar * vetor.x(), scalar * vetor.y(), scalar * vetor.z() };
+        }
+
+        friend constexpr BasicVec3 operator*(T scalar, const BasicVec3& vetor) noexcept {
+            return vetor * scalar;
+        }
 
         // Em teoria, apenas com os operadores acima é possível fazer divisão de
-        // escalar por vetor, porém definir esse operador ajudará a manter uma 
-        // sintaxe mais natural ao manipular objetos Vec3
-        friend Vec3 operator/(const Vec3& vetor, double scalar);
-        friend Vec3 operator/(double scalar, const Vec3& vetor);
+        // escalar por vetor, porém definir esse operador ajudará a manter uma
+        // sintaxe mais natural ao manipular objetos Vec3.
+        // NOTE: uma divisão e três multiplicações custam menos que três divisões
+        friend constexpr BasicVec3 operator/(const BasicVec3& vetor, T scalar) noexcept {
+            return (1 / scalar) * vetor;
+        }
 
-        // Produto escalar
-        friend double operator*(const Vec3& vetor_u, const Vec3& vetor_v);
+        friend constexpr BasicVec3 operator/(T scalar, const BasicVec3& vetor) noexcept {
+            return vetor / scalar;
+        }
 
-        // Produto vetorial. NOTE: esse método pode não ser necessariamente o mais
-        // performático, abre margem para otimização
-        friend Vec3 operator%(const Vec3& vetor_u, const Vec3& vetor_w);
+        // Produto escalar
+        friend constexpr T operator*(const BasicVec3& vetor_u, const BasicVec3& vetor_v) noexcept {
+            return vetor_u.x() * vetor_v.x()
+                 + vetor_u.y() * vetor_v.y()
+                 + vetor_u.z() * vetor_v.z();
+        }
+
+        // Produto vetorial
+        friend constexpr BasicVec3 operator%(const BasicVec3& vetor_u, const BasicVec3& vetor_w) noexcept {
+            return BasicVec3{ vetor_u.y() * vetor_w.z() - vetor_u.z() * vetor_w.y(),
+                              vetor_u.z() * vetor_w.x() - vetor_u.x() * vetor_w.z(),
+                              vetor_u.x() * vetor_w.y() - vetor_u.y() * vetor_w.x() };
+        }
 
         // Vetor unitário
-        Vec3 unit() const { return *this / this->length(); };
+        BasicVec3 unit() const noexcept { return *this / this->length(); }
 
         // Retorna se o vetor está próximo do valor 0 em suas componentes
-        bool near_zero() const;
+        constexpr bool near_zero() const noexcept {
+            constexpr T limit = T(1e-8);
+            return (x() < limit && -x() < limit) && (y() < limit && -y() < limit) && (z() < limit && -z() < limit);
+        }
 
       private:
-        std::array<double, 3> m_vector;
+        std::array<T, 3> m_vector;
 };
 
+using Vec3 = BasicVec3<double>;
+using Vec3f = BasicVec3<float>;
 
 // Representar pontos e cores como vetores pode não ser a melhor abordagem. TODO: Refatorar
 using Point3 = Vec3;
@@ -0,0 +1,105 @@
+#ifndef _WAVEFRONT_HPP_
+#define _WAVEFRONT_HPP_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "objects.hpp"
+#include "ray.hpp"
+#include "vector3d.hpp"
+
+// Forma de seguir os caminhos de luz de um tile (ver Render::set_integrator)
+enum class Integrator {
+    // Cada caminho é seguido do raio da câmera até o fim antes de começar o próximo (Render::shade_hit):
+    // interseção, materiais e luzes se alternam a cada quique
+    MEGAKERNEL,
+
+    // Todos os caminhos de uma rodada do tile avançam juntos, um estágio de cada vez: gerar os raios da
+    // câmera, testar a interseção, agrupar os pontos tocados por material, desviar os raios de cada
+    // material em bloco, testar os raios de sombra e compactar os caminhos que continuam
+    // (Render::sample_tile_wavefront). A imagem é idêntica à do MEGAKERNEL.
+    WAVEFRONT,
+};
+
+// Componentes x, y e z de um vetor por caminho, cada uma em um vetor próprio
+struct Vec3Array {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+
+    void resize(std::size_t size) {
+        x.resize(size);
+        y.resize(size);
+        z.resize(size);
+    }
+
+    Vec3 get(std::size_t index) const { return Vec3{x[index], y[index], z[index]}; }
+
+    void set(std::size_t index, const Vec3 &value) {
+        x[index] = value.x();
+        y[index] = value.y();
+        z[index] = value.z();
+    }
+};
+
+// Estado dos caminhos de uma rodada do integrador wavefront em "estrutura de vetores" (como RayPacket):
+// cada estágio percorre só os campos que usa, em posições consecutivas da memória. Os caminhos são
+// identificados pela posição nesses vetores e os estágios trocam apenas filas de posições.
+struct WavefrontPaths {
+    // Número máximo de caminhos em andamento de uma vez; as rodadas maiores são divididas em lotes
+    static constexpr std::size_t MAX_PATHS = 1 << 14;
+
+    // Amostra de cada caminho: pixel (índice dentro do tile, linha por linha) e índice da amostra nele
+    std::vector<std::uint32_t> pixel;
+    std::vector<std::uint32_t> sample;
+
+    // Número do trecho do raio atual (0 é o raio da câmera)
+    std::vector<int> bounce;
+
+    // Raio atual e o ponto tocado por ele
+    Vec3Array origin;
+    Vec3Array direction;
+    std::vector<HitRecord> hit;
+
+    // Mesmo significado das variáveis de Render::shade_hit
+    Vec3Array throughput;
+    Vec3Array radiance;
+    std::vector<double> scatter_pdf;
+
+    // Atributos do primeiro ponto tocado (ver PixelEstimate::add_features)
+    Vec3Array albedo;
+    Vec3Array normal;
+    std::vector<double> depth;
+
+    // Filas: caminhos com um raio a testar, os que tocaram algum objeto (na ordem do teste e agrupados
+    // por material, com o início do grupo de cada material em material_start) e os que continuam
+    std::vector<std::uint32_t> active;
+    std::vector<std::uint32_t> hits;
+    std::vector<std::uint32_t> by_material;
+    std::vector<std::uint32_t> material_start;
+    std::vector<std::uint32_t> next;
+
+    // Chave de Morton e posição de cada raio secundário da fila de ativos, quando eles são ordenados
+    // (ver Render::set_ray_sorting)
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> ray_keys;
+
+    // Raios de sombra pendentes, com a luz que cada um leva ao caminho de shadow_path se estiver livre
+    std::size_t shadow_count{0};
+    std::vector<std::uint32_t> shadow_path;
+    Vec3Array shadow_origin;
+    Vec3Array shadow_direction;
+    std::vector<double> shadow_distance;
+    Vec3Array shadow_light;
+
+    void resize(std::size_t size);
+
+    Ray ray(std::size_t path) const { return Ray{origin.get(path), direction.get(path)}; }
+
+    void set_ray(std::size_t path, const Ray &r) {
+        origin.set(path, r.origin());
+        direction.set(path, r.direction());
+    }
+};
+
+#endif // _WAVEFRONT_HPP_
@@ -1,19 +1,231 @@
 #include "lib/render.hpp"
+#include "lib/animation.hpp"
+#include "lib/cli.hpp"
+#include "lib/scene.hpp"
+#include "lib/triangle_mesh.hpp"
+#include "lib/distributed.hpp"
+#include "lib/environment.hpp"
+#include "lib/random.hpp"
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
+
+// Junta os resultados parciais (--tiles) em uma única imagem
+static bool merge_partial_results(const CliOptions &options) {
+    SampleBuffer merged;
+    std::uint64_t merged_key = 0;
+
+    for (std::size_t k = 0; k < options.merge_filenames.size(); ++k) {
+        SampleBuffer partial;
+        std::uint64_t key;
+
+        if (!partial.load_any(options.merge_filenames[k], key)) {
+            std::cerr << "[ERRO] não foi possível ler o resultado parcial " << options.merge_filenames[k] << std::endl;
+            return false;
+        }
+
+        if (k == 0) {
+            merged = std::move(partial);
+            merged_key = key;
+            continue;
+        }
+
+        if (key != merged_key || !merged.merge(partial)) {
+            std::cerr << "[ERRO] " << options.merge_filenames[k] << " é de outra cena ou configuração" << std::endl;
+            return false;
+        }
+    }
+
+    Render render{merged.width()};
+    render.set_sample_map_output(options.sample_map_filename);
+    render.set_denoise(options.denoise);
+    if (options.samples_per_pixel > 0)
+        render.set_samples_per_pixel(options.samples_per_pixel);
+
+    return render.write_images(merged, options.output_filename, options.format);
+}
+
+// Argumentos dos processos worker: os mesmos do coordenador, sem as opções que dizem respeito apenas
+// à imagem final, mais --worker. Cada worker renderiza um tile por vez, então uma thread basta.
+static std::vector<std::string> worker_arguments(int argc, char *argv[]) {
+    std::vector<std::string> arguments;
+
+    for (int arg = 1; arg < argc; ++arg) {
+        bool coordinator_only = std::strcmp(argv[arg], "--workers") == 0 || std::strcmp(argv[arg], "--output") == 0
+                             || std::strcmp(argv[arg], "--stats") == 0 || std::strcmp(argv[arg], "--sample-map") == 0;
+
+        // Também só da imagem final, mas sem valor
+        if (std::strcmp(argv[arg], "--denoise") == 0)
+            continue;
+
+        if (coordinator_only) {
+            ++arg;
+            continue;
+        }
+
+        arguments.push_back(argv[arg]);
+    }
+
+    for (const char *argument : {"--worker", "--threads", "1"})
+        arguments.push_back(argument);
+
+    return arguments;
+}
 
 auto main(int argc, char *argv[]) -> int {
 
+    CliOptions options;
+
+    if (!parse_cli_options(argc, argv, options)) {
+        print_usage(std::cerr, argv[0]);
+        return -1;
+    }
+
+    if (!options.merge_filenames.empty())
+        return merge_partial_results(options) ? 0 : -1;
+
+    // Conversão de uma malha OBJ para o formato binário, carregado depois por mapeamento em memória
+    if (options.mesh_filename != nullptr) {
+        TriangleMesh mesh;
+        std::string error;
+
+        if (!mesh.load_obj(options.mesh_filename, 0, error)) {
+            std::cerr << "[ERRO] malha " << options.mesh_filename << ": " << error << std::endl;
+            return -1;
+        }
+
+        if (!mesh.save_binary(options.compile_filename)) {
+            std::cerr << "[ERRO] não foi possível escrever o arquivo " << options.compile_filename << std::endl;
+            return -1;
+        }
+
+        std::clog << "Malha compilada em " << options.compile_filename << " (" << mesh.triangle_count() << " triângulos)" << std::endl;
+        return 0;
+    }
+
+    Scene scene;
+
+    if (options.scene_filename != nullptr) {
+        std::string error;
+
+        if (!scene.load(options.scene_filename, error)) {
+            std::cerr << "[ERRO] cena " << options.scene_filename << ": " << error << std::endl;
+            return -1;
+        }
+    }
+
+    if (options.compile_filename != nullptr) {
+        if (!scene.meshes().empty()) {
+            std::cerr << "[ERRO] cenas com malhas não podem ser compiladas; converta as malhas com --mesh" << std::endl;
+            return -1;
+        }
+
+        if (!scene.compile(options.compile_filename)) {
+            std::cerr << "[ERRO] não foi possível escrever o arquivo " << options.compile_filename << std::endl;
+            return -1;
+        }
+
+        if (!scene.animation().empty())
+            std::clog << "[AVISO] os quadros-chave da animação não são gravados na cena compilada" << std::endl;
+
+        std::clog << "Cena compilada em " << options.compile_filename << " (" << scene.sphere_count() << " esferas)" << std::endl;
+        return 0;
+    }
+
     // Renderizaremos uma imagem em 408p
     Render ray_tracing_instance{854};
 
-    if (argc == 3 && strcmp(argv[1], "--output") == 0)
-        ray_tracing_instance.output_to_ppm(argv[2]);
+    // As opções da linha de comando têm prioridade sobre as do arquivo de cena
+    scene.configure(ray_tracing_instance);
 
-    else {
-        std::cerr << "[ERRO] Uso: ./" << argv[0] << " --output arquivo.ppm" << std::endl;
-        return -1;
+    ray_tracing_instance.set_thread_count(options.thread_count);
+    ray_tracing_instance.set_seed(options.seed);
+    ray_tracing_instance.set_sampler(options.sampler);
+    ray_tracing_instance.set_packet_size(options.packet_size);
+    ray_tracing_instance.set_integrator(options.sort_rays ? Integrator::WAVEFRONT : options.integrator);
+    ray_tracing_instance.set_ray_sorting(options.sort_rays);
+    ray_tracing_instance.set_roulette_min_depth(options.roulette_min_depth);
+    ray_tracing_instance.set_adaptive_sampling(options.min_samples_per_pixel, options.adaptive_error_threshold);
+    ray_tracing_instance.set_sample_map_output(options.sample_map_filename);
+    ray_tracing_instance.set_denoise(options.denoise);
+    ray_tracing_instance.set_stats_output(options.stats_filename);
+
+    if (options.samples_per_pixel > 0)
+        ray_tracing_instance.set_samples_per_pixel(options.samples_per_pixel);
+
+    if (options.checkpoint_filename != nullptr)
+        ray_tracing_instance.set_progressive(options.samples_per_pass, options.checkpoint_filename, options.resume);
+
+    auto world = options.scene_filename != nullptr ? scene.world() : Render::default_scene();
+    auto scene_hash = options.scene_filename != nullptr ? scene.hash() : Render::default_scene_hash();
+
+    // O mapa de ambiente vale para qualquer cena e também identifica a imagem nos checkpoints
+    if (options.environment_filename != nullptr) {
+        auto environment = std::make_shared<EnvironmentMap>();
+        std::string error;
+
+        if (!environment->load(options.environment_filename, error)) {
+            std::cerr << "[ERRO] mapa de ambiente " << options.environment_filename << ": " << error << std::endl;
+            return -1;
+        }
+
+        scene_hash = Random::mix_bits(scene_hash ^ environment->hash());
+        world.lights.set_environment(std::move(environment));
+    }
+
+    // Animação: o mesmo Render (com as suas threads) e o mesmo mundo servem para todos os quadros
+    if (options.first_frame >= 0)
+        return render_animation(ray_tracing_instance, world, scene.animation(), options.first_frame, options.last_frame,
+                                options.output_filename, options.format) ? 0 : -1;
+
+    // Processo iniciado por um coordenador (--workers): tiles pela entrada padrão, resultados pela saída
+    if (options.worker) {
+        ray_tracing_instance.set_quiet(true);
+        return Distributed::run_worker(ray_tracing_instance, world, 0, 1) ? 0 : -1;
+    }
+
+    // Apenas uma parte dos tiles, gravada como resultado parcial para ser juntada depois com --merge
+    if (options.first_tile >= 0) {
+        int tile_count = int(ray_tracing_instance.split_into_tiles().size());
+
+        std::vector<int> tile_indices;
+        for (int tile = options.first_tile; tile < std::min(options.end_tile, tile_count); ++tile)
+            tile_indices.push_back(tile);
+
+        SampleBuffer samples;
+        while (!ray_tracing_instance.render(world, samples, tile_indices)) {}
+
+        if (!samples.save(options.output_filename, ray_tracing_instance.checkpoint_key(scene_hash))) {
+            std::cerr << "[ERRO] não foi possível escrever o arquivo " << options.output_filename << std::endl;
+            return -1;
+        }
+
+        std::clog << tile_indices.size() << " de " << tile_count << " tiles gravados em " << options.output_filename << std::endl;
+        return 0;
     }
 
+    // Coordenador: os tiles são distribuídos entre processos locais
+    if (options.worker_count > 0) {
+        std::vector<Distributed::Worker> workers;
+        SampleBuffer samples;
+
+        bool rendered = Distributed::spawn_workers(Distributed::current_executable(argv[0]), worker_arguments(argc, argv),
+                                                   options.worker_count, workers)
+                     && Distributed::distribute_tiles(ray_tracing_instance, workers, samples);
+
+        if (!Distributed::finish_workers(workers))
+            std::cerr << "[AVISO] algum processo de renderização terminou com erro" << std::endl;
+
+        if (!rendered || !ray_tracing_instance.write_images(samples, options.output_filename, options.format))
+            return -1;
+
+        return 0;
+    }
+
+    if (!ray_tracing_instance.output_to_file(world, scene_hash, options.output_filename, options.format))
+        return -1;
+
   return 0;
 }
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <utility>
+
+#include "../lib/animation.hpp"
+#include "../lib/random.hpp"
+
+namespace {
+
+    // Spline de Catmull-Rom pelos valores value(keys[k]): entre dois quadros-chave, um polinômio de
+    // Hermite cujas tangentes em cada quadro-chave são dadas pelos vizinhos. Os quadros-chave não
+    // precisam estar igualmente espaçados.
+    template <typename Key, typename Get>
+    auto catmull_rom(const std::vector<Key> &keys, double frame, Get value) {
+        if (keys.size() == 1 || frame <= keys.front().frame)
+            return value(keys.front());
+        if (frame >= keys.back().frame)
+            return value(keys.back());
+
+        auto next = std::upper_bound(keys.begin(), keys.end(), frame, [](double f, const Key &key) { return f < key.frame; });
+        auto k = std::size_t(next - keys.begin()) - 1;
+
+        // Nas extremidades, a tangente usa apenas o vizinho existente
+        auto tangent = [&](std::size_t index) {
+            auto before = index > 0 ? index - 1 : index;
+            auto after = index + 1 < keys.size() ? index + 1 : index;
+            return (1.0 / (keys[after].frame - keys[before].frame)) * (value(keys[after]) - value(keys[before]));
+        };
+
+        auto length = keys[k + 1].frame - keys[k].frame;
+        auto s = (frame - keys[k].frame) / length;
+        auto s2 = s * s;
+        auto s3 = s2 * s;
+
+        return (2 * s3 - 3 * s2 + 1) * value(keys[k]) + (s3 - 2 * s2 + s) * length * tangent(k)
+             + (-2 * s3 + 3 * s2) * value(keys[k + 1]) + (s3 - s2) * length * tangent(k + 1);
+    }
+
+    // Insere key mantendo a ordem dos quadros; um quadro-chave no mesmo quadro é substituído
+    template <typename Key>
+    void insert_key(std::vector<Key> &keys, const Key &key) {
+        auto position = std::lower_bound(keys.begin(), keys.end(), key.frame, [](const Key &k, double f) { return k.frame < f; });
+
+        if (position != keys.end() && position->frame == key.frame)
+            *position = key;
+        else
+            keys.insert(position, key);
+    }
+
+} // namespace
+
+void Animation::add_camera_key(double frame, const CameraSettings &camera) {
+    insert_key(m_camera_keys, CameraKeyframe{frame, camera});
+}
+
+void Animation::add_sphere_key(std::uint32_t sphere, double frame, const Point3 &center) {
+    insert_key(m_sphere_keys[sphere], SphereKeyframe{frame, center});
+}
+
+CameraSettings Animation::camera_at(double frame) const {
+    CameraSettings camera;
+
+    camera.lookfrom = catmull_rom(m_camera_keys, frame, [](const CameraKeyframe &key) { return key.camera.lookfrom; });
+    camera.lookat = catmull_rom(m_camera_keys, frame, [](const CameraKeyframe &key) { return key.camera.lookat; });
+    camera.vup = catmull_rom(m_camera_keys, frame, [](const CameraKeyframe &key) { return key.camera.vup; });
+    camera.vfov = catmull_rom(m_camera_keys, frame, [](const CameraKeyframe &key) { return key.camera.vfov; });
+
+    return camera;
+}
+
+Point3 Animation::sphere_center_at(std::uint32_t sphere, double frame) const {
+    return catmull_rom(m_sphere_keys.at(sphere), frame, [](const SphereKeyframe &key) { return key.center; });
+}
+
+bool Animation::apply(double frame, HittableList &world) const {
+    if (m_sphere_keys.empty())
+        return true;
+
+    for (const auto &[index, keys] : m_sphere_keys) {
+        auto sphere = index < world.objects.size() ? dynamic_cast<Sphere *>(world.objects[index].get()) : nullptr;
+        if (sphere == nullptr)
+            return false;
+
+        sphere->set_center(sphere_center_at(index, frame));
+    }
+
+    world.refit_acceleration();
+    return true;
+}
+
+FrameWriter::FrameWriter(const Denoiser *denoiser) : m_denoiser{denoiser}, m_thread{[this]() { run(); }} {}
+
+void FrameWriter::submit(SampleBuffer &samples, std::string filename, ImageFormat format) {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_changed.wait(lock, [this]() { return !m_has_frame; });
+
+    std::swap(m_samples, samples);
+    m_filename = std::move(filename);
+    m_format = format;
+    m_has_frame = true;
+
+    m_changed.notify_all();
+}
+
+bool FrameWriter::finish() {
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+
+    m_changed.notify_all();
+
+    if (m_thread.joinable())
+        m_thread.join();
+
+    return !m_failed;
+}
+
+void FrameWriter::run() {
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    while (true) {
+        m_changed.wait(lock, [this]() { return m_has_frame || m_stop; });
+
+        if (!m_has_frame)
+            return;
+
+        // O quadro é convertido e gravado fora da trava; submit() só toca m_samples depois que m_has_frame volta a ser falso
+        lock.unlock();
+
+        if (m_denoiser != nullptr)
+            m_denoiser->apply(m_samples, m_framebuffer);
+        else
+            m_samples.resolve(m_framebuffer);
+
+        bool written = m_framebuffer.write(m_filename.c_str(), m_format);
+
+        if (!written)
+            std::cerr << "[ERRO] não foi possível escrever o arquivo " << m_filename << std::endl;
+
+        lock.lock();
+        m_failed = m_failed || !written;
+        m_has_frame = false;
+        m_changed.notify_all();
+    }
+}
+
+std::string frame_filename(const std::string &pattern, int frame) {
+    auto last = pattern.find_last_of('#');
+
+    if (last == std::string::npos) {
+        char number[16];
+        std::snprintf(number, sizeof(number), "_%04d", frame);
+
+        // Apenas um ponto no nome do arquivo (e não em um diretório) indica a extensão
+        auto dot = pattern.find_last_of('.');
+        auto slash = pattern.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            dot = pattern.size();
+
+        return pattern.substr(0, dot) + number + pattern.substr(dot);
+    }
+
+    auto first = pattern.find_last_not_of('#', last);
+    first = (first == std::string::npos) ? 0 : first + 1;
+
+    auto number = std::to_string(frame);
+    if (number.size() < last + 1 - first)
+        number.insert(0, last + 1 - first - number.size(), '0');
+
+    return pattern.substr(0, first) + number + pattern.substr(last + 1);
+}
+
+bool render_animation(Render &render, HittableList &world, const Animation &animation, int first_frame, int last_frame,
+                      const std::string &filename_pattern, ImageFormat format) {
+    auto seed = render.seed();
+
+    // O filtro de ruído roda na thread de escrita, sem a ThreadPool, que já está renderizando o próximo quadro
+    FrameWriter writer{render.denoiser()};
+    SampleBuffer samples;
+
+    for (int frame = first_frame; frame <= last_frame; ++frame) {
+        if (animation.has_camera())
+            render.set_camera(animation.camera_at(frame));
+
+        if (!animation.apply(frame, world)) {
+            std::cerr << "[ERRO] a animação move uma esfera que não existe na cena" << std::endl;
+            return false;
+        }
+
+        render.set_seed(Random::mix_bits(seed ^ std::uint64_t(frame)));
+        std::clog << "Quadro " << frame << " (" << frame - first_frame + 1 << " de " << last_frame - first_frame + 1 << ")" << std::endl;
+
+        // O buffer devolvido pelo writer ainda tem as amostras de um quadro anterior
+        samples.resize(render.image_width(), render.image_height());
+        while (!render.render(world, samples)) {}
+
+        writer.submit(samples, frame_filename(filename_pattern, frame), format);
+    }
+
+    render.set_seed(seed);
+
+    if (!writer.finish())
+        return false;
+
+    std::clog << "Concluído" << std::endl;
+    return render.write_stats();
+}
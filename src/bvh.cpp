@@ -0,0 +1,499 @@
+#include <algorithm>
+#include <future>
+#include <thread>
+
+#include "../lib/bvh.hpp"
+#include "../lib/render_stats.hpp"
+
+namespace {
+
+    // Quantidade de "bins" por eixo na avaliação da SAH. Avaliar todas as posições de divisão possíveis
+    // custaria O(N log N) por nó; com bins o custo é O(N) e a qualidade da árvore é praticamente a mesma.
+    constexpr int SAH_BIN_COUNT = 16;
+
+    // Custos relativos usados pela SAH: atravessar um nó interno vs testar uma primitiva
+    constexpr double TRAVERSAL_COST = 1.0;
+    constexpr double INTERSECTION_COST = 1.0;
+
+    constexpr std::uint32_t MAX_LEAF_PRIMITIVES = 8;
+
+    // A partir dessa profundidade a SAH é abandonada e as primitivas são divididas pela mediana, o que
+    // limita a altura da árvore (e a pilha da travessia) mesmo para distribuições muito degeneradas
+    constexpr int MAX_SAH_DEPTH = 64;
+
+    // As divisões por mediana somam no máximo 32 níveis com índices de 32 bits
+    static_assert(std::size_t(MAX_SAH_DEPTH) + 32 < BVH_STACK_SIZE, "a pilha da travessia não comporta a altura da BVH");
+
+    // Subárvores menores que isso não compensam o custo de criar uma thread
+    constexpr std::uint32_t PARALLEL_BUILD_MIN_PRIMITIVES = 16384;
+
+    struct BuildContext {
+        const std::vector<AABB> &bounds;
+        std::vector<Point3> centroids;
+        std::vector<std::uint32_t> &order;
+        int max_parallel_depth;
+    };
+
+    struct Bin {
+        AABB bounds;
+        std::uint32_t count{0};
+    };
+
+    int bin_index(double centroid, double min, double scale) {
+        int index = int((centroid - min) * scale);
+        return std::clamp(index, 0, SAH_BIN_COUNT - 1);
+    }
+
+    // Constrói a subárvore das primitivas order[begin, end) acrescentando os nós, em ordem de busca em
+    // profundidade, ao final de nodes. Os índices de filhos são relativos ao início de nodes.
+    void build_range(BuildContext &context, std::uint32_t begin, std::uint32_t end, int depth, std::vector<BVHNode> &nodes) {
+        auto node_index = nodes.size();
+        nodes.emplace_back();
+
+        AABB node_bounds;
+        AABB centroid_bounds;
+        for (auto k = begin; k < end; ++k) {
+            node_bounds.expand(context.bounds[context.order[k]]);
+            centroid_bounds.expand(context.centroids[context.order[k]]);
+        }
+
+        auto count = end - begin;
+
+        auto make_leaf = [&]() {
+            nodes[node_index].bounds = node_bounds;
+            nodes[node_index].offset = begin;
+            nodes[node_index].primitive_count = std::uint16_t(count);
+            nodes[node_index].split_axis = 0;
+        };
+
+        if (count <= 1) {
+            make_leaf();
+            return;
+        }
+
+        // Avalia a SAH em cada eixo: para cada fronteira entre bins, custo = área(esq) * N(esq) + área(dir) * N(dir)
+        int best_axis = -1;
+        int best_split = 0;
+        double best_cost = Utility::INFTY;
+
+        for (int axis = 0; axis < 3 && depth < MAX_SAH_DEPTH; ++axis) {
+            double axis_min = centroid_bounds.min()[axis];
+            double extent = centroid_bounds.max()[axis] - axis_min;
+
+            if (extent <= 0.0)
+                continue;
+
+            double scale = SAH_BIN_COUNT / extent;
+            Bin bins[SAH_BIN_COUNT];
+
+            for (auto k = begin; k < end; ++k) {
+                auto primitive = context.order[k];
+                auto &bin = bins[bin_index(context.centroids[primitive][axis], axis_min, scale)];
+                bin.bounds.expand(context.bounds[primitive]);
+                ++bin.count;
+            }
+
+            // Varredura da direita para a esquerda acumulando o lado direito de cada fronteira
+            double right_cost[SAH_BIN_COUNT - 1];
+            AABB right_bounds;
+            std::uint32_t right_count = 0;
+            for (int split = SAH_BIN_COUNT - 1; split > 0; --split) {
+                right_bounds.expand(bins[split].bounds);
+                right_count += bins[split].count;
+                right_cost[split - 1] = right_bounds.surface_area() * right_count;
+            }
+
+            AABB left_bounds;
+            std::uint32_t left_count = 0;
+            for (int split = 0; split < SAH_BIN_COUNT - 1; ++split) {
+                left_bounds.expand(bins[split].bounds);
+                left_count += bins[split].count;
+
+                double cost = left_bounds.surface_area() * left_count + right_cost[split];
+                if (left_count > 0 && left_count < count && cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_split = split;
+                }
+            }
+        }
+
+        double leaf_cost = INTERSECTION_COST * count;
+        double split_cost = TRAVERSAL_COST + INTERSECTION_COST * best_cost / node_bounds.surface_area();
+
+        std::uint32_t middle = begin;
+
+        if (best_axis >= 0) {
+            // Se dividir não compensa e a folha cabe no limite, a folha é a melhor opção
+            if (count <= MAX_LEAF_PRIMITIVES && leaf_cost <= split_cost) {
+                make_leaf();
+                return;
+            }
+
+            double axis_min = centroid_bounds.min()[best_axis];
+            double scale = SAH_BIN_COUNT / (centroid_bounds.max()[best_axis] - axis_min);
+
+            auto split_point = std::partition(context.order.begin() + begin, context.order.begin() + end, [&](std::uint32_t primitive) {
+                return bin_index(context.centroids[primitive][best_axis], axis_min, scale) <= best_split;
+            });
+
+            middle = std::uint32_t(split_point - context.order.begin());
+        }
+        else {
+            // Todos os centróides coincidem ou a árvore já está profunda demais para a SAH
+            if (count <= MAX_LEAF_PRIMITIVES) {
+                make_leaf();
+                return;
+            }
+
+            best_axis = centroid_bounds.longest_axis();
+            middle = begin + count / 2;
+
+            std::nth_element(context.order.begin() + begin, context.order.begin() + middle, context.order.begin() + end,
+                             [&](std::uint32_t a, std::uint32_t b) {
+                                 return context.centroids[a][best_axis] < context.centroids[b][best_axis];
+                             });
+        }
+
+        nodes[node_index].bounds = node_bounds;
+        nodes[node_index].primitive_count = 0;
+        nodes[node_index].split_axis = std::uint8_t(best_axis);
+
+        std::uint32_t right_child;
+
+        if (depth < context.max_parallel_depth && count >= PARALLEL_BUILD_MIN_PRIMITIVES) {
+            // O lado direito é construído em outra thread em um vetor próprio e depois anexado; como os
+            // dois lados ocupam trechos disjuntos de order, não há disputa entre as threads.
+            std::vector<BVHNode> right_nodes;
+            auto right_build = std::async(std::launch::async, [&]() {
+                build_range(context, middle, end, depth + 1, right_nodes);
+            });
+
+            build_range(context, begin, middle, depth + 1, nodes);
+            right_build.get();
+
+            right_child = std::uint32_t(nodes.size());
+            for (auto node : right_nodes) {
+                if (!node.is_leaf())
+                    node.offset += right_child;
+
+                nodes.push_back(node);
+            }
+        }
+        else {
+            build_range(context, begin, middle, depth + 1, nodes);
+            right_child = std::uint32_t(nodes.size());
+            build_range(context, middle, end, depth + 1, nodes);
+        }
+
+        nodes[node_index].offset = right_child;
+    }
+
+} // namespace
+
+std::vector<BVHNode> build_bvh(const std::vector<AABB> &primitive_bounds, std::vector<std::uint32_t> &primitive_order) {
+    auto primitive_count = std::uint32_t(primitive_bounds.size());
+
+    primitive_order.resize(primitive_count);
+    for (std::uint32_t k = 0; k < primitive_count; ++k)
+        primitive_order[k] = k;
+
+    std::vector<BVHNode> nodes;
+    if (primitive_count == 0)
+        return nodes;
+
+    // Cada nível de paralelismo dobra o número de threads: log2(threads de hardware) níveis bastam
+    int max_parallel_depth = 0;
+    for (auto threads = std::thread::hardware_concurrency(); threads > 1; threads /= 2)
+        ++max_parallel_depth;
+
+    BuildContext context{primitive_bounds, {}, primitive_order, max_parallel_depth};
+    context.centroids.reserve(primitive_count);
+    for (const auto &box : primitive_bounds)
+        context.centroids.push_back(box.centroid());
+
+    // Uma árvore binária com folhas de pelo menos uma primitiva tem no máximo 2N - 1 nós
+    nodes.reserve(2 * std::size_t(primitive_count) - 1);
+    build_range(context, 0, primitive_count, 0, nodes);
+
+    return nodes;
+}
+
+bool valid_bvh_nodes(const BVHNode *nodes, std::size_t node_count, std::uint64_t primitive_count) {
+    // Distância de cada nó até a raiz. Os filhos sempre vêm depois do pai, então a de um nó já é a final
+    // quando ele é visitado; um nó com dois pais (o que a construção não gera) fica com a maior delas.
+    std::vector<std::uint8_t> depth(node_count, 0);
+
+    for (std::size_t k = 0; k < node_count; ++k) {
+        const auto &node = nodes[k];
+
+        if (node.is_leaf()) {
+            if (std::uint64_t(node.offset) + node.primitive_count > primitive_count)
+                return false;
+            continue;
+        }
+
+        if (node.offset <= k || node.offset >= node_count || k + 1 >= node_count || node.split_axis >= 3
+            || depth[k] >= BVH_STACK_SIZE)
+            return false;
+
+        auto child_depth = std::uint8_t(depth[k] + 1);
+        depth[k + 1] = std::max(depth[k + 1], child_depth);
+        depth[node.offset] = std::max(depth[node.offset], child_depth);
+    }
+
+    return true;
+}
+
+BVH::BVH(const std::vector<std::shared_ptr<Hittable>> &objects) {
+    std::vector<AABB> bounds;
+    bounds.reserve(objects.size());
+
+    for (const auto &object : objects)
+        bounds.push_back(object->bounding_box());
+
+    m_nodes = build_bvh(bounds, m_primitive_order);
+
+    std::vector<std::shared_ptr<Hittable>> ordered_objects;
+    ordered_objects.reserve(objects.size());
+    for (auto index : m_primitive_order)
+        ordered_objects.push_back(objects[index]);
+
+    if (!m_spheres.add_if_all_spheres(ordered_objects))
+        m_objects = std::move(ordered_objects);
+}
+
+bool BVH::refit(const std::vector<std::shared_ptr<Hittable>> &objects) {
+    if (objects.size() != m_primitive_order.size())
+        return false;
+
+    // m_objects guarda os próprios objetos, que já estão nas novas posições; as esferas foram copiadas
+    if (m_objects.empty()) {
+        for (std::size_t k = 0; k < m_primitive_order.size(); ++k) {
+            auto sphere = dynamic_cast<const Sphere *>(objects[m_primitive_order[k]].get());
+            if (sphere == nullptr)
+                return false;
+
+            m_spheres.set_center(k, sphere->center());
+        }
+    }
+
+    // Os filhos sempre ficam depois do pai no vetor, então percorrê-lo de trás para frente atualiza
+    // cada nó depois dos seus filhos
+    for (std::size_t n = m_nodes.size(); n-- > 0;) {
+        auto &node = m_nodes[n];
+
+        if (!node.is_leaf()) {
+            node.bounds = m_nodes[n + 1].bounds;
+            node.bounds.expand(m_nodes[node.offset].bounds);
+            continue;
+        }
+
+        node.bounds = AABB{};
+        for (std::uint32_t k = node.offset; k < node.offset + node.primitive_count; ++k)
+            node.bounds.expand(m_objects.empty() ? m_spheres.sphere_bounds(k) : m_objects[k]->bounding_box());
+    }
+
+    return true;
+}
+
+bool BVH::hit(const Ray &r, Interval acceptable_t_interval, HitRecord &h_rec) const {
+    if (m_nodes.empty())
+        return false;
+
+    const auto &origin = r.origin();
+    const auto &direction = r.direction();
+    Vec3 inverse_direction{1.0 / direction.x(), 1.0 / direction.y(), 1.0 / direction.z()};
+    bool direction_is_negative[3] = {direction.x() < 0, direction.y() < 0, direction.z() < 0};
+
+    bool hit_anything = false;
+    auto closest_so_far = acceptable_t_interval.max();
+
+    // Contados em variáveis locais e somados às estatísticas da thread uma única vez, no fim
+    std::uint64_t box_tests = 0;
+    std::uint64_t primitive_tests = 0;
+
+    // Pilha explícita de nós a visitar. A construção limita a altura da árvore a MAX_SAH_DEPTH níveis
+    // mais as divisões por mediana (no máximo 32 com índices de 32 bits), e valid_bvh_nodes rejeita as
+    // árvores mais altas lidas de arquivos
+    std::uint32_t stack[BVH_STACK_SIZE];
+    int stack_size = 0;
+    std::uint32_t current = 0;
+
+    while (true) {
+        const auto &node = m_nodes[current];
+        ++box_tests;
+
+        if (node.bounds.hit(origin, inverse_direction, acceptable_t_interval.min(), closest_so_far)) {
+            if (node.is_leaf()) {
+                primitive_tests += node.primitive_count;
+
+                if (m_spheres.size() > 0) {
+                    if (m_spheres.hit_range(r, node.offset, node.primitive_count, Interval(acceptable_t_interval.min(), closest_so_far), h_rec)) {
+                        hit_anything = true;
+                        closest_so_far = h_rec.t;
+                    }
+                }
+                else {
+                    for (std::uint32_t k = node.offset; k < node.offset + node.primitive_count; ++k) {
+                        if (m_objects[k]->hit(r, Interval(acceptable_t_interval.min(), closest_so_far), h_rec)) {
+                            hit_anything = true;
+                            closest_so_far = h_rec.t;
+                        }
+                    }
+                }
+            }
+            else {
+                // Visita primeiro o filho mais próximo da origem do raio; assim closest_so_far diminui
+                // cedo e mais caixas do outro filho são descartadas
+                if (direction_is_negative[node.split_axis]) {
+                    stack[stack_size++] = current + 1;
+                    current = node.offset;
+                }
+                else {
+                    stack[stack_size++] = node.offset;
+                    current = current + 1;
+                }
+
+                continue;
+            }
+        }
+
+        if (stack_size == 0)
+            break;
+
+        current = stack[--stack_size];
+    }
+
+    Stats::t_counters.box_tests += box_tests;
+    Stats::t_counters.primitive_tests += primitive_tests;
+
+    return hit_anything;
+}
+
+void BVH::hit_packet(const RayPacket &packet, Interval acceptable_t_interval, HitRecord *h_recs, bool *hits) const {
+    const int size = packet.size;
+    const double t_min = acceptable_t_interval.min();
+
+    double inverse_x[RayPacket::MAX_SIZE];
+    double inverse_y[RayPacket::MAX_SIZE];
+    double inverse_z[RayPacket::MAX_SIZE];
+    double t_max[RayPacket::MAX_SIZE];
+    long closest_sphere[RayPacket::MAX_SIZE];
+
+    for (int k = 0; k < size; ++k) {
+        inverse_x[k] = 1.0 / packet.direction_x[k];
+        inverse_y[k] = 1.0 / packet.direction_y[k];
+        inverse_z[k] = 1.0 / packet.direction_z[k];
+        t_max[k] = acceptable_t_interval.max();
+        closest_sphere[k] = -1;
+        hits[k] = false;
+    }
+
+    if (m_nodes.empty() || size == 0)
+        return;
+
+    // A ordem de visita dos filhos segue o primeiro raio; para raios coerentes é a mesma para todos
+    bool direction_is_negative[3] = {packet.direction_x[0] < 0, packet.direction_y[0] < 0, packet.direction_z[0] < 0};
+
+    std::uint64_t box_tests = 0;
+    std::uint64_t primitive_tests = 0;
+
+    std::uint32_t stack[BVH_STACK_SIZE];
+    int stack_size = 0;
+    std::uint32_t current = 0;
+
+    while (true) {
+        const auto &node = m_nodes[current];
+        const auto &box_min = node.bounds.min();
+        const auto &box_max = node.bounds.max();
+
+        // Mesmo teste "slab" de AABB::hit, para todos os raios do pacote de uma vez
+        bool box_hit[RayPacket::MAX_SIZE];
+        bool any_hit = false;
+
+        for (int k = 0; k < size; ++k) {
+            double entry = t_min;
+            double exit = t_max[k];
+
+            double tx0 = (box_min.x() - packet.origin_x[k]) * inverse_x[k];
+            double tx1 = (box_max.x() - packet.origin_x[k]) * inverse_x[k];
+            double near_x = inverse_x[k] < 0.0 ? tx1 : tx0;
+            double far_x = inverse_x[k] < 0.0 ? tx0 : tx1;
+            entry = near_x > entry ? near_x : entry;
+            exit = far_x < exit ? far_x : exit;
+
+            double ty0 = (box_min.y() - packet.origin_y[k]) * inverse_y[k];
+            double ty1 = (box_max.y() - packet.origin_y[k]) * inverse_y[k];
+            double near_y = inverse_y[k] < 0.0 ? ty1 : ty0;
+            double far_y = inverse_y[k] < 0.0 ? ty0 : ty1;
+            entry = near_y > entry ? near_y : entry;
+            exit = far_y < exit ? far_y : exit;
+
+            double tz0 = (box_min.z() - packet.origin_z[k]) * inverse_z[k];
+            double tz1 = (box_max.z() - packet.origin_z[k]) * inverse_z[k];
+            double near_z = inverse_z[k] < 0.0 ? tz1 : tz0;
+            double far_z = inverse_z[k] < 0.0 ? tz0 : tz1;
+            entry = near_z > entry ? near_z : entry;
+            exit = far_z < exit ? far_z : exit;
+
+            box_hit[k] = !(exit < entry);
+            any_hit |= box_hit[k];
+        }
+
+        box_tests += std::uint64_t(size);
+
+        if (any_hit) {
+            if (node.is_leaf()) {
+                primitive_tests += std::uint64_t(node.primitive_count) * size;
+
+                if (m_spheres.size() > 0) {
+                    m_spheres.hit_range_packet(packet, node.offset, node.primitive_count, t_min, t_max, closest_sphere);
+                }
+                else {
+                    for (int k = 0; k < size; ++k) {
+                        if (!box_hit[k])
+                            continue;
+
+                        auto r = packet.ray(k);
+                        for (std::uint32_t p = node.offset; p < node.offset + node.primitive_count; ++p) {
+                            if (m_objects[p]->hit(r, Interval(t_min, t_max[k]), h_recs[k])) {
+                                hits[k] = true;
+                                t_max[k] = h_recs[k].t;
+                            }
+                        }
+                    }
+                }
+            }
+            else {
+                if (direction_is_negative[node.split_axis]) {
+                    stack[stack_size++] = current + 1;
+                    current = node.offset;
+                }
+                else {
+                    stack[stack_size++] = node.offset;
+                    current = current + 1;
+                }
+
+                continue;
+            }
+        }
+
+        if (stack_size == 0)
+            break;
+
+        current = stack[--stack_size];
+    }
+
+    Stats::t_counters.box_tests += box_tests;
+    Stats::t_counters.primitive_tests += primitive_tests;
+
+    if (m_spheres.size() > 0) {
+        for (int k = 0; k < size; ++k) {
+            hits[k] = closest_sphere[k] >= 0;
+
+            if (hits[k])
+                m_spheres.fill_record(packet.ray(k), std::size_t(closest_sphere[k]), t_max[k], h_recs[k]);
+        }
+    }
+}
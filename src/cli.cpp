@@ -0,0 +1,267 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "../lib/cli.hpp"
+
+// Converte o texto em inteiro positivo, rejeitando qualquer caractere que não seja dígito
+static bool parse_positive_int(const char *text, int &value) {
+    char *end = nullptr;
+    long parsed = std::strtol(text, &end, 10);
+
+    if (end == text || *end != '\0' || parsed <= 0 || parsed > 1 << 20)
+        return false;
+
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+static bool parse_unsigned(const char *text, std::uint64_t &value) {
+    char *end = nullptr;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+
+    if (end == text || *end != '\0' || *text == '-')
+        return false;
+
+    value = static_cast<std::uint64_t>(parsed);
+    return true;
+}
+
+static bool parse_positive_double(const char *text, double &value) {
+    char *end = nullptr;
+    double parsed = std::strtod(text, &end);
+
+    if (end == text || *end != '\0' || !(parsed > 0.0))
+        return false;
+
+    value = parsed;
+    return true;
+}
+
+static bool parse_sampler(const char *name, SamplerType &type) {
+    if (std::strcmp(name, "independent") == 0)
+        type = SamplerType::INDEPENDENT;
+    else if (std::strcmp(name, "sobol") == 0)
+        type = SamplerType::SOBOL;
+    else if (std::strcmp(name, "blue-noise") == 0)
+        type = SamplerType::BLUE_NOISE;
+    else
+        return false;
+
+    return true;
+}
+
+static bool parse_integrator(const char *name, Integrator &integrator) {
+    if (std::strcmp(name, "megakernel") == 0)
+        integrator = Integrator::MEGAKERNEL;
+    else if (std::strcmp(name, "wavefront") == 0)
+        integrator = Integrator::WAVEFRONT;
+    else
+        return false;
+
+    return true;
+}
+
+// Intervalo no formato "A-B", com 0 <= A <= B
+static bool parse_range(const char *text, int &first, int &second) {
+    char *separator = nullptr;
+    long parsed_first = std::strtol(text, &separator, 10);
+
+    if (separator == text || *separator != '-' || parsed_first < 0)
+        return false;
+
+    char *rest = nullptr;
+    long parsed_end = std::strtol(separator + 1, &rest, 10);
+
+    if (rest == separator + 1 || *rest != '\0' || parsed_end < parsed_first || parsed_end > 1 << 30)
+        return false;
+
+    first = static_cast<int>(parsed_first);
+    second = static_cast<int>(parsed_end);
+    return true;
+}
+
+bool parse_cli_options(int argc, char *argv[], CliOptions &options) {
+    for (int arg = 1; arg < argc; ++arg) {
+
+        // Opções sem valor
+        if (std::strcmp(argv[arg], "--resume") == 0) {
+            options.resume = true;
+            continue;
+        }
+
+        if (std::strcmp(argv[arg], "--worker") == 0) {
+            options.worker = true;
+            continue;
+        }
+
+        if (std::strcmp(argv[arg], "--denoise") == 0) {
+            options.denoise = true;
+            continue;
+        }
+
+        if (std::strcmp(argv[arg], "--sort-rays") == 0) {
+            options.sort_rays = true;
+            continue;
+        }
+
+        // As demais opções esperam exatamente um valor logo em seguida
+        if (arg + 1 >= argc)
+            return false;
+
+        const char *value = argv[arg + 1];
+
+        if (std::strcmp(argv[arg], "--output") == 0)
+            options.output_filename = value;
+
+        else if (std::strcmp(argv[arg], "--threads") == 0) {
+            if (!parse_positive_int(value, options.thread_count))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--seed") == 0) {
+            if (!parse_unsigned(value, options.seed))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--sampler") == 0) {
+            if (!parse_sampler(value, options.sampler))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--packets") == 0) {
+            if (!parse_positive_int(value, options.packet_size))
+                return false;
+
+            if (options.packet_size != 4 && options.packet_size != 8 && options.packet_size != 16)
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--integrator") == 0) {
+            if (!parse_integrator(value, options.integrator))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--spp") == 0) {
+            if (!parse_positive_int(value, options.samples_per_pixel))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--min-spp") == 0) {
+            if (!parse_positive_int(value, options.min_samples_per_pixel))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--adaptive") == 0) {
+            if (!parse_positive_double(value, options.adaptive_error_threshold))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--sample-map") == 0)
+            options.sample_map_filename = value;
+
+        else if (std::strcmp(argv[arg], "--stats") == 0)
+            options.stats_filename = value;
+
+        else if (std::strcmp(argv[arg], "--workers") == 0) {
+            if (!parse_positive_int(value, options.worker_count))
+                return false;
+        }
+
+        // Tiles de A até B - 1
+        else if (std::strcmp(argv[arg], "--tiles") == 0) {
+            if (!parse_range(value, options.first_tile, options.end_tile) || options.end_tile == options.first_tile)
+                return false;
+        }
+
+        // Quadros de A até B
+        else if (std::strcmp(argv[arg], "--frames") == 0) {
+            if (!parse_range(value, options.first_frame, options.last_frame))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--merge") == 0)
+            options.merge_filenames.push_back(value);
+
+        else if (std::strcmp(argv[arg], "--scene") == 0)
+            options.scene_filename = value;
+
+        else if (std::strcmp(argv[arg], "--environment") == 0)
+            options.environment_filename = value;
+
+        else if (std::strcmp(argv[arg], "--compile") == 0)
+            options.compile_filename = value;
+
+        else if (std::strcmp(argv[arg], "--mesh") == 0)
+            options.mesh_filename = value;
+
+        else if (std::strcmp(argv[arg], "--checkpoint") == 0)
+            options.checkpoint_filename = value;
+
+        else if (std::strcmp(argv[arg], "--pass-spp") == 0) {
+            if (!parse_positive_int(value, options.samples_per_pass))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--roulette-depth") == 0) {
+            if (!parse_positive_int(value, options.roulette_min_depth))
+                return false;
+        }
+
+        else if (std::strcmp(argv[arg], "--format") == 0) {
+            if (!parse_image_format(value, options.format))
+                return false;
+
+            options.has_format = true;
+        }
+
+        else
+            return false;
+
+        ++arg;
+    }
+
+    // Compilar uma cena ou malha não renderiza nada, então não exige --output
+    if (options.compile_filename != nullptr)
+        return (options.scene_filename != nullptr) != (options.mesh_filename != nullptr);
+
+    if (options.mesh_filename != nullptr)
+        return false;
+
+    // Os modos de renderização distribuída não se combinam entre si nem com os checkpoints
+    bool has_tiles = options.first_tile >= 0;
+    int distributed_modes = int(options.worker) + int(options.worker_count > 0) + int(has_tiles) + int(!options.merge_filenames.empty());
+
+    if (distributed_modes > 1 || (distributed_modes > 0 && options.checkpoint_filename != nullptr))
+        return false;
+
+    // Os checkpoints e o mapa de amostras são de uma única imagem
+    bool has_frames = options.first_frame >= 0;
+    if (has_frames && (distributed_modes > 0 || options.checkpoint_filename != nullptr || options.sample_map_filename != nullptr))
+        return false;
+
+    // O worker devolve os tiles pela saída padrão
+    if (options.worker)
+        return true;
+
+    if (options.output_filename == nullptr)
+        return false;
+
+    // Continuar só faz sentido a partir de um checkpoint
+    if (options.resume && options.checkpoint_filename == nullptr)
+        return false;
+
+    if (!options.has_format)
+        options.format = image_format_from_filename(options.output_filename);
+
+    return true;
+}
+
+void print_usage(std::ostream &out, const char *program_name) {
+    out << "[ERRO] Uso: " << program_name << " --output arquivo.ppm [--scene cena.txt] [--environment mapa.pfm] [--threads N] [--seed N] [--sampler independent|sobol|blue-noise] [--format p6|p3|pfm] [--packets 4|8|16] [--integrator megakernel|wavefront] [--sort-rays] [--roulette-depth N]"
+        << " [--spp N] [--adaptive ERRO] [--min-spp N] [--sample-map arquivo] [--denoise] [--stats arquivo.json]"
+        << " [--checkpoint arquivo [--pass-spp N] [--resume]] [--workers N | --tiles A-B]" << std::endl
+        << "       " << program_name << " --scene cena.txt --frames A-B --output quadro_####.ppm [opções da renderização]" << std::endl
+        << "       " << program_name << " --merge parcial1 --merge parcial2 ... --output arquivo.ppm" << std::endl
+        << "       " << program_name << " --scene cena.txt --compile cena.bin" << std::endl
+        << "       " << program_name << " --mesh malha.obj --compile malha.rtmesh" << std::endl;
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "../lib/denoiser.hpp"
+#include "../lib/utility.hpp"
+
+namespace {
+
+    // Núcleo B-spline cúbico 1D (1/16, 1/4, 3/8, 1/4, 1/16), indexado por |deslocamento|
+    constexpr double KERNEL[3] = {3.0 / 8.0, 1.0 / 4.0, 1.0 / 16.0};
+
+    // Canais de albedo abaixo disso não são divididos (a iluminação de um material preto é a própria cor)
+    constexpr double MIN_ALBEDO = 1e-3;
+
+    // e^-20 ~ 2e-9: vizinhos com peso menor que isso são ignorados, sem calcular o exp()
+    constexpr double MAX_EXPONENT = 20.0;
+
+    // Linhas por tarefa da ThreadPool
+    constexpr int ROWS_PER_TASK = 8;
+
+    double luminance(const Vec3 &color) {
+        return 0.2126 * color.x() + 0.7152 * color.y() + 0.0722 * color.z();
+    }
+
+    // Atributos fixos de cada pixel, lidos a cada passada
+    struct Guide {
+        Vec3 normal;
+        Vec3 albedo;
+        double depth;
+
+        // Quanto a profundidade muda de um pixel para o vizinho nesta região da superfície
+        double depth_slope;
+
+        bool is_sky;
+    };
+
+    // Executa rows(first_row, end_row) sobre toda a imagem, dividida entre as threads de pool
+    void for_each_row_band(int height, ThreadPool *pool, const std::function<void(int, int)> &rows) {
+        if (pool == nullptr) {
+            rows(0, height);
+            return;
+        }
+
+        int task_count = (height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+        pool->run(task_count, [&](int task, int) {
+            rows(task * ROWS_PER_TASK, std::min(height, (task + 1) * ROWS_PER_TASK));
+        });
+    }
+
+} // namespace
+
+void Denoiser::apply(const SampleBuffer &samples, Framebuffer &framebuffer, ThreadPool *pool) const {
+    int width = samples.width();
+    int height = samples.height();
+    auto pixel_count = std::size_t(width) * height;
+
+    framebuffer.resize(width, height);
+
+    std::vector<Guide> guides(pixel_count);
+    std::vector<Vec3> illumination(pixel_count), filtered(pixel_count);
+    std::vector<double> variance(pixel_count), filtered_variance(pixel_count);
+    std::vector<double> illumination_luminance(pixel_count);
+
+    // Cada canal da cor é dividido pelo do albedo (quando não é quase zero); a variância da luminância
+    // é convertida com o mesmo fator
+    auto demodulation = [](const Vec3 &albedo) {
+        return Vec3{albedo.x() > MIN_ALBEDO ? albedo.x() : 1.0, albedo.y() > MIN_ALBEDO ? albedo.y() : 1.0,
+                    albedo.z() > MIN_ALBEDO ? albedo.z() : 1.0};
+    };
+
+    for_each_row_band(height, pool, [&](int first_row, int end_row) {
+        for (int j = first_row; j < end_row; ++j) {
+            for (int i = 0; i < width; ++i) {
+                const auto &estimate = samples.pixel(i, j);
+                auto k = std::size_t(j) * width + i;
+                auto factor = demodulation(estimate.albedo());
+
+                guides[k] = Guide{estimate.normal(), estimate.albedo(), estimate.depth(), 0.0, estimate.normal().squared_length() < 1e-6};
+                illumination[k] = Vec3{estimate.mean().x() / factor.x(), estimate.mean().y() / factor.y(), estimate.mean().z() / factor.z()};
+                variance[k] = estimate.variance_of_mean() / std::max(luminance(factor) * luminance(factor), 1e-6);
+            }
+        }
+    });
+
+    // A variação esperada da profundidade vem da menor diferença para os vizinhos de cada eixo: em
+    // uma superfície inclinada ela é grande nos dois lados, mas na borda de um objeto só de um lado
+    for_each_row_band(height, pool, [&](int first_row, int end_row) {
+        for (int j = first_row; j < end_row; ++j) {
+            for (int i = 0; i < width; ++i) {
+                auto k = std::size_t(j) * width + i;
+                auto depth = guides[k].depth;
+
+                auto axis_slope = [&](int previous, int next, bool has_previous, bool has_next) {
+                    double slope = HUGE_VAL;
+                    if (has_previous)
+                        slope = std::fabs(depth - guides[std::size_t(previous)].depth);
+                    if (has_next)
+                        slope = std::min(slope, std::fabs(guides[std::size_t(next)].depth - depth));
+                    return slope == HUGE_VAL ? 0.0 : slope;
+                };
+
+                auto slope_i = axis_slope(int(k) - 1, int(k) + 1, i > 0, i + 1 < width);
+                auto slope_j = axis_slope(int(k) - width, int(k) + width, j > 0, j + 1 < height);
+                guides[k].depth_slope = std::sqrt(slope_i * slope_i + slope_j * slope_j);
+            }
+        }
+    });
+
+    // Distância entre o centro e cada ponto do núcleo, em passos
+    double kernel_distance[5][5];
+    for (int dj = -2; dj <= 2; ++dj)
+        for (int di = -2; di <= 2; ++di)
+            kernel_distance[dj + 2][di + 2] = std::sqrt(double(di * di + dj * dj));
+
+    for (int iteration = 0; iteration < ITERATIONS; ++iteration) {
+        int step = 1 << iteration;
+
+        for (std::size_t k = 0; k < pixel_count; ++k)
+            illumination_luminance[k] = luminance(illumination[k]);
+
+        for_each_row_band(height, pool, [&](int first_row, int end_row) {
+            for (int j = first_row; j < end_row; ++j) {
+                for (int i = 0; i < width; ++i) {
+                    auto p = std::size_t(j) * width + i;
+                    const auto &guide = guides[p];
+
+                    // Desvio padrão do pixel a partir da variância suavizada em 3x3: a estimativa de um
+                    // único pixel com poucas amostras é ruidosa demais para decidir sozinha
+                    double smoothed_variance = 0.0, smoothing_weight = 0.0;
+                    for (int dj = -1; dj <= 1; ++dj) {
+                        for (int di = -1; di <= 1; ++di) {
+                            int ni = i + di, nj = j + dj;
+                            if (ni < 0 || ni >= width || nj < 0 || nj >= height)
+                                continue;
+
+                            double weight = (di == 0 ? 2.0 : 1.0) * (dj == 0 ? 2.0 : 1.0);
+                            smoothed_variance += weight * variance[std::size_t(nj) * width + ni];
+                            smoothing_weight += weight;
+                        }
+                    }
+
+                    double luminance_scale = 1.0 / (LUMINANCE_SIGMA * std::sqrt(smoothed_variance / smoothing_weight) + 1e-10);
+                    double center_luminance = illumination_luminance[p];
+
+                    Vec3 sum{0, 0, 0};
+                    double weight_sum = 0.0, variance_sum = 0.0;
+
+                    for (int dj = -2; dj <= 2; ++dj) {
+                        int nj = j + dj * step;
+                        if (nj < 0 || nj >= height)
+                            continue;
+
+                        for (int di = -2; di <= 2; ++di) {
+                            int ni = i + di * step;
+                            if (ni < 0 || ni >= width)
+                                continue;
+
+                            auto q = std::size_t(nj) * width + ni;
+                            const auto &neighbor = guides[q];
+
+                            double weight = KERNEL[std::abs(di)] * KERNEL[std::abs(dj)];
+
+                            if (q != p) {
+                                double normal_weight = 1.0;
+                                if (!guide.is_sky || !neighbor.is_sky) {
+                                    normal_weight = std::max(0.0, guide.normal * neighbor.normal);
+                                    for (int k = 0; k < NORMAL_POWER_SQUARINGS; ++k)
+                                        normal_weight *= normal_weight;
+                                }
+
+                                double distance = step * kernel_distance[dj + 2][di + 2];
+                                double depth_tolerance = DEPTH_SIGMA * guide.depth_slope * distance + 1e-3 * std::max(guide.depth, neighbor.depth) + 1e-12;
+
+                                // Um único exp() para os três termos; acima de MAX_EXPONENT o peso é desprezível
+                                double exponent = std::fabs(guide.depth - neighbor.depth) / depth_tolerance
+                                                  + std::fabs(center_luminance - illumination_luminance[q]) * luminance_scale
+                                                  + (guide.albedo - neighbor.albedo).squared_length() / (ALBEDO_SIGMA * ALBEDO_SIGMA);
+
+                                if (exponent > MAX_EXPONENT || normal_weight == 0.0)
+                                    continue;
+
+                                weight *= normal_weight * std::exp(-exponent);
+                            }
+
+                            sum += weight * illumination[q];
+                            weight_sum += weight;
+                            variance_sum += weight * weight * variance[q];
+                        }
+                    }
+
+                    // O próprio pixel tem sempre peso positivo, então weight_sum > 0
+                    filtered[p] = sum / weight_sum;
+                    filtered_variance[p] = variance_sum / (weight_sum * weight_sum);
+                }
+            }
+        });
+
+        std::swap(illumination, filtered);
+        std::swap(variance, filtered_variance);
+    }
+
+    for (int j = 0; j < height; ++j) {
+        for (int i = 0; i < width; ++i) {
+            auto k = std::size_t(j) * width + i;
+            framebuffer.set_pixel(i, j, Utility::product_component(illumination[k], demodulation(guides[k].albedo)));
+        }
+    }
+}
@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+
+#include "../lib/distributed.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    // Cabeçalho da resposta do worker, seguido de pixel_count registros
+    struct TileResultHeader {
+        std::uint32_t tile_index;
+        std::uint32_t pixel_count;
+    };
+
+    std::size_t tile_pixel_count(const Tile &tile) {
+        return std::size_t(tile.end_i - tile.start_i) * (tile.end_j - tile.start_j);
+    }
+
+} // namespace
+
+#ifdef _WIN32
+
+bool Distributed::run_worker(Render &, const HittableList &, int, int) {
+    std::cerr << "[ERRO] renderização distribuída não suportada neste sistema" << std::endl;
+    return false;
+}
+
+bool Distributed::spawn_workers(const std::string &, const std::vector<std::string> &, int, std::vector<Worker> &) {
+    std::cerr << "[ERRO] renderização distribuída não suportada neste sistema" << std::endl;
+    return false;
+}
+
+bool Distributed::distribute_tiles(const Render &, std::vector<Worker> &, SampleBuffer &) { return false; }
+bool Distributed::finish_workers(std::vector<Worker> &) { return false; }
+std::string Distributed::current_executable(const char *argv0) { return argv0; }
+
+#else
+
+namespace {
+
+    // Lê exatamente size bytes. Retorna 1 se conseguiu, 0 se a entrada terminou antes do primeiro
+    // byte e -1 em erros (inclusive o fim da entrada no meio da leitura)
+    int read_exact(int fd, void *data, std::size_t size) {
+        auto *bytes = static_cast<unsigned char *>(data);
+        std::size_t done = 0;
+
+        while (done < size) {
+            auto count = ::read(fd, bytes + done, size - done);
+
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                return (count == 0 && done == 0) ? 0 : -1;
+
+            done += std::size_t(count);
+        }
+
+        return 1;
+    }
+
+    bool write_all(int fd, const void *data, std::size_t size) {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+
+        while (size > 0) {
+            auto count = ::write(fd, bytes, size);
+
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                return false;
+
+            bytes += count;
+            size -= std::size_t(count);
+        }
+
+        return true;
+    }
+
+    void close_fd(int &fd) {
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+
+    // Os pipes são criados com FD_CLOEXEC: cada worker herda apenas a sua entrada e saída (ligadas
+    // por dup2, que limpa a flag), e não as pontas dos pipes dos outros workers. Se herdasse, a
+    // entrada de um worker nunca chegaria ao fim enquanto os outros estivessem vivos.
+    bool make_pipe(int fds[2]) {
+        if (::pipe(fds) != 0)
+            return false;
+
+        ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        return true;
+    }
+
+} // namespace
+
+bool Distributed::run_worker(Render &render, const HittableList &world, int input_fd, int output_fd) {
+    auto tiles = render.split_into_tiles();
+
+    SampleBuffer samples;
+    samples.resize(render.image_width(), render.image_height());
+
+    std::vector<unsigned char> message;
+
+    while (true) {
+        std::uint32_t tile_index;
+        int status = read_exact(input_fd, &tile_index, sizeof(tile_index));
+
+        if (status == 0)
+            return true;
+        if (status < 0 || tile_index >= tiles.size())
+            return false;
+
+        const auto &tile = tiles[tile_index];
+        while (!render.render(world, samples, {int(tile_index)})) {}
+
+        TileResultHeader header{tile_index, std::uint32_t(tile_pixel_count(tile))};
+        message.resize(sizeof(header) + header.pixel_count * SampleBuffer::RECORD_SIZE);
+
+        std::memcpy(message.data(), &header, sizeof(header));
+        samples.pack_region(tile.start_i, tile.start_j, tile.end_i, tile.end_j, message.data() + sizeof(header));
+
+        if (!write_all(output_fd, message.data(), message.size()))
+            return false;
+    }
+}
+
+bool Distributed::spawn_workers(const std::string &program, const std::vector<std::string> &arguments, int worker_count,
+                                std::vector<Worker> &workers) {
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(program.c_str()));
+    for (const auto &argument : arguments)
+        argv.push_back(const_cast<char *>(argument.c_str()));
+    argv.push_back(nullptr);
+
+    for (int k = 0; k < worker_count; ++k) {
+        int to_worker[2];
+        int from_worker[2];
+
+        if (!make_pipe(to_worker))
+            return false;
+
+        if (!make_pipe(from_worker)) {
+            ::close(to_worker[0]);
+            ::close(to_worker[1]);
+            return false;
+        }
+
+        auto pid = ::fork();
+
+        if (pid == 0) {
+            ::dup2(to_worker[0], STDIN_FILENO);
+            ::dup2(from_worker[1], STDOUT_FILENO);
+            ::execv(program.c_str(), argv.data());
+            ::_exit(127);
+        }
+
+        ::close(to_worker[0]);
+        ::close(from_worker[1]);
+
+        Worker worker{to_worker[1], from_worker[0], int(pid)};
+        if (pid < 0) {
+            finish_workers(workers);
+            close_fd(worker.to_worker);
+            close_fd(worker.from_worker);
+            return false;
+        }
+
+        workers.push_back(worker);
+    }
+
+    return true;
+}
+
+bool Distributed::distribute_tiles(const Render &render, std::vector<Worker> &workers, SampleBuffer &samples) {
+    auto tiles = render.split_into_tiles();
+    samples.resize(render.image_width(), render.image_height());
+
+    // Um worker que termina com erro fecha o pipe; escrever nele não deve encerrar o coordenador
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::deque<int> pending;
+    for (int k = 0; k < int(tiles.size()); ++k)
+        pending.push_back(k);
+
+    // Tiles entregues a cada worker e ainda sem resposta, e os bytes recebidos ainda não processados
+    struct WorkerState {
+        std::deque<int> outstanding;
+        std::vector<unsigned char> received;
+        bool alive{true};
+    };
+    std::vector<WorkerState> states(workers.size());
+
+    std::size_t finished_tiles = 0;
+    auto last_report = std::chrono::steady_clock::now();
+
+    // Um worker que falha devolve os seus tiles para a fila
+    auto fail = [&](std::size_t w) {
+        auto &state = states[w];
+        pending.insert(pending.begin(), state.outstanding.begin(), state.outstanding.end());
+        state.outstanding.clear();
+        state.alive = false;
+
+        close_fd(workers[w].to_worker);
+        close_fd(workers[w].from_worker);
+        std::cerr << "[AVISO] o processo de renderização " << w << " falhou; os seus tiles serão refeitos" << std::endl;
+    };
+
+    // Completa a fila de cada worker vivo com até PIPELINE_DEPTH tiles
+    auto assign_tiles = [&]() {
+        for (std::size_t w = 0; w < workers.size(); ++w) {
+            while (states[w].alive && workers[w].to_worker >= 0 && !pending.empty()
+                   && int(states[w].outstanding.size()) < PIPELINE_DEPTH) {
+                auto tile_index = std::uint32_t(pending.front());
+
+                if (!write_all(workers[w].to_worker, &tile_index, sizeof(tile_index))) {
+                    fail(w);
+                    break;
+                }
+
+                pending.pop_front();
+                states[w].outstanding.push_back(int(tile_index));
+            }
+        }
+
+        // Fechar a entrada avisa o worker que ele pode terminar. Isso só é feito quando nenhum worker tem
+        // tiles pendentes: até lá, um deles ainda pode falhar e os seus tiles voltarem para a fila.
+        bool drained = pending.empty() && std::none_of(states.begin(), states.end(), [](const WorkerState &state) {
+            return state.alive && !state.outstanding.empty();
+        });
+
+        if (drained) {
+            for (auto &worker : workers)
+                close_fd(worker.to_worker);
+        }
+    };
+
+    // Processa as respostas completas que já chegaram do worker w. Retorna false se a resposta não
+    // corresponder a um tile pendente.
+    auto consume = [&](std::size_t w) {
+        auto &state = states[w];
+        std::size_t offset = 0;
+
+        while (state.received.size() - offset >= sizeof(TileResultHeader)) {
+            TileResultHeader header;
+            std::memcpy(&header, state.received.data() + offset, sizeof(header));
+
+            if (state.outstanding.empty() || header.tile_index != std::uint32_t(state.outstanding.front()))
+                return false;
+
+            const auto &tile = tiles[header.tile_index];
+            if (header.pixel_count != tile_pixel_count(tile))
+                return false;
+
+            auto message_size = sizeof(header) + header.pixel_count * SampleBuffer::RECORD_SIZE;
+            if (state.received.size() - offset < message_size)
+                break;
+
+            samples.unpack_region(tile.start_i, tile.start_j, tile.end_i, tile.end_j,
+                                  state.received.data() + offset + sizeof(header));
+
+            state.outstanding.pop_front();
+            offset += message_size;
+            ++finished_tiles;
+        }
+
+        state.received.erase(state.received.begin(), state.received.begin() + std::ptrdiff_t(offset));
+        return true;
+    };
+
+    assign_tiles();
+
+    std::vector<pollfd> poll_fds;
+    std::vector<std::size_t> poll_workers;
+    unsigned char chunk[1 << 16];
+
+    while (finished_tiles < tiles.size()) {
+        poll_fds.clear();
+        poll_workers.clear();
+
+        for (std::size_t w = 0; w < workers.size(); ++w) {
+            if (states[w].alive && !states[w].outstanding.empty()) {
+                poll_fds.push_back(pollfd{workers[w].from_worker, POLLIN, 0});
+                poll_workers.push_back(w);
+            }
+        }
+
+        if (poll_fds.empty()) {
+            std::cerr << "[ERRO] todos os processos de renderização falharam" << std::endl;
+            return false;
+        }
+
+        if (::poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        for (std::size_t p = 0; p < poll_fds.size(); ++p) {
+            if (poll_fds[p].revents == 0)
+                continue;
+
+            auto w = poll_workers[p];
+            auto count = ::read(workers[w].from_worker, chunk, sizeof(chunk));
+
+            if (count < 0 && errno == EINTR)
+                continue;
+
+            if (count <= 0) {
+                fail(w);
+                continue;
+            }
+
+            states[w].received.insert(states[w].received.end(), chunk, chunk + count);
+            if (!consume(w))
+                fail(w);
+        }
+
+        assign_tiles();
+
+        // Apenas o coordenador escreve no terminal
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_report > std::chrono::milliseconds{500}) {
+            std::clog << "\rTiles: " << finished_tiles << "/" << tiles.size() << "    " << std::flush;
+            last_report = now;
+        }
+    }
+
+    std::clog << "\rTiles: " << finished_tiles << "/" << tiles.size() << " (" << workers.size() << " processos)" << std::endl;
+    return true;
+}
+
+bool Distributed::finish_workers(std::vector<Worker> &workers) {
+    bool success = true;
+
+    for (auto &worker : workers) {
+        close_fd(worker.to_worker);
+        close_fd(worker.from_worker);
+
+        if (worker.pid > 0) {
+            int status = 0;
+            while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {}
+
+            success = success && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+    }
+
+    workers.clear();
+    return success;
+}
+
+std::string Distributed::current_executable(const char *argv0) {
+#ifdef __linux__
+    char path[4096];
+    auto length = ::readlink("/proc/self/exe", path, sizeof(path) - 1);
+
+    if (length > 0)
+        return std::string(path, std::size_t(length));
+#endif
+
+    return argv0;
+}
+
+#endif
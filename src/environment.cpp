@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "../lib/environment.hpp"
+#include "../lib/mapped_file.hpp"
+#include "../lib/random.hpp"
+
+namespace {
+
+    // Lê o próximo número do cabeçalho do PFM, depois de espaços e quebras de linha
+    bool read_header_number(const unsigned char *data, std::size_t size, std::size_t &position, double &value) {
+        while (position < size && std::strchr(" \t\r\n", data[position]) != nullptr)
+            ++position;
+
+        // Os números do cabeçalho são curtos; a cópia garante o terminador que strtod exige
+        char text[32] = {};
+        std::size_t length = 0;
+        while (position < size && length + 1 < sizeof(text) && std::strchr(" \t\r\n", data[position]) == nullptr)
+            text[length++] = char(data[position++]);
+
+        char *end = nullptr;
+        value = std::strtod(text, &end);
+        return length > 0 && end == text + length;
+    }
+
+} // namespace
+
+bool EnvironmentMap::load(const char *filename, std::string &error) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        error = "não foi possível abrir o arquivo";
+        return false;
+    }
+
+    const unsigned char *data = file.data();
+    std::size_t size = file.size();
+
+    if (size < 3 || data[0] != 'P' || data[1] != 'F' || std::strchr(" \t\r\n", data[2]) == nullptr) {
+        error = "não é um PFM colorido (cabeçalho 'PF')";
+        return false;
+    }
+
+    std::size_t position = 2;
+    double width, height, scale;
+    if (!read_header_number(data, size, position, width) || !read_header_number(data, size, position, height)
+        || !read_header_number(data, size, position, scale) || !(width >= 1 && height >= 1 && width <= 1 << 16 && height <= 1 << 16)
+        || scale == 0.0) {
+        error = "cabeçalho do PFM inválido";
+        return false;
+    }
+
+    // Um único caractere separa o cabeçalho dos dados
+    ++position;
+
+    auto texel_count = std::size_t(width) * std::size_t(height);
+    if (position > size || size - position < 3 * texel_count * sizeof(float)) {
+        error = "PFM truncado";
+        return false;
+    }
+
+    // Escala negativa indica little endian; as linhas estão gravadas de baixo para cima
+    std::uint16_t endian_probe = 1;
+    bool is_little_endian = *reinterpret_cast<std::uint8_t *>(&endian_probe) == 1;
+    bool swap_bytes = (scale < 0.0) != is_little_endian;
+
+    int columns = int(width), rows = int(height);
+    std::vector<float> rgb(3 * texel_count);
+    std::size_t row_bytes = 3 * std::size_t(columns) * sizeof(float);
+
+    for (int y = 0; y < rows; ++y) {
+        float *row = &rgb[3 * std::size_t(rows - 1 - y) * columns];
+        std::memcpy(row, data + position + std::size_t(y) * row_bytes, row_bytes);
+
+        if (swap_bytes) {
+            for (int k = 0; k < 3 * columns; ++k) {
+                std::uint32_t bits;
+                std::memcpy(&bits, &row[k], sizeof(bits));
+                bits = (bits >> 24) | ((bits >> 8) & 0xff00u) | ((bits << 8) & 0xff0000u) | (bits << 24);
+                std::memcpy(&row[k], &bits, sizeof(bits));
+            }
+        }
+    }
+
+    assign(columns, rows, std::move(rgb));
+    return true;
+}
+
+void EnvironmentMap::assign(int width, int height, std::vector<float> rgb) {
+    m_width = width;
+    m_height = height;
+    m_texels = std::move(rgb);
+
+    build_distribution();
+}
+
+void EnvironmentMap::build_distribution() {
+    auto width = std::size_t(m_width);
+
+    m_weights.assign(width * m_height, 0.0);
+    m_conditional_cdf.assign((width + 1) * m_height, 0.0);
+    m_marginal_cdf.assign(std::size_t(m_height) + 1, 0.0);
+
+    std::uint64_t key = Random::mix_bits(std::uint64_t(m_width) ^ (std::uint64_t(m_height) << 32));
+
+    for (int y = 0; y < m_height; ++y) {
+        // Pixels mais perto dos polos ocupam uma área menor da esfera
+        double sin_theta = std::sin(Utility::PI * (y + 0.5) / m_height);
+        double *cdf = &m_conditional_cdf[y * (width + 1)];
+
+        for (std::size_t x = 0; x < width; ++x) {
+            float *rgb = &m_texels[3 * (y * width + x)];
+
+            // Valores negativos ou não finitos (NaN, infinito) não são luz
+            for (int channel = 0; channel < 3; ++channel) {
+                if (!(rgb[channel] >= 0.0f && rgb[channel] <= 3.0e38f))
+                    rgb[channel] = 0.0f;
+
+                std::uint32_t bits;
+                std::memcpy(&bits, &rgb[channel], sizeof(bits));
+                key = Random::mix_bits(key ^ bits);
+            }
+
+            double luminance = 0.2126 * rgb[0] + 0.7152 * rgb[1] + 0.0722 * rgb[2];
+            m_weights[y * width + x] = luminance * sin_theta;
+            cdf[x + 1] = cdf[x] + luminance * sin_theta;
+        }
+
+        double row_weight = cdf[width];
+        for (std::size_t x = 1; x <= width; ++x)
+            cdf[x] = row_weight > 0.0 ? cdf[x] / row_weight : double(x) / width;
+        cdf[width] = 1.0;
+
+        m_marginal_cdf[y + 1] = m_marginal_cdf[y] + row_weight;
+    }
+
+    double total = m_marginal_cdf[m_height];
+    for (int y = 1; y <= m_height; ++y)
+        m_marginal_cdf[y] = total > 0.0 ? m_marginal_cdf[y] / total : double(y) / m_height;
+    m_marginal_cdf[m_height] = 1.0;
+
+    m_weight_integral = total / (double(width) * m_height);
+    m_hash = key;
+}
+
+void EnvironmentMap::texel(const Vec3 &direction, int &x, int &y, double &sin_theta) const {
+    double cos_theta = std::clamp(direction.y() / direction.length(), -1.0, 1.0);
+    sin_theta = std::sqrt(std::max(0.0, 1.0 - cos_theta * cos_theta));
+
+    double u = 0.5 + std::atan2(direction.x(), -direction.z()) / (2.0 * Utility::PI);
+    double v = std::acos(cos_theta) / Utility::PI;
+
+    x = std::min(int(u * m_width), m_width - 1);
+    y = std::min(int(v * m_height), m_height - 1);
+}
+
+Vec3 EnvironmentMap::radiance(const Vec3 &direction) const {
+    int x, y;
+    double sin_theta;
+    texel(direction, x, y, sin_theta);
+    return texel_radiance(x, y);
+}
+
+bool EnvironmentMap::sample(const Sampling::Point2 &sample, Vec3 &direction, Vec3 &radiance, double &pdf) const {
+    if (!(m_weight_integral > 0.0))
+        return false;
+
+    // Intervalo [cdf[k], cdf[k + 1]) que contém value, com a posição de value dentro dele em [0, 1)
+    auto invert = [](const double *cdf, int count, double value, double &offset) {
+        int k = int(std::upper_bound(cdf, cdf + count + 1, value) - cdf) - 1;
+        k = std::clamp(k, 0, count - 1);
+        offset = (value - cdf[k]) / (cdf[k + 1] - cdf[k]);
+        return k;
+    };
+
+    double row_offset, column_offset;
+    int y = invert(m_marginal_cdf.data(), m_height, sample.v, row_offset);
+    int x = invert(&m_conditional_cdf[std::size_t(y) * (m_width + 1)], m_width, sample.u, column_offset);
+
+    double theta = Utility::PI * (y + row_offset) / m_height;
+    double phi = 2.0 * Utility::PI * ((x + column_offset) / m_width - 0.5);
+
+    double sin_theta = std::sin(theta);
+    if (!(sin_theta > 0.0))
+        return false;
+
+    direction = Vec3{sin_theta * std::sin(phi), std::cos(theta), -sin_theta * std::cos(phi)};
+    radiance = texel_radiance(x, y);
+
+    // Densidade no quadrado [0, 1]² dividida pela área da esfera por unidade de área do quadrado, 2π² sin(θ)
+    pdf = m_weights[std::size_t(y) * m_width + x] / (m_weight_integral * 2.0 * Utility::PI * Utility::PI * sin_theta);
+    return true;
+}
+
+double EnvironmentMap::pdf(const Vec3 &direction) const {
+    if (!(m_weight_integral > 0.0))
+        return 0.0;
+
+    int x, y;
+    double sin_theta;
+    texel(direction, x, y, sin_theta);
+
+    if (!(sin_theta > 0.0))
+        return 0.0;
+
+    return m_weights[std::size_t(y) * m_width + x] / (m_weight_integral * 2.0 * Utility::PI * Utility::PI * sin_theta);
+}
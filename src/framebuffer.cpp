@@ -0,0 +1,125 @@
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "../lib/framebuffer.hpp"
+
+bool parse_image_format(const char *name, ImageFormat &format) {
+    if (std::strcmp(name, "p6") == 0)
+        format = ImageFormat::PPM_BINARY;
+    else if (std::strcmp(name, "p3") == 0)
+        format = ImageFormat::PPM_ASCII;
+    else if (std::strcmp(name, "pfm") == 0)
+        format = ImageFormat::PFM;
+    else
+        return false;
+
+    return true;
+}
+
+ImageFormat image_format_from_filename(const char *filename) {
+    std::string name{filename};
+    auto extension_start = name.rfind('.');
+
+    if (extension_start != std::string::npos && name.substr(extension_start) == ".pfm")
+        return ImageFormat::PFM;
+
+    return ImageFormat::PPM_BINARY;
+}
+
+void Framebuffer::resize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_pixels.assign(3 * std::size_t(width) * height, 0.0f);
+}
+
+// Mesma conversão que era feita pixel a pixel ao escrever o PPM: correção "gamma 2" (raíz quadrada),
+// restrição ao intervalo [0, 0.999] e multiplicação por 256.
+void Framebuffer::quantize(std::vector<std::uint8_t> &bytes) const {
+    bytes.resize(m_pixels.size());
+
+    const float *linear = m_pixels.data();
+    std::uint8_t *out = bytes.data();
+    auto count = m_pixels.size();
+
+    for (std::size_t c = 0; c < count; ++c) {
+        // NOTE: valores negativos (ou NaN) viram 0, assim como em Utility::linear_to_gamma()
+        float value = linear[c] > 0.0f ? linear[c] : 0.0f;
+        value = std::sqrt(value);
+        value = value < 0.999f ? value : 0.999f;
+
+        out[c] = static_cast<std::uint8_t>(256.0f * value);
+    }
+}
+
+// https://en.wikipedia.org/wiki/Netpbm#PPM_example
+void Framebuffer::write_ppm_binary(std::ostream &out) const {
+    std::vector<std::uint8_t> bytes;
+    quantize(bytes);
+
+    out << "P6\n" << m_width << ' ' << m_height << "\n255\n";
+    out.write(reinterpret_cast<const char *>(bytes.data()), std::streamsize(bytes.size()));
+}
+
+void Framebuffer::write_ppm_ascii(std::ostream &out) const {
+    std::vector<std::uint8_t> bytes;
+    quantize(bytes);
+
+    // O texto é montado inteiro em memória e escrito de uma vez (no máximo "255 255 255\n" por pixel)
+    std::string text;
+    text.reserve(bytes.size() * 4);
+
+    char number[4];
+    for (std::size_t c = 0; c < bytes.size(); ++c) {
+        auto result = std::to_chars(number, number + sizeof(number), int(bytes[c]));
+        text.append(number, result.ptr);
+        text.push_back(c % 3 == 2 ? '\n' : ' ');
+    }
+
+    out << "P3\n" << m_width << ' ' << m_height << "\n255\n";
+    out.write(text.data(), std::streamsize(text.size()));
+}
+
+// http://www.pauldebevec.com/Research/HDR/PFM/
+// Escala negativa indica little endian. As linhas são gravadas de baixo para cima.
+void Framebuffer::write_pfm(std::ostream &out) const {
+    out << "PF\n" << m_width << ' ' << m_height << "\n-1.0\n";
+
+    static_assert(sizeof(float) == 4, "PFM exige floats de 32 bits");
+
+    std::uint16_t endian_probe = 1;
+    bool is_little_endian = *reinterpret_cast<std::uint8_t *>(&endian_probe) == 1;
+
+    std::vector<float> row(3 * std::size_t(m_width));
+    for (int j = m_height - 1; j >= 0; --j) {
+        std::memcpy(row.data(), &m_pixels[index(0, j)], row.size() * sizeof(float));
+
+        if (!is_little_endian) {
+            for (auto &value : row) {
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                bits = (bits >> 24) | ((bits >> 8) & 0xff00u) | ((bits << 8) & 0xff0000u) | (bits << 24);
+                std::memcpy(&value, &bits, sizeof(bits));
+            }
+        }
+
+        out.write(reinterpret_cast<const char *>(row.data()), std::streamsize(row.size() * sizeof(float)));
+    }
+}
+
+bool Framebuffer::write(const char *filename, ImageFormat format) const {
+    std::ofstream output_file(filename, std::ofstream::out | std::ofstream::trunc | std::ios_base::binary);
+
+    if (!output_file)
+        return false;
+
+    switch (format) {
+        case ImageFormat::PPM_BINARY: write_ppm_binary(output_file); break;
+        case ImageFormat::PPM_ASCII: write_ppm_ascii(output_file); break;
+        case ImageFormat::PFM: write_pfm(output_file); break;
+    }
+
+    return bool(output_file);
+}
@@ -0,0 +1,23 @@
+#include "../lib/instance.hpp"
+
+Instance::Instance(std::shared_ptr<const Hittable> geometry, const Transform &object_to_world, std::uint32_t material)
+        : m_geometry{std::move(geometry)}, m_world_to_object{object_to_world.inverse()},
+          m_bounds{object_to_world.apply_box(m_geometry->bounding_box())}, m_material{material} {}
+
+bool Instance::hit(const Ray &r, Interval acceptable_t_interval, HitRecord &h_rec) const {
+    Ray object_ray{m_world_to_object.apply_point(r.origin()), m_world_to_object.apply_vector(r.direction())};
+
+    if (!m_geometry->hit(object_ray, acceptable_t_interval, h_rec))
+        return false;
+
+    // O ponto é recalculado com o raio original (mesmo t) em vez de transformado de volta. A normal
+    // já foi orientada contra o raio no espaço do objeto, e a transformação preserva o sinal de
+    // normal * direção, então is_front_face continua valendo
+    h_rec.point = r.at(h_rec.t);
+    h_rec.normal_sur_vector = m_world_to_object.apply_transposed(h_rec.normal_sur_vector).unit();
+
+    if (m_material != GEOMETRY_MATERIAL)
+        h_rec.material = m_material;
+
+    return true;
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cmath>
+
+#include "../lib/light.hpp"
+#include "../lib/material.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/sampler.hpp"
+
+void LightList::add(std::shared_ptr<const Sphere> sphere, const Vec3 &emission) {
+    m_lights.push_back(Light{std::move(sphere), emission});
+}
+
+void LightList::add_emissive(const std::vector<std::shared_ptr<Hittable>> &objects, const MaterialTable &materials) {
+    for (const auto &object : objects) {
+        auto sphere = std::dynamic_pointer_cast<const Sphere>(object);
+
+        if (sphere != nullptr && sphere->radius() > 0.0 && materials.is_emissive(sphere->material()))
+            add(sphere, materials.emission(sphere->material()));
+    }
+}
+
+double LightList::cone_one_minus_cos(double radius, double distance_squared) {
+    // sin²(θmax) = r² / d², e 1 - cos = sin² / (1 + cos)
+    double sin2 = radius * radius / distance_squared;
+    if (!(sin2 < 1.0))
+        return 0.0;
+
+    return sin2 / (1.0 + std::sqrt(1.0 - sin2));
+}
+
+bool LightList::sample(const Point3 &point, double choice, const Sampling::Point2 &sample, LightSample &light) const {
+    auto count = size();
+    auto index = std::min(std::size_t(choice * double(count)), count - 1);
+
+    // O mapa de ambiente é a última luz do sorteio
+    if (index == m_lights.size()) {
+        if (!m_environment->sample(sample, light.direction, light.emission, light.pdf))
+            return false;
+
+        light.distance = Utility::INFTY;
+        light.pdf /= double(count);
+        return true;
+    }
+
+    const auto &chosen = m_lights[index];
+
+    auto to_center = chosen.sphere->center() - point;
+    double distance_squared = to_center.squared_length();
+    double radius = chosen.sphere->radius();
+
+    double one_minus_cos = cone_one_minus_cos(radius, distance_squared);
+    if (one_minus_cos <= 0.0)
+        return false;
+
+    auto axis = to_center / std::sqrt(distance_squared);
+    light.direction = Sampling::Frame{axis}.to_world(Sampling::uniform_cone(sample, one_minus_cos));
+
+    // Primeira interseção da direção com a esfera (mesma conta de Sphere::hit, com a direção unitária).
+    // Nas bordas do cone o discriminante pode ficar ligeiramente negativo por arredondamento.
+    double h = light.direction * to_center;
+    double discriminant = h * h - (distance_squared - radius * radius);
+    light.distance = h - std::sqrt(std::max(0.0, discriminant));
+
+    light.emission = chosen.emission;
+    light.pdf = Sampling::uniform_cone_pdf(one_minus_cos) / double(count);
+    return true;
+}
+
+bool LightList::sample_direct(const HitRecord &rec, const Vec3 &albedo, Sampler &sampler, Ray &shadow_ray, double &shadow_distance, Vec3 &light) const {
+    double choice = sampler.get_1d();
+
+    LightSample chosen;
+    if (!sample(rec.point, choice, sampler.get_2d(), chosen))
+        return false;
+
+    // Luz por trás da superfície
+    double cosine = chosen.direction * rec.normal_sur_vector;
+    if (cosine <= 0.0)
+        return false;
+
+    // Qualquer objeto antes da superfície da luz a esconde
+    shadow_ray = Ray{rec.point, chosen.direction};
+    shadow_distance = chosen.distance * (1.0 - 1e-6);
+
+    // BRDF (albedo / π) vezes cos(θ) é o albedo vezes a densidade com que o material sortearia a direção
+    double scatter_pdf = Sampling::cosine_hemisphere_pdf(cosine);
+    double weight = Sampling::power_heuristic(chosen.pdf, scatter_pdf) * scatter_pdf / chosen.pdf;
+
+    light = weight * Utility::product_component(albedo, chosen.emission);
+    return true;
+}
+
+double LightList::pdf(const Point3 &origin, const HitRecord &rec) const {
+    for (const auto &light : m_lights) {
+        const auto &sphere = *light.sphere;
+        double radius = sphere.radius();
+
+        // Só o material e o ponto identificam a esfera tocada: ele precisa estar na superfície dela
+        if (sphere.material() != rec.material
+            || std::fabs((rec.point - sphere.center()).squared_length() - radius * radius) > 1e-6 * radius * radius)
+            continue;
+
+        double one_minus_cos = cone_one_minus_cos(radius, (sphere.center() - origin).squared_length());
+        return one_minus_cos > 0.0 ? Sampling::uniform_cone_pdf(one_minus_cos) / double(size()) : 0.0;
+    }
+
+    return 0.0;
+}
@@ -0,0 +1,108 @@
+#include "../lib/mapped_file.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char *filename, bool populate) {
+    // As páginas são sempre carregadas sob demanda no Windows
+    (void)populate;
+
+    close();
+
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file_handle = file;
+    m_mapping_handle = mapping;
+    m_data = static_cast<const unsigned char *>(view);
+    m_size = std::size_t(file_size.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping_handle != nullptr)
+        CloseHandle(m_mapping_handle);
+    if (m_file_handle != nullptr)
+        CloseHandle(m_file_handle);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_file_handle = nullptr;
+    m_mapping_handle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const char *filename, bool populate) {
+    close();
+
+    int file = ::open(filename, O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat file_status;
+    if (fstat(file, &file_status) != 0 || file_status.st_size <= 0) {
+        ::close(file);
+        return false;
+    }
+
+    // MAP_POPULATE (Linux) carrega todas as páginas de uma vez, em vez de uma falta de página para cada 4 KiB
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (populate)
+        flags |= MAP_POPULATE;
+#endif
+
+    void *view = mmap(nullptr, std::size_t(file_status.st_size), PROT_READ, flags, file, 0);
+
+    // O mapeamento continua válido depois que o descritor é fechado
+    ::close(file);
+
+    if (view == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const unsigned char *>(view);
+    m_size = std::size_t(file_status.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data != nullptr)
+        munmap(const_cast<unsigned char *>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
@@ -1,31 +1,26 @@
 #include "../lib/material.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/sampler.hpp"
+#include "../lib/sampling.hpp"
 #include "../lib/utility.hpp"
 
-// NOTE: Implementação do modelo de reflexão difusa de Lambertian. Consideramos,
-// inicialmente, que o ponto onde o raio de luz bate e é refletido chama-se P. A
-// partir disso, cria-se uma esfera tangente a reflexão no ponto P da
-// superfície. O vetor que apontará para o centro da esfera tangente é dado por
-// N + P (normal da sup + P). Ao fazer a soma vetorial de N + P com um vetor
-// unitário aleatório, resultará em um novo vetor que está contido na esfera
-// tangente, gerando raios não-uniformes e mais realistas.
-bool Lambertian::scatter(const Ray &ray_in_sup, const HitRecord &rec, Vec3 &color_attenuation, Ray &scattered) const {
+// NOTE: Implementação do modelo de reflexão difusa de Lambertian. A BRDF é constante, albedo / π, e a
+// luz que chega em cada direção é ponderada por cos(θ) (o ângulo com a normal). Sorteando a direção com
+// densidade cos(θ) / π, o peso da amostra, BRDF * cos(θ) / densidade, é exatamente o albedo: nenhuma
+// direção pesa mais que outra e a atenuação não depende do sorteio.
+//
+// A distribuição é a mesma do modelo anterior (normal + vetor unitário aleatório, isto é, um ponto na
+// esfera tangente à superfície), mas gerada pela transformação do disco concêntrico: dois números
+// aleatórios por desvio, sem laço de tentativa e descarte e sem o caso degenerado em que a soma se anula.
+bool Lambertian::scatter(const Ray &ray_in_sup, const HitRecord &rec, Sampler &sampler, Vec3 &color_attenuation, Ray &scattered) const {
+    auto local_dir = Sampling::cosine_hemisphere(sampler.get_2d());
 
-    // Implementação da difusão por meio da distribuição não uniforme de  Lambertian
-    auto scatter_dir = rec.normal_sur_vector + Utility::random_unit_vec();
-
-    // Caso ocorra de todos os módulos do vetor de reflexão tenderem a 0, a soma
-    // acima pode acarretar bugs graças a limitação de represntação de ponto
-    // flutuante, portanto é mais interessante considerar que os vetores de
-    // reflexão e normal à superfície sejam iguais.
-    if (scatter_dir.near_zero())
-      scatter_dir = rec.normal_sur_vector;
-
-    scattered = Ray(rec.point, scatter_dir);
+    scattered = Ray(rec.point, Sampling::Frame{rec.normal_sur_vector}.to_world(local_dir));
     color_attenuation = m_color_albedo;
     return true;
 }
 
-bool Metal::scatter(const Ray &ray_in_sup, const HitRecord &rec, Vec3 &color_attenuation, Ray &scattered) const {
+bool Metal::scatter(const Ray &ray_in_sup, const HitRecord &rec, Sampler &sampler, Vec3 &color_attenuation, Ray &scattered) const {
     Vec3 reflected_ray = Utility::reflect_vector(ray_in_sup.direction(), rec.normal_sur_vector);
     scattered = Ray(rec.point, reflected_ray);
     color_attenuation = m_color_albedo;
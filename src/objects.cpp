@@ -1,5 +1,8 @@
 #include "../lib/ray.hpp"
 #include "../lib/objects.hpp"
+#include "../lib/bvh.hpp"
+#include "../lib/sphere_soa.hpp"
+#include "../lib/render_stats.hpp"
 
 // NOTE: a operação abaixo ilustrará porque outward_normal tem que ser unitário.
 
@@ -21,6 +24,11 @@ void HitRecord::set_face_normal(const Ray &r, const Vec3 &outward_normal) {
 
 }
 
+void Hittable::hit_packet(const RayPacket &packet, Interval acceptable_t_interval, HitRecord *h_recs, bool *hits) const {
+    for (int k = 0; k < packet.size; ++k)
+        hits[k] = hit(packet.ray(k), acceptable_t_interval, h_recs[k]);
+}
+
 // Essa função calcula se um determinado raio de luz P(t) = Q + td intercepta a esfera
 // Matematicamente, partimos de (C - P)(C - P) = r², onde P = P(t) para sabermos
 // se há interseção. Desenvolvendo essa expressão usando regras de produto escalar
@@ -39,10 +47,13 @@ void HitRecord::set_face_normal(const Ray &r, const Vec3 &outward_normal) {
 // de substituição, então b = -2(d * (C - Q)) = h +/- sqrt(h² - ac) / a => h = -(b/2) = d * (C - Q).
 //
 // Essa simplificação forçada diminui o número de operações matemáticas necessárias para achar t.
+//
+// NOTE: a = d * d é o quadrado da norma, então não há necessidade de extrair raíz quadrada (length())
+// para depois elevar ao quadrado; e a raíz do discriminante é calculada uma única vez.
 bool Sphere::hit(const Ray& ray, Interval acceptable_t_interval, HitRecord &h_rec ) const {
     auto C_minus_Q = m_center - ray.origin();
 
-    auto a = (ray.direction()).length() * (ray.direction().length());
+    auto a = ray.direction().squared_length();
     auto h = ray.direction() * C_minus_Q;
     auto c = (C_minus_Q * C_minus_Q) - m_radius*m_radius;
 
@@ -51,8 +62,9 @@ bool Sphere::hit(const Ray& ray, Interval acceptable_t_interval, HitRecord &h_re
     if (discriminant < 0)
         return false;
 
-    auto t1 = (h - std::sqrt(discriminant)) / a;
-    auto t2 = (h + std::sqrt(discriminant)) / a;
+    auto sqrt_discriminant = std::sqrt(discriminant);
+    auto t1 = (h - sqrt_discriminant) / a;
+    auto t2 = (h + sqrt_discriminant) / a;
 
     auto valid_t = t1;
 
@@ -74,23 +86,73 @@ bool Sphere::hit(const Ray& ray, Interval acceptable_t_interval, HitRecord &h_re
     h_rec.set_face_normal(ray, outward_normal);
 
     // Definimos o tipo de material da esfera
-    h_rec.obj_material = m_material;
+    h_rec.material = m_material;
 
     return true;
 }
 
+void HittableList::build_acceleration(std::size_t bvh_min_objects) {
+    m_acceleration.reset();
+
+    if (objects.size() >= bvh_min_objects) {
+        m_acceleration = std::make_shared<BVH>(objects);
+        return;
+    }
+
+    auto spheres = std::make_shared<SphereSoA>();
+    if (objects.size() > 1 && spheres->add_if_all_spheres(objects))
+        m_acceleration = spheres;
+}
+
+void HittableList::refit_acceleration() {
+    // Estrutura pronta (cena compilada), sem objetos que possam ter se movido
+    if (objects.empty())
+        return;
+
+    // Listas pequenas usam o laço linear ou um SphereSoA, que são simplesmente refeitos
+    auto bvh = std::dynamic_pointer_cast<BVH>(m_acceleration);
+
+    if (bvh == nullptr || !bvh->refit(objects))
+        build_acceleration();
+}
+
 bool HittableList::hit(const Ray& r, Interval acceptable_t_interval, HitRecord &h_rec) const {
-    HitRecord temp_h_rec;
+    if (m_acceleration)
+        return m_acceleration->hit(r, acceptable_t_interval, h_rec);
+
     bool hit_anything = false;
     auto closest_so_far = acceptable_t_interval.max();
+    Stats::t_counters.primitive_tests += objects.size();
 
+    // Como o intervalo só aceita interseções mais próximas que a última, cada objeto pode escrever
+    // diretamente em h_rec, sem um registro temporário copiado a cada interseção
     for (const auto& object : objects) {
-        if(object->hit(r, Interval(acceptable_t_interval.min(), closest_so_far), temp_h_rec)) {
+        if(object->hit(r, Interval(acceptable_t_interval.min(), closest_so_far), h_rec)) {
             hit_anything = true;
-            closest_so_far = temp_h_rec.t;
-            h_rec = temp_h_rec;
+            closest_so_far = h_rec.t;
         }
     }
 
     return hit_anything;
 }
+
+void HittableList::hit_packet(const RayPacket &packet, Interval acceptable_t_interval, HitRecord *h_recs, bool *hits) const {
+    if (m_acceleration) {
+        m_acceleration->hit_packet(packet, acceptable_t_interval, h_recs, hits);
+        return;
+    }
+
+    Hittable::hit_packet(packet, acceptable_t_interval, h_recs, hits);
+}
+
+AABB HittableList::bounding_box() const {
+    if (m_acceleration)
+        return m_acceleration->bounding_box();
+
+    AABB box;
+
+    for (const auto &object : objects)
+        box.expand(object->bounding_box());
+
+    return box;
+}
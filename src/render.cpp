@@ -1,47 +1,57 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <iostream>
-#include <fstream>
 #include <filesystem>
+#include <limits>
 #include <memory>
-#include <thread>
+#include <numeric>
 
 #include "../lib/render.hpp"
 #include "../lib/vector3d.hpp"
 #include "../lib/objects.hpp"
 #include "../lib/ray.hpp"
 #include "../lib/utility.hpp"
+#include "../lib/random.hpp"
 #include "../lib/material.hpp"
+#include "../lib/framebuffer.hpp"
+#include "../lib/ray_packet.hpp"
+#include "../lib/sample_buffer.hpp"
+#include "../lib/sampling.hpp"
+
+namespace {
+
+    // Luz que chega de uma das luzes sorteada ao ponto difuso de rec e é refletida na direção do raio que o
+    // tocou, ainda sem o throughput do caminho
+    Vec3 direct_light(const HitRecord &rec, const Lambertian &diffuse, const Hittable &world, const LightList &lights, Sampler &sampler) {
+        Ray shadow_ray;
+        double shadow_distance;
+        Vec3 light;
+
+        if (!lights.sample_direct(rec, diffuse.albedo(), sampler, shadow_ray, shadow_distance, light))
+            return Vec3{0, 0, 0};
+
+        // Raio de sombra: qualquer objeto antes da superfície da luz a esconde
+        ++Stats::t_counters.shadow_rays;
+        HitRecord blocker;
+        if (world.hit(shadow_ray, Interval(0.001, shadow_distance), blocker))
+            return Vec3{0, 0, 0};
+
+        return light;
+    }
 
-// Essa função transforma um vetor de cor {R, G, B} em uma linha válida de PPM
-// mais informações sobre o formato PPM pode ser encontrada nos comentários de
-// Render::output_to_ppm()
-void Render::write_color(std::ostream &out, const Vec3 &color) {
-
-    static const Interval intensity_level(0.000, 0.999);
-
-    auto r{color.x()};
-    auto g{color.y()};
-    auto b{color.z()};
-
-    // Aplica correção de cor pela conversão do espaço linear para espaço gamma.
-    // Nessa implementação, utilizou-se o espaço "gamma 2", que consiste em elevar
-    // o expoente do valor linear pelo inverso de 2 (tirar raíz quadrada).
-    r = Utility::linear_to_gamma(r);
-    g = Utility::linear_to_gamma(g);
-    b = Utility::linear_to_gamma(b);
-
-    int rbyte{int(256 * intensity_level.restrict_to_interval(r))};
-    int gbyte{int(256 * intensity_level.restrict_to_interval(g))};
-    int bbyte{int(256 * intensity_level.restrict_to_interval(b))};
-
-    out << rbyte << ' ' << gbyte << ' ' << bbyte << std::endl;
-}
+} // namespace
 
-Vec3 Render::ray_color(const Ray &r, const Hittable &world, int recursive_depth) {
+Vec3 Render::ray_color(const Ray &r, const Hittable &world, const MaterialTable &materials, const LightList &lights, int recursive_depth) {
 
     // A cor (0,0,0) serve para representar ausencia de luz
     if(recursive_depth <= 0)
         return Vec3{0,0,0};
 
+    ++Stats::t_counters.primary_rays;
+
     HitRecord rec;
 
     // NOTE: Se o raio atingir o objeto, retorne cinza (intermediário  entre [0,0,0] e [1,1,1]), se não retorne
@@ -58,37 +68,102 @@ Vec3 Render::ray_color(const Ray &r, const Hittable &world, int recursive_depth)
     // Sejam considerado o mesmo raio de luz. Pare resolver esse bug, consideraremos como ponto inicial um intervalo
     // um pouco maior do que 0.
     if(world.hit(r, Interval(0.001, +Utility::INFTY), rec)) {
+        Sampler independent;
+        return shade_hit(r, rec, world, materials, lights, recursive_depth, independent);
+    }
+
+    return background_color(r, lights);
+}
+
+Vec3 Render::shade_hit(const Ray &r, const HitRecord &rec, const Hittable &world, const MaterialTable &materials,
+                       const LightList &lights, int recursive_depth, Sampler &sampler) {
+    // Fração da luz que ainda chega à câmera pelo caminho percorrido até aqui (produto dos albedos)
+    Vec3 throughput{1, 1, 1};
+
+    // Luz já encontrada pelo caminho: as superfícies emissivas tocadas e as luzes amostradas diretamente
+    Vec3 radiance{0, 0, 0};
+
+    Ray ray = r;
+    HitRecord hit = rec;
+
+    // Densidade com que o material sorteou o trecho atual, usada no peso de uma luz tocada por ele; 0 se,
+    // do ponto de onde o trecho partiu, as luzes não foram amostradas diretamente (a câmera e os metais)
+    double scatter_pdf = 0.0;
+
+    // O raio primário é o trecho 0; cada quique gera o trecho seguinte, até recursive_depth trechos
+    for (int bounce = 1; ; ++bounce) {
         Ray scattered;
         Vec3 color_attenuation;
 
-        if(rec.obj_material->scatter(r, rec, color_attenuation, scattered)) {
-            auto color = ray_color(scattered, world, recursive_depth - 1);
-            return Utility::product_component(color_attenuation, color);
+        // Uma luz tocada também poderia ter sido sorteada pela amostragem direta do ponto anterior: as
+        // duas estimativas são combinadas com os pesos da heurística da potência (multiple importance sampling)
+        if (materials.is_emissive(hit.material)) {
+            double weight = scatter_pdf > 0.0 ? Sampling::power_heuristic(scatter_pdf, lights.pdf(ray.origin(), hit)) : 1.0;
+            radiance += weight * Utility::product_component(throughput, materials.emission(hit.material));
         }
 
-        return Vec3{0,0,0};
+        // Cada quique usa as suas próprias dimensões do amostrador (as do trecho 0 são da câmera)
+        sampler.start_bounce(bounce);
+
+        ++Stats::t_counters.bounces;
+
+        if (!materials.scatter(hit.material, ray, hit, sampler, color_attenuation, scattered) || bounce >= recursive_depth)
+            return radiance;
+
+        // Next event estimation: nos pontos difusos, uma das luzes é amostrada diretamente (ver LightList).
+        // Sem luzes na lista, nenhum número a mais é consumido do amostrador.
+        const auto *diffuse = lights.empty() ? nullptr : materials.diffuse(hit.material);
+        if (diffuse != nullptr)
+            radiance += Utility::product_component(throughput, direct_light(hit, *diffuse, world, lights, sampler));
+
+        throughput = Utility::product_component(throughput, color_attenuation);
+        scatter_pdf = diffuse != nullptr ? Sampling::cosine_hemisphere_pdf(scattered.direction() * hit.normal_sur_vector) : 0.0;
+
+        // Roleta russa: a partir de m_roulette_min_depth quiques, o caminho continua com probabilidade
+        // igual à maior componente do throughput. Os caminhos que sobrevivem são divididos por essa
+        // probabilidade, então a média continua a mesma (sem viés), mas caminhos que pouco contribuem
+        // para o pixel deixam de ser seguidos até o limite de profundidade.
+        if (bounce >= m_roulette_min_depth) {
+            auto survival = std::min(1.0, std::max({throughput.x(), throughput.y(), throughput.z()}));
+
+            if (sampler.get_1d() >= survival)
+                return radiance;
+
+            throughput *= 1.0 / survival;
+        }
+
+        ray = scattered;
+        ++Stats::t_counters.secondary_rays;
+
+        if (!world.hit(ray, Interval(0.001, +Utility::INFTY), hit)) {
+            // O mapa de ambiente também é amostrado diretamente nos pontos difusos (como as luzes tocadas)
+            double weight = scatter_pdf > 0.0 ? Sampling::power_heuristic(scatter_pdf, lights.environment_pdf(ray.direction())) : 1.0;
+            return radiance + weight * Utility::product_component(throughput, background_color(ray, lights));
+        }
     }
+}
+
+Vec3 Render::background_color(const Ray &r, const LightList &lights) const {
+    if (const auto *environment = lights.environment())
+        return environment->radiance(r.direction());
 
+    return background_color(r);
+}
+
+Vec3 Render::background_color(const Ray &r) const {
     Vec3 unit_direction = r.direction().unit();
     auto a = 0.5*(unit_direction.y() + 1.0);
     return (1.0-a)*Vec3(1.0, 1.0, 1.0) + a*Vec3(0.5, 0.7, 1.0);
 }
 
-// NOTE: Função auxiliar para emular um pixel em forma quadrado unitário para pegar algum
-// ponto aleatório dentro desse quadrado
-Vec3 random_vec_from_unit_square() {
-
-    // O quadrado unitário está na região x = {-0.5, 0.5}, y = {-0.5, 0.5} e random_double()
-    // retornará sempre um número menor que 1, portanto o vetor abaixo está nos limites do
-    // quadrado unitário estabelecido
-    return Vec3((Utility::random_double() - 0.5), (Utility::random_double() - 0.5), 0);
-}
-
 //  Joga um raio com origem no centro da câmera até um ponto escolhido aleatoriamente na coordenada (i, j)
 //  Isso faz com que haja uma maior naturalidade nos raios de luz em direção ao objeto, já que na vida real
 //  a luz não bate no objeto sempre na mesma localização, essencial para erar o efeito de antialiasing.
-Ray Render::get_ray(int i, int j) const {
-    auto offset = random_vec_from_unit_square();
+Ray Render::get_ray(int i, int j, Sampler &sampler) const {
+    // NOTE: O pixel é emulado como um quadrado unitário na região x = {-0.5, 0.5}, y = {-0.5, 0.5}; o
+    // ponto do amostrador está em [0, 1)², portanto o deslocamento abaixo fica dentro desse quadrado
+    auto square = sampler.get_2d();
+    auto offset = Vec3(square.u - 0.5, square.v - 0.5, 0);
     auto pixel_sample = m_pixel00_loc
                           + ((i + offset.x()) * m_pixel_delta_i)
                           + ((j + offset.y()) * m_pixel_delta_j);
@@ -100,139 +175,496 @@ Ray Render::get_ray(int i, int j) const {
 
 }
 
-void Render::render_quadrant(std::ostream &output_file, int quadrant, HittableList &world) {
+void Render::configure_view() {
+    // Mesmas contas dos inicializadores da classe (ver render.hpp)
+    m_img_height = (int(m_img_width / m_aspect_ratio) < 1) ? 1 : (int(m_img_width / m_aspect_ratio));
 
-    int start_i = 0;
-    int start_j = 0;
-    int end_i = 0;
-    int end_j = 0;
+    Vec3 focal_vector{0, 0, m_focal_length};
+    Vec3 up{0, 1, 0};
+    Vec3 right{1, 0, 0};
 
-    switch(quadrant) {
-        case 1: {
-            start_i = 0;
-            start_j = 0;
-            end_i = m_img_width;
-            end_j = m_img_height / 4;
-            break;
-        }
+    if (m_has_camera) {
+        // Base ortonormal da câmera: w aponta para trás (do alvo para a câmera), u para a direita e
+        // v para cima. O viewport fica sobre o alvo, de modo que a distância focal é |lookfrom - lookat|.
+        auto w = (m_camera.lookfrom - m_camera.lookat).unit();
+        auto u = (m_camera.vup % w).unit();
+        auto v = w % u;
 
-        case 2: {
-            start_i = 0;
-            start_j = m_img_height / 4;
-            end_i = m_img_width;
-            end_j = m_img_height / 3;
-            break;
+        m_focal_length = (m_camera.lookfrom - m_camera.lookat).length();
+        m_viewport_height = 2 * std::tan(Utility::degrees_to_radian(m_camera.vfov) / 2) * m_focal_length;
+
+        m_camera_center = m_camera.lookfrom;
+        focal_vector = m_focal_length * w;
+        up = v;
+        right = u;
+    }
+
+    m_viewport_width = m_viewport_height * (double(m_img_width) / m_img_height);
+    m_center = m_camera_center;
+
+    m_viewport_i = m_has_camera ? m_viewport_width * right : Vec3{m_viewport_width};
+    m_viewport_j = m_has_camera ? m_viewport_height * -up : Vec3{0, -m_viewport_height};
+
+    m_pixel_delta_i = m_viewport_i / m_img_width;
+    m_pixel_delta_j = m_viewport_j / m_img_height;
+
+    m_viewport_upper_left = m_camera_center - focal_vector - m_viewport_i/2 - m_viewport_j/2;
+    m_pixel00_loc = m_viewport_upper_left + 0.5 * (m_pixel_delta_i + m_pixel_delta_j);
+}
+
+std::vector<Tile> Render::split_into_tiles() const {
+    std::vector<Tile> tiles;
+
+    // Os tiles seguem a mesma ordem da imagem: da esquerda pra direita, depois de cima para baixo
+    for (auto start_j = 0; start_j < m_img_height; start_j += m_tile_size) {
+      for (auto start_i = 0; start_i < m_img_width; start_i += m_tile_size) {
+        tiles.push_back(Tile{start_i, start_j,
+                             std::min(start_i + m_tile_size, m_img_width),
+                             std::min(start_j + m_tile_size, m_img_height)});
+      }
+    }
+
+    return tiles;
+}
+
+std::uint32_t Render::next_sample_target(const PixelEstimate &estimate) const {
+    auto max_samples = std::uint32_t(m_ray_sample_per_pixel);
+
+    if (estimate.count >= max_samples)
+        return estimate.count;
+
+    if (m_adaptive_error_threshold <= 0.0)
+        return max_samples;
+
+    if (estimate.count < std::uint32_t(m_min_samples_per_pixel))
+        return std::min(std::uint32_t(m_min_samples_per_pixel), max_samples);
+
+    return std::min(estimate.count + ADAPTIVE_BATCH_SIZE, max_samples);
+}
+
+bool Render::pixel_converged(const Tile &tile, int i, int j, const SampleBuffer &samples) const {
+    const auto &estimate = samples.pixel(i, j);
+
+    if (int(estimate.count) >= m_ray_sample_per_pixel)
+        return true;
+
+    if (m_adaptive_error_threshold <= 0.0 || int(estimate.count) < m_min_samples_per_pixel)
+        return false;
+
+    // O erro de um único pixel é estimado com poucas amostras e pode sair baixo por sorte (por exemplo,
+    // quando nenhuma das primeiras amostras encontrou um caminho raro e claro). Usar o maior erro da
+    // vizinhança 3x3 (dentro do tile, para que a decisão não dependa de outras threads) evita que
+    // esses pixels parem cedo demais e apareçam como pontos isolados na imagem.
+    for (auto nj = std::max(j - 1, tile.start_j); nj < std::min(j + 2, tile.end_j); ++nj)
+      for (auto ni = std::max(i - 1, tile.start_i); ni < std::min(i + 2, tile.end_i); ++ni)
+        if (samples.pixel(ni, nj).display_error() > m_adaptive_error_threshold)
+          return false;
+
+    return true;
+}
+
+bool Render::render_tile(const Tile &tile, const HittableList &world, SampleBuffer &samples) {
+    auto tile_width = tile.end_i - tile.start_i;
+    auto tile_pixels = std::size_t(tile_width) * (tile.end_j - tile.start_j);
+
+    // No modo progressivo, cada chamada acrescenta no máximo m_samples_per_pass amostras por pixel
+    std::vector<std::uint32_t> pass_limits(tile_pixels, std::numeric_limits<std::uint32_t>::max());
+    if (m_samples_per_pass > 0) {
+        for (auto j = tile.start_j; j < tile.end_j; ++j)
+          for (auto i = tile.start_i; i < tile.end_i; ++i)
+            pass_limits[std::size_t(j - tile.start_j) * tile_width + (i - tile.start_i)] = samples.pixel(i, j).count + m_samples_per_pass;
+    }
+
+    // Número de amostras que cada pixel do tile deve ter ao fim da rodada atual
+    std::vector<std::uint32_t> targets(tile_pixels);
+    bool unfinished = false;
+
+    while (true) {
+        bool any_active = false;
+        unfinished = false;
+
+        // A cada rodada, os pixels que ainda não convergiram recebem mais um lote de amostras
+        for (auto j = tile.start_j; j < tile.end_j; ++j) {
+          for (auto i = tile.start_i; i < tile.end_i; ++i) {
+            auto k = std::size_t(j - tile.start_j) * tile_width + (i - tile.start_i);
+            const auto &estimate = samples.pixel(i, j);
+
+            targets[k] = 0;
+            if (pixel_converged(tile, i, j, samples))
+                continue;
+
+            // Pixels que ainda não convergiram, mas já atingiram o limite desta passada, ficam para a próxima
+            targets[k] = std::min(next_sample_target(estimate), pass_limits[k]);
+            if (targets[k] <= estimate.count) {
+                targets[k] = 0;
+                unfinished = true;
+            }
+
+            any_active = any_active || targets[k] > 0;
+          }
         }
 
-        case 3: {
-            start_i = 0;
-            start_j = m_img_height / 3;
-            end_i = m_img_width;
-            end_j = m_img_height / 2;
+        if (!any_active)
             break;
+
+        if (m_integrator == Integrator::WAVEFRONT)
+            sample_tile_wavefront(tile, world, samples, targets);
+        else if (m_packet_size > 0)
+            sample_tile_packets(tile, world, samples, targets);
+        else
+            sample_tile(tile, world, samples, targets);
+    }
+
+    return !unfinished;
+}
+
+void Render::sample_tile(const Tile &tile, const HittableList &world, SampleBuffer &samples, const std::vector<std::uint32_t> &targets) {
+    auto tile_width = tile.end_i - tile.start_i;
+    auto sampler = make_sampler();
+
+    for (auto j = tile.start_j; j < tile.end_j; ++j) {
+      for (auto i = tile.start_i; i < tile.end_i; ++i) {
+        // Cada pixel pertence a exatamente um tile, portanto não há disputa entre threads aqui
+        auto &estimate = samples.pixel(i, j);
+        auto target = targets[std::size_t(j - tile.start_j) * tile_width + (i - tile.start_i)];
+
+        while (estimate.count < target) {
+          // O amostrador é reiniciado a partir do pixel e da amostra, e não continua de onde parou, para
+          // que o resultado independa da thread, da ordem dos tiles e de quantas rodadas foram feitas
+          sampler.start_pixel_sample(i, j, estimate.count);
+
+          Ray r = get_ray(i, j, sampler);
+          HitRecord rec;
+          bool hit = false;
+
+          if (m_max_recursive_depth > 0) {
+            ++Stats::t_counters.primary_rays;
+            hit = world.hit(r, Interval(0.001, +Utility::INFTY), rec);
+          }
+
+          add_sample(estimate, r, hit, rec, world, sampler);
         }
+      }
+    }
+}
 
-        case 4: {
-            start_i = 0;
-            start_j = m_img_height / 2;
-            end_i = m_img_width;
-            end_j = m_img_height;
-            break;
+void Render::sample_tile_packets(const Tile &tile, const HittableList &world, SampleBuffer &samples, const std::vector<std::uint32_t> &targets) {
+    auto tile_width = tile.end_i - tile.start_i;
+    auto sampler = make_sampler();
+
+    // Pixels vizinhos formam blocos de 2x2 (4 raios), 4x2 (8) ou 4x4 (16)
+    int block_width = m_packet_size >= 8 ? 4 : 2;
+    int block_height = m_packet_size / block_width;
+
+    for (auto block_j = tile.start_j; block_j < tile.end_j; block_j += block_height) {
+      for (auto block_i = tile.start_i; block_i < tile.end_i; block_i += block_width) {
+
+        // Pixels do bloco (os blocos da borda do tile podem ser menores)
+        int block_pixel_i[RayPacket::MAX_SIZE];
+        int block_pixel_j[RayPacket::MAX_SIZE];
+        std::uint32_t block_target[RayPacket::MAX_SIZE];
+        int block_pixel_count = 0;
+
+        for (auto j = block_j; j < std::min(block_j + block_height, tile.end_j); ++j) {
+          for (auto i = block_i; i < std::min(block_i + block_width, tile.end_i); ++i) {
+            block_pixel_i[block_pixel_count] = i;
+            block_pixel_j[block_pixel_count] = j;
+            block_target[block_pixel_count] = targets[std::size_t(j - tile.start_j) * tile_width + (i - tile.start_i)];
+            ++block_pixel_count;
+          }
         }
 
-        default: {
-            start_i = 0;
-            start_j = 0;
-            end_i = m_img_width;
-            end_j = m_img_height;
+        HitRecord records[RayPacket::MAX_SIZE];
+        bool hits[RayPacket::MAX_SIZE];
+
+        while (true) {
+          // Com a amostragem adaptativa, os pixels que já convergiram ficam fora do pacote
+          int pixel_i[RayPacket::MAX_SIZE];
+          int pixel_j[RayPacket::MAX_SIZE];
+          int pixel_count = 0;
+
+          for (int k = 0; k < block_pixel_count; ++k) {
+            if (samples.pixel(block_pixel_i[k], block_pixel_j[k]).count < block_target[k]) {
+              pixel_i[pixel_count] = block_pixel_i[k];
+              pixel_j[pixel_count] = block_pixel_j[k];
+              ++pixel_count;
+            }
+          }
+
+          if (pixel_count == 0)
             break;
-        }
-    }
 
-    // Qualquer coisa abaixo de "255" é considerado como conteúdo
-    // A ordem de informação é RGBYWB (red/green/blue/yellow/white/black)
-    for (auto j = start_j; j < end_j; ++j) {
-      std::clog << "\nLinhas verticias restantes: " << (m_img_height - j) << ' ' << std::flush;
+          RayPacket packet;
 
-      for (auto i = start_i; i < end_i; ++i) {
-        Vec3 pixel_color{0, 0, 0};
+          for (int k = 0; k < pixel_count; ++k) {
+            sampler.start_pixel_sample(pixel_i[k], pixel_j[k], samples.pixel(pixel_i[k], pixel_j[k]).count);
+            packet.add(get_ray(pixel_i[k], pixel_j[k], sampler));
+          }
 
-        for (auto sample = 0; sample < m_ray_sample_per_pixel; ++sample) {
-          Ray r = get_ray(i, j);
-          pixel_color += ray_color(r, world, m_max_recursive_depth);
-        }
+          // Apenas a visibilidade primária é traçada em pacote. Depois do primeiro quique as direções
+          // são aleatórias e o pacote perde a coerência, então cada caminho segue sozinho.
+          world.hit_packet(packet, Interval(0.001, +Utility::INFTY), records, hits);
+          Stats::t_counters.primary_rays += std::uint64_t(pixel_count);
+
+          for (int k = 0; k < pixel_count; ++k) {
+            auto &estimate = samples.pixel(pixel_i[k], pixel_j[k]);
 
-        write_color(output_file, m_ray_sample_scale * pixel_color);
+            // O amostrador volta ao caminho deste pixel/amostra; como cada quique tem dimensões próprias,
+            // a imagem é idêntica à renderizada sem pacotes
+            sampler.start_pixel_sample(pixel_i[k], pixel_j[k], estimate.count);
+
+            add_sample(estimate, packet.ray(k), hits[k], records[k], world, sampler);
+          }
+        }
       }
     }
 }
 
-void Render::merge_renderized_cache_files(std::ostream &final_file, std::vector<const char*> cache_filenames)  {
-    std::vector<std::ifstream> cache_content;
+void Render::add_sample(PixelEstimate &estimate, const Ray &r, bool hit, const HitRecord &rec, const HittableList &world, Sampler &sampler) {
+    // Mesma cor de ray_color, que também testaria o raio primário
+    if (m_max_recursive_depth <= 0) {
+        estimate.add(Vec3{0, 0, 0});
+        estimate.add_features(Vec3{0, 0, 0}, Vec3{0, 0, 0}, 0.0);
+    }
+    else if (hit) {
+        estimate.add(shade_hit(r, rec, world, world.materials, world.lights, m_max_recursive_depth, sampler));
+        estimate.add_features(world.materials.albedo(rec.material), rec.normal_sur_vector, rec.t * r.direction().length());
+    }
+    else {
+        auto sky = background_color(r, world.lights);
+        estimate.add(sky);
+        estimate.add_features(sky, Vec3{0, 0, 0}, 0.0);
+    }
+}
+
+void Render::render(const HittableList &world, Framebuffer &framebuffer) {
+    SampleBuffer samples;
+    while (!render(world, samples)) {}
+    samples.resolve(framebuffer);
+}
 
-    for(auto &cache_filename : cache_filenames)
-      cache_content.push_back(std::ifstream(cache_filename, std::ios_base::binary));
+bool Render::render(const HittableList &world, SampleBuffer &samples) {
+    std::vector<int> tile_indices(split_into_tiles().size());
+    std::iota(tile_indices.begin(), tile_indices.end(), 0);
 
-    for(auto &content : cache_content) {
-      final_file << content.rdbuf();
-      content.close();
-    }
+    return render(world, samples, tile_indices);
 }
 
-// Trataremos a cor no formato RGB, onde os valores de R, G e B são componentes de um vetor
-void Render::output_to_ppm(const char *filename) {
+bool Render::render(const HittableList &world, SampleBuffer &samples, const std::vector<int> &tile_indices) {
+    if (!m_thread_pool || (m_thread_count > 0 && m_thread_pool->size() != m_thread_count))
+        m_thread_pool = std::make_unique<ThreadPool>(m_thread_count);
 
-    if (std::filesystem::exists(filename))
-        std::clog << "[AVISO] arquivo " << filename << " existe, seu conteúdo será sobreescrito" << std::endl;
+    if (samples.width() != m_img_width || samples.height() != m_img_height)
+        samples.resize(m_img_width, m_img_height);
 
+    auto tiles = split_into_tiles();
+    std::atomic<bool> finished{true};
+
+    auto render_start = std::chrono::steady_clock::now();
+
+    // As threads de renderização só atualizam os próprios contadores; o progresso é impresso pela
+    // thread relatora de m_stats
+    m_stats.begin_pass(m_thread_pool->size(), int(tile_indices.size()), m_quiet ? std::chrono::milliseconds{0} : m_progress_interval);
+    auto rays_before = m_stats.totals();
+
+    m_thread_pool->run(int(tile_indices.size()), [&](int task_index, int thread_index) {
+        auto tile_start = std::chrono::steady_clock::now();
+        Stats::t_counters = Stats::RayCounters{};
+
+        if (!render_tile(tiles[tile_indices[task_index]], world, samples))
+            finished = false;
+
+        m_stats.publish(thread_index, std::chrono::steady_clock::now() - tile_start);
+    });
+
+    m_stats.end_pass();
+
+    std::chrono::duration<double> render_time = std::chrono::steady_clock::now() - render_start;
+    auto rays_after = m_stats.totals();
+    auto rays = double(rays_after.primary_rays + rays_after.secondary_rays + rays_after.shadow_rays
+                       - rays_before.primary_rays - rays_before.secondary_rays - rays_before.shadow_rays);
+
+    if (m_quiet)
+        return finished;
+
+    std::clog << "Renderizado em " << render_time.count() << "s ("
+              << m_thread_pool->size() << " threads, " << tile_indices.size() << " tiles, semente " << m_seed
+              << ", " << 1e-6 * rays / render_time.count() << " Mraios/s";
+
+    if (m_integrator == Integrator::WAVEFRONT)
+        std::clog << ", integrador wavefront" << (m_sort_rays ? " com os raios secundários ordenados" : "");
+    else if (m_packet_size > 0)
+        std::clog << ", pacotes de " << m_packet_size << " raios";
+
+    if (m_adaptive_error_threshold > 0.0)
+        std::clog << ", média de " << double(samples.total_samples()) / (double(m_img_width) * m_img_height) << " amostras por pixel";
+
+    std::clog << ")" << std::endl;
+
+    return finished;
+}
+
+HittableList Render::default_scene() {
     // Lista de objetos que será renderizado
     HittableList world;
 
-    auto material_ground = std::make_shared<Lambertian>(Vec3{0.8, 0.8, 0.0});
-    auto material_center = std::make_shared<Lambertian>(Vec3{0.1, 0.2, 0.5});
-    auto material_left = std::make_shared<Metal>(Vec3{0.8, 0.8, 0.8});
-    auto material_right = std::make_shared<Metal>(Vec3{0.8, 0.6, 0.2});
+    auto material_ground = world.materials.add(Lambertian{Vec3{0.8, 0.8, 0.0}});
+    auto material_center = world.materials.add(Lambertian{Vec3{0.1, 0.2, 0.5}});
+    auto material_left = world.materials.add(Metal{Vec3{0.8, 0.8, 0.8}});
+    auto material_right = world.materials.add(Metal{Vec3{0.8, 0.6, 0.2}});
 
     world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0, -100.5, -1.0), 100.0, material_ground));
     world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0,    0.0, -1.2),   0.5, material_center));
     world.add_to_obj_list(std::make_shared<Sphere>(Vec3(-1.0,    0.0, -1.0),   0.5, material_left));
     world.add_to_obj_list(std::make_shared<Sphere>(Vec3( 1.0,    0.0, -1.0),   0.5, material_right));
 
-    std::vector<const char*> cache_filenames = {"render_cache_1", "render_cache_2", "render_cache_3", "render_cache_4"};
-    std::vector<std::ofstream> cache_files;
+    // Para cenas grandes, troca o teste linear pela BVH
+    world.build_acceleration();
+
+    return world;
+}
+
+std::uint64_t Render::world_hash(const HittableList &world) {
+    std::uint64_t key = 0;
+
+    // O índice da alternativa do std::variant segue a mesma ordem de MaterialDescription::Type
+    for (std::uint32_t material = 0; material < world.materials.size(); ++material) {
+        key = Random::mix_bits(key ^ std::uint64_t(world.materials[material].index()));
+        Random::mix_vector(key, world.materials.albedo(material));
+    }
+
+    for (const auto &object : world.objects) {
+        if (auto sphere = std::dynamic_pointer_cast<Sphere>(object)) {
+            Random::mix_vector(key, sphere->center());
+            Random::mix_double(key, sphere->radius());
+            key = Random::mix_bits(key ^ sphere->material());
+        }
+        else {
+            Random::mix_vector(key, object->bounding_box().min());
+            Random::mix_vector(key, object->bounding_box().max());
+        }
+    }
+
+    return key;
+}
+
+std::uint64_t Render::checkpoint_key(std::uint64_t scene_hash) const {
+    // Tudo que altera o valor das amostras já acumuladas. O número de amostras e o limite de erro
+    // podem mudar entre execuções, é justamente assim que a qualidade é aumentada aos poucos.
+    std::uint64_t key = scene_hash;
+    for (std::uint64_t value : {std::uint64_t(m_img_width), std::uint64_t(m_img_height), m_seed,
+                                std::uint64_t(m_max_recursive_depth), std::uint64_t(m_roulette_min_depth),
+                                std::uint64_t(m_sampler_type)})
+        key = Random::mix_bits(key ^ value);
+
+    // No BLUE_NOISE o índice de cada amostra depende de log2(--spp): as amostras de um checkpoint só
+    // continuam as mesmas redes enquanto esse valor não mudar
+    if (m_sampler_type == SamplerType::BLUE_NOISE)
+        key = Random::mix_bits(key ^ std::uint64_t(make_sampler().log2_samples()));
+
+    // Posição e orientação da câmera
+    for (const auto &vector : {m_center, m_pixel00_loc, m_pixel_delta_i, m_pixel_delta_j}) {
+        for (int axis = 0; axis < 3; ++axis) {
+            std::uint64_t bits;
+            double component = vector[axis];
+            std::memcpy(&bits, &component, sizeof(bits));
+            key = Random::mix_bits(key ^ bits);
+        }
+    }
+
+    return key;
+}
+
+bool Render::write_images(const SampleBuffer &samples, const char *filename, ImageFormat format) const {
+    Framebuffer framebuffer;
+
+    // O filtro usa as threads da renderização, que já terminou (sem elas, roda nesta thread)
+    if (m_denoise)
+        m_denoiser.apply(samples, framebuffer, m_thread_pool.get());
+    else
+        samples.resolve(framebuffer);
+
+    // A imagem só toca o disco aqui, em uma única escrita, depois que todas as threads terminaram
+    if (!framebuffer.write(filename, format)) {
+        std::cerr << "[ERRO] não foi possível escrever o arquivo " << filename << std::endl;
+        return false;
+    }
+
+    if (m_sample_map_filename != nullptr) {
+        Framebuffer sample_map;
+        samples.resolve_sample_map(sample_map, std::uint32_t(m_ray_sample_per_pixel));
+
+        if (!sample_map.write(m_sample_map_filename, image_format_from_filename(m_sample_map_filename))) {
+            std::cerr << "[ERRO] não foi possível escrever o arquivo " << m_sample_map_filename << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Render::write_stats() const {
+    if (m_stats_filename == nullptr)
+        return true;
+
+    if (!m_stats.write_json(m_stats_filename, m_img_width, m_img_height)) {
+        std::cerr << "[ERRO] não foi possível escrever o arquivo " << m_stats_filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool Render::output_to_file(const char *filename, ImageFormat format) {
+    return output_to_file(default_scene(), default_scene_hash(), filename, format);
+}
+
+// Trataremos a cor no formato RGB, onde os valores de R, G e B são componentes de um vetor
+bool Render::output_to_file(const HittableList &world, std::uint64_t scene_hash, const char *filename, ImageFormat format) {
 
-    // Arquivos soltos para renderizar cada pedaço da cena, necessário para
-    // renderizar paralelamente.
-    for (auto &cache_filename : cache_filenames)
-      cache_files.push_back(std::ofstream(cache_filename, std::ofstream::out | std::ofstream::trunc | std::ios_base::binary));
+    if (std::filesystem::exists(filename))
+        std::clog << "[AVISO] arquivo " << filename << " existe, seu conteúdo será sobreescrito" << std::endl;
+
+    SampleBuffer samples;
+    m_stats.reset();
+
+    if (m_checkpoint_filename == nullptr) {
+        while (!render(world, samples)) {}
+
+        if (!write_images(samples, filename, format))
+            return false;
 
-    // Arquivo final, onde de fato o PPM será gerado
-    std::ofstream output_file(filename, std::ofstream::out | std::ofstream::trunc | std::ios_base::binary);
+        std::clog << "Concluído" << std::endl;
+        return write_stats();
+    }
 
-    // https://en.wikipedia.org/wiki/Netpbm#PPM_example
-    output_file << "P3" << std::endl;
-    output_file << m_img_width << ' ' << m_img_height << std::endl;
-    output_file << "255" << std::endl;
+    // Modo progressivo: a cada passada as amostras são salvas no checkpoint e a imagem parcial é escrita
+    auto key = checkpoint_key(scene_hash);
 
-    // Renderiza a cena em 4 arquivos diferentes
+    if (m_resume) {
+        if (!samples.load(m_checkpoint_filename, key)) {
+            std::cerr << "[ERRO] não foi possível continuar a partir de " << m_checkpoint_filename
+                      << " (arquivo ausente, corrompido ou de outra cena/configuração)" << std::endl;
+            return false;
+        }
 
-    std::thread render1(&Render::render_quadrant, this, std::ref(cache_files.at(0)), 1, std::ref(world));
-    std::thread render2(&Render::render_quadrant, this, std::ref(cache_files.at(1)), 2, std::ref(world));
-    std::thread render3(&Render::render_quadrant, this, std::ref(cache_files.at(2)), 3, std::ref(world));
-    std::thread render4(&Render::render_quadrant, this, std::ref(cache_files.at(3)), 4, std::ref(world));
+        std::clog << "Continuando a partir de " << m_checkpoint_filename << " ("
+                  << double(samples.total_samples()) / (double(samples.width()) * samples.height()) << " amostras por pixel)" << std::endl;
+    }
 
-    render1.join();
-    render2.join();
-    render3.join();
-    render4.join();
+    bool finished = false;
+    while (!finished) {
+        finished = render(world, samples);
 
-    // Junta-se as cenas em 1 arquivo final, que será o .ppm
-    merge_renderized_cache_files(output_file, cache_filenames);
+        if (!samples.save(m_checkpoint_filename, key)) {
+            std::cerr << "[ERRO] não foi possível escrever o checkpoint " << m_checkpoint_filename << std::endl;
+            return false;
+        }
 
-    // Necessário fechar os streams para não ocorrer nenhum tipo de vazamento de memória
-    for(auto &cache_file : cache_files)
-        cache_file.close();
+        if (!write_images(samples, filename, format))
+            return false;
+    }
 
-    output_file.close();
-    std::clog << std::endl << "Concluído" << std::endl;
+    std::clog << "Concluído" << std::endl;
+    return write_stats();
 }
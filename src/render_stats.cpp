@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "../lib/render_stats.hpp"
+
+namespace {
+
+    // Soma os contadores de uma thread em totals
+    void accumulate(RenderStats::Totals &totals, const RenderStats::ThreadCounters &counters) {
+        constexpr auto relaxed = std::memory_order_relaxed;
+
+        totals.primary_rays += counters.primary_rays.load(relaxed);
+        totals.secondary_rays += counters.secondary_rays.load(relaxed);
+        totals.shadow_rays += counters.shadow_rays.load(relaxed);
+        totals.bounces += counters.bounces.load(relaxed);
+        totals.box_tests += counters.box_tests.load(relaxed);
+        totals.primitive_tests += counters.primitive_tests.load(relaxed);
+        totals.tiles += counters.tiles.load(relaxed);
+        totals.tile_seconds += 1e-9 * double(counters.tile_nanoseconds.load(relaxed));
+        totals.max_tile_seconds = std::max(totals.max_tile_seconds, 1e-9 * double(counters.max_tile_nanoseconds.load(relaxed)));
+    }
+
+    void write_totals_json(std::ostream &out, const RenderStats::Totals &totals) {
+        out << "\"primary_rays\": " << totals.primary_rays
+            << ", \"secondary_rays\": " << totals.secondary_rays
+            << ", \"shadow_rays\": " << totals.shadow_rays
+            << ", \"bounces\": " << totals.bounces
+            << ", \"box_tests\": " << totals.box_tests
+            << ", \"primitive_tests\": " << totals.primitive_tests
+            << ", \"tiles\": " << totals.tiles
+            << ", \"tile_seconds\": " << totals.tile_seconds
+            << ", \"max_tile_seconds\": " << totals.max_tile_seconds;
+    }
+
+} // namespace
+
+void RenderStats::reset() {
+    end_pass();
+
+    // Os contadores são recriados (zerados) na próxima passada
+    m_threads.reset();
+    m_thread_count = 0;
+    m_seconds = 0.0;
+}
+
+void RenderStats::begin_pass(int thread_count, int tile_count, std::chrono::milliseconds report_interval) {
+    end_pass();
+
+    // Os contadores só são recriados (e perdidos) se o número de threads mudar
+    if (thread_count != m_thread_count) {
+        m_threads = std::make_unique<ThreadCounters[]>(std::size_t(thread_count));
+        m_thread_count = thread_count;
+    }
+
+    m_pass_start = std::chrono::steady_clock::now();
+    m_finished_tiles = 0;
+    m_pass_tiles = tile_count;
+    m_report_interval = report_interval;
+    m_pass_running = true;
+
+    if (report_interval.count() > 0)
+        m_reporter = std::thread{&RenderStats::reporter_loop, this};
+}
+
+void RenderStats::end_pass() {
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_pass_running)
+            return;
+
+        m_pass_running = false;
+    }
+
+    m_wake_reporter.notify_all();
+    if (m_reporter.joinable())
+        m_reporter.join();
+
+    std::chrono::duration<double> pass_time = std::chrono::steady_clock::now() - m_pass_start;
+    m_seconds += pass_time.count();
+}
+
+void RenderStats::publish(int thread_index, std::chrono::nanoseconds tile_time) {
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    // Apenas a thread dona escreve no seu bloco, então um load seguido de store basta (sem uma
+    // instrução atômica de leitura-modificação-escrita); a thread relatora apenas lê
+    auto add = [](std::atomic<std::uint64_t> &counter, std::uint64_t value) {
+        counter.store(counter.load(relaxed) + value, relaxed);
+    };
+
+    auto &counters = m_threads[thread_index];
+    auto &local = Stats::t_counters;
+
+    add(counters.primary_rays, local.primary_rays);
+    add(counters.secondary_rays, local.secondary_rays);
+    add(counters.shadow_rays, local.shadow_rays);
+    add(counters.bounces, local.bounces);
+    add(counters.box_tests, local.box_tests);
+    add(counters.primitive_tests, local.primitive_tests);
+    add(counters.tiles, 1);
+
+    auto nanoseconds = std::uint64_t(tile_time.count());
+    add(counters.tile_nanoseconds, nanoseconds);
+    if (nanoseconds > counters.max_tile_nanoseconds.load(relaxed))
+        counters.max_tile_nanoseconds.store(nanoseconds, relaxed);
+
+    local = Stats::RayCounters{};
+    m_finished_tiles.fetch_add(1, relaxed);
+}
+
+RenderStats::Totals RenderStats::totals() const {
+    Totals totals;
+
+    for (int k = 0; k < m_thread_count; ++k)
+        accumulate(totals, m_threads[k]);
+
+    return totals;
+}
+
+RenderStats::Totals RenderStats::thread_totals(int thread_index) const {
+    Totals totals;
+    accumulate(totals, m_threads[thread_index]);
+    return totals;
+}
+
+void RenderStats::reporter_loop() {
+    auto first = totals();
+    bool reported = false;
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+
+    while (!m_wake_reporter.wait_for(lock, m_report_interval, [this]() { return !m_pass_running; })) {
+        auto current = totals();
+        int finished = m_finished_tiles.load(std::memory_order_relaxed);
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_pass_start;
+        auto rays = double(current.primary_rays + current.secondary_rays + current.shadow_rays
+                               - first.primary_rays - first.secondary_rays - first.shadow_rays);
+
+        std::clog << "\r[" << std::setw(3) << (m_pass_tiles > 0 ? 100 * finished / m_pass_tiles : 100) << "%] "
+                  << std::fixed << std::setprecision(2) << 1e-6 * rays / elapsed.count() << " Mraios/s";
+
+        // Estimativa pelo ritmo dos tiles terminados até agora
+        if (finished > 0)
+            std::clog << ", restam ~" << std::setprecision(0) << elapsed.count() * (m_pass_tiles - finished) / finished << "s";
+
+        std::clog << "        " << std::defaultfloat << std::setprecision(6) << std::flush;
+        reported = true;
+    }
+
+    if (reported)
+        std::clog << std::endl;
+}
+
+bool RenderStats::write_json(const char *filename, int image_width, int image_height) const {
+    std::ofstream out{filename};
+
+    auto all = totals();
+    auto rays = double(all.primary_rays + all.secondary_rays + all.shadow_rays);
+
+    out << "{\n";
+    out << "  \"seconds\": " << m_seconds << ",\n";
+    out << "  \"threads\": " << m_thread_count << ",\n";
+    out << "  \"width\": " << image_width << ",\n";
+    out << "  \"height\": " << image_height << ",\n";
+    out << "  \"mrays_per_second\": " << (m_seconds > 0.0 ? 1e-6 * rays / m_seconds : 0.0) << ",\n";
+    out << "  \"samples_per_pixel\": " << double(all.primary_rays) / (double(image_width) * image_height) << ",\n";
+    out << "  \"mean_tile_seconds\": " << (all.tiles > 0 ? all.tile_seconds / all.tiles : 0.0) << ",\n";
+    out << "  \"totals\": {";
+    write_totals_json(out, all);
+    out << "},\n";
+    out << "  \"per_thread\": [";
+
+    for (int k = 0; k < m_thread_count; ++k) {
+        out << (k == 0 ? "\n" : ",\n") << "    {";
+        write_totals_json(out, thread_totals(k));
+        out << "}";
+    }
+
+    out << "\n  ]\n}\n";
+    return bool(out);
+}
@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "../lib/sample_buffer.hpp"
+
+// Pesos da luminância relativa (Rec. 709), usados apenas para decidir quando o pixel convergiu
+static double luminance(const Vec3 &color) {
+    return 0.2126 * color.x() + 0.7152 * color.y() + 0.0722 * color.z();
+}
+
+void PixelEstimate::add(const Vec3 &color) {
+    sum += color;
+    ++count;
+
+    auto value = luminance(color);
+    auto delta = value - luminance_mean;
+    luminance_mean += delta / count;
+    luminance_m2 += delta * (value - luminance_mean);
+}
+
+// Combinação de dois estados de Welford (Chan et al.): a média é ponderada pelo número de amostras e
+// M2 recebe, além das duas somas, o termo da diferença entre as médias
+void PixelEstimate::merge(const PixelEstimate &other) {
+    if (other.count == 0)
+        return;
+
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    auto total = double(count) + other.count;
+    auto delta = other.luminance_mean - luminance_mean;
+
+    sum += other.sum;
+    albedo_sum += other.albedo_sum;
+    normal_sum += other.normal_sum;
+    depth_sum += other.depth_sum;
+    luminance_mean += delta * (other.count / total);
+    luminance_m2 += other.luminance_m2 + delta * delta * (double(count) * other.count / total);
+    count += other.count;
+}
+
+double PixelEstimate::display_error() const {
+    if (count < 2)
+        return HUGE_VAL;
+
+    // NOTE: o piso evita que pixels quase pretos exijam precisão infinita
+    auto display_slope = 0.5 / std::sqrt(std::max(luminance_mean, 1e-3));
+
+    return std::sqrt(variance_of_mean()) * display_slope;
+}
+
+void SampleBuffer::resize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    m_pixels.assign(std::size_t(width) * height, PixelEstimate{});
+}
+
+void SampleBuffer::resolve(Framebuffer &framebuffer) const {
+    framebuffer.resize(m_width, m_height);
+
+    for (auto j = 0; j < m_height; ++j)
+      for (auto i = 0; i < m_width; ++i)
+        framebuffer.set_pixel(i, j, pixel(i, j).mean());
+}
+
+void SampleBuffer::resolve_sample_map(Framebuffer &framebuffer, std::uint32_t max_count) const {
+    framebuffer.resize(m_width, m_height);
+
+    auto scale = max_count > 0 ? 1.0 / max_count : 0.0;
+
+    for (auto j = 0; j < m_height; ++j) {
+      for (auto i = 0; i < m_width; ++i) {
+        auto value = pixel(i, j).count * scale;
+        framebuffer.set_pixel(i, j, Vec3{value, value, value});
+      }
+    }
+}
+
+std::uint64_t SampleBuffer::total_samples() const {
+    std::uint64_t total = 0;
+    for (const auto &estimate : m_pixels)
+        total += estimate.count;
+    return total;
+}
+
+// Cabeçalho do checkpoint, seguido de width * height registros de PixelEstimate. Os números são
+// gravados na ordem de bytes da máquina; o campo byte_order permite detectar um checkpoint vindo de
+// uma máquina com a ordem inversa.
+namespace {
+
+    constexpr char CHECKPOINT_MAGIC[8] = {'R', 'T', 'C', 'K', 'P', 'T', '0', '2'};
+
+    struct CheckpointHeader {
+        char magic[8];
+        std::uint32_t byte_order;
+        std::uint32_t record_size;
+        std::int32_t width;
+        std::int32_t height;
+        std::uint64_t scene_key;
+    };
+
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+    // Registro de um pixel no arquivo: a soma das cores (double, para que continuar a partir do
+    // checkpoint dê exatamente a mesma imagem que renderizar sem interrupção), o estado de Welford, o
+    // número de amostras e as somas dos atributos do primeiro ponto tocado
+    struct CheckpointRecord {
+        double sum[3];
+        double luminance_mean;
+        double luminance_m2;
+        std::uint32_t count;
+        std::uint32_t padding;
+        double albedo_sum[3];
+        double normal_sum[3];
+        double depth_sum;
+    };
+
+    static_assert(sizeof(CheckpointRecord) == SampleBuffer::RECORD_SIZE, "RECORD_SIZE deve ser o tamanho do registro");
+
+    CheckpointRecord make_record(const PixelEstimate &estimate) {
+        return CheckpointRecord{{estimate.sum.x(), estimate.sum.y(), estimate.sum.z()},
+                                estimate.luminance_mean, estimate.luminance_m2, estimate.count, 0,
+                                {estimate.albedo_sum.x(), estimate.albedo_sum.y(), estimate.albedo_sum.z()},
+                                {estimate.normal_sum.x(), estimate.normal_sum.y(), estimate.normal_sum.z()},
+                                estimate.depth_sum};
+    }
+
+    PixelEstimate make_estimate(const CheckpointRecord &record) {
+        PixelEstimate estimate;
+        estimate.sum = Vec3{record.sum[0], record.sum[1], record.sum[2]};
+        estimate.luminance_mean = record.luminance_mean;
+        estimate.luminance_m2 = record.luminance_m2;
+        estimate.count = record.count;
+        estimate.albedo_sum = Vec3{record.albedo_sum[0], record.albedo_sum[1], record.albedo_sum[2]};
+        estimate.normal_sum = Vec3{record.normal_sum[0], record.normal_sum[1], record.normal_sum[2]};
+        estimate.depth_sum = record.depth_sum;
+        return estimate;
+    }
+
+} // namespace
+
+bool SampleBuffer::save(const char *filename, std::uint64_t scene_key) const {
+    CheckpointHeader header{};
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.byte_order = BYTE_ORDER_MARK;
+    header.record_size = sizeof(CheckpointRecord);
+    header.width = m_width;
+    header.height = m_height;
+    header.scene_key = scene_key;
+
+    std::vector<CheckpointRecord> records(m_pixels.size());
+    for (std::size_t k = 0; k < m_pixels.size(); ++k)
+        records[k] = make_record(m_pixels[k]);
+
+    std::string temporary_filename = std::string(filename) + ".tmp";
+
+    {
+        std::ofstream output_file(temporary_filename, std::ofstream::out | std::ofstream::trunc | std::ios_base::binary);
+
+        if (!output_file)
+            return false;
+
+        output_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        output_file.write(reinterpret_cast<const char *>(records.data()), std::streamsize(records.size() * sizeof(CheckpointRecord)));
+
+        if (!output_file.flush())
+            return false;
+    }
+
+    return std::rename(temporary_filename.c_str(), filename) == 0;
+}
+
+bool SampleBuffer::load(const char *filename, std::uint64_t scene_key) {
+    std::uint64_t file_key;
+    return read_checkpoint(filename, &scene_key, file_key);
+}
+
+bool SampleBuffer::load_any(const char *filename, std::uint64_t &scene_key) {
+    return read_checkpoint(filename, nullptr, scene_key);
+}
+
+bool SampleBuffer::read_checkpoint(const char *filename, const std::uint64_t *expected_key, std::uint64_t &scene_key) {
+    std::ifstream input_file(filename, std::ios_base::binary | std::ios_base::ate);
+
+    if (!input_file)
+        return false;
+
+    auto file_size = std::uint64_t(std::streamoff(input_file.tellg()));
+    input_file.seekg(0);
+
+    CheckpointHeader header{};
+    if (!input_file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return false;
+
+    if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 || header.byte_order != BYTE_ORDER_MARK
+        || header.record_size != sizeof(CheckpointRecord) || (expected_key != nullptr && header.scene_key != *expected_key)
+        || header.width <= 0 || header.height <= 0)
+        return false;
+
+    // O tamanho declarado no cabeçalho é conferido com o do arquivo antes de qualquer alocação, para que
+    // um arquivo corrompido seja rejeitado em vez de pedir uma quantidade absurda de memória. Largura e
+    // altura são int32 positivos, então o produto cabe em 64 bits; a divisão evita o estouro na
+    // multiplicação pelo tamanho do registro.
+    auto pixel_count = std::uint64_t(header.width) * std::uint64_t(header.height);
+    auto payload_size = file_size - sizeof(header);
+
+    if (payload_size % sizeof(CheckpointRecord) != 0 || payload_size / sizeof(CheckpointRecord) != pixel_count)
+        return false;
+
+    std::vector<CheckpointRecord> records(pixel_count);
+    if (!input_file.read(reinterpret_cast<char *>(records.data()), std::streamsize(records.size() * sizeof(CheckpointRecord))))
+        return false;
+
+    resize(header.width, header.height);
+
+    for (std::size_t k = 0; k < records.size(); ++k)
+        m_pixels[k] = make_estimate(records[k]);
+
+    scene_key = header.scene_key;
+    return true;
+}
+
+bool SampleBuffer::merge(const SampleBuffer &other) {
+    if (other.m_width != m_width || other.m_height != m_height)
+        return false;
+
+    for (std::size_t k = 0; k < m_pixels.size(); ++k)
+        m_pixels[k].merge(other.m_pixels[k]);
+
+    return true;
+}
+
+void SampleBuffer::pack_region(int start_i, int start_j, int end_i, int end_j, unsigned char *records) const {
+    for (auto j = start_j; j < end_j; ++j) {
+      for (auto i = start_i; i < end_i; ++i) {
+        auto record = make_record(pixel(i, j));
+        std::memcpy(records, &record, sizeof(record));
+        records += sizeof(record);
+      }
+    }
+}
+
+void SampleBuffer::unpack_region(int start_i, int start_j, int end_i, int end_j, const unsigned char *records) {
+    for (auto j = start_j; j < end_j; ++j) {
+      for (auto i = start_i; i < end_i; ++i) {
+        CheckpointRecord record;
+        std::memcpy(&record, records, sizeof(record));
+        pixel(i, j) = make_estimate(record);
+        records += sizeof(record);
+      }
+    }
+}
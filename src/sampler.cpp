@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <array>
+
+#include "../lib/sampler.hpp"
+
+namespace {
+
+    // Todas as permutações de {0, 1, 2, 3}, usadas nos dígitos de base 4 do índice BLUE_NOISE
+    constexpr std::uint8_t BASE4_PERMUTATIONS[24][4] = {
+        {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 1, 3}, {0, 2, 3, 1}, {0, 3, 2, 1}, {0, 3, 1, 2},
+        {1, 0, 2, 3}, {1, 0, 3, 2}, {1, 2, 0, 3}, {1, 2, 3, 0}, {1, 3, 2, 0}, {1, 3, 0, 2},
+        {2, 1, 0, 3}, {2, 1, 3, 0}, {2, 0, 1, 3}, {2, 0, 3, 1}, {2, 3, 0, 1}, {2, 3, 1, 0},
+        {3, 1, 2, 0}, {3, 1, 0, 2}, {3, 2, 1, 0}, {3, 2, 0, 1}, {3, 0, 2, 1}, {3, 0, 1, 2},
+    };
+
+    int ceil_log2(int value) {
+        int log2 = 0;
+        while ((1 << log2) < value)
+            ++log2;
+        return log2;
+    }
+
+    std::uint32_t reverse_bits(std::uint32_t x) {
+        x = (x << 16) | (x >> 16);
+        x = ((x & 0x00ff00ffu) << 8) | ((x & 0xff00ff00u) >> 8);
+        x = ((x & 0x0f0f0f0fu) << 4) | ((x & 0xf0f0f0f0u) >> 4);
+        x = ((x & 0x33333333u) << 2) | ((x & 0xccccccccu) >> 2);
+        x = ((x & 0x55555555u) << 1) | ((x & 0xaaaaaaaau) >> 1);
+        return x;
+    }
+
+    // Intercala os bits de i e j (i nos bits pares): posição do pixel na curva Z
+    std::uint64_t morton_index(std::uint32_t i, std::uint32_t j) {
+        auto spread = [](std::uint64_t x) {
+            x &= 0xffffffffu;
+            x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+            x = (x | (x << 8)) & 0x00ff00ff00ff00ffULL;
+            x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+            x = (x | (x << 2)) & 0x3333333333333333ULL;
+            x = (x | (x << 1)) & 0x5555555555555555ULL;
+            return x;
+        };
+        return spread(i) | (spread(j) << 1);
+    }
+
+    // Permutação de Laine e Karras, com as constantes de Burley (2020): cada bit da saída depende apenas
+    // dele e dos bits menos significativos da entrada
+    std::uint32_t laine_karras_permutation(std::uint32_t x, std::uint32_t seed) {
+        x ^= x * 0x3d20adeau;
+        x += seed;
+        x *= (seed >> 16) | 1u;
+        x ^= x * 0x05526c56u;
+        x ^= x * 0x53a22864u;
+        return x;
+    }
+
+    // Embaralhamento de Owen de uma fração de 32 bits: cada dígito é trocado conforme os dígitos mais
+    // significativos, o que mantém a estratificação da sequência
+    std::uint32_t owen_scramble(std::uint32_t x, std::uint32_t seed) {
+        return reverse_bits(laine_karras_permutation(reverse_bits(x), seed));
+    }
+
+    // Primeira dimensão de Sobol (van der Corput), os bits do índice espelhados, já embaralhada: como
+    // owen_scramble espelha a fração antes de permutar, os dois espelhamentos se cancelam
+    std::uint32_t scrambled_sobol_first(std::uint64_t index, std::uint32_t seed) {
+        return reverse_bits(laine_karras_permutation(std::uint32_t(index), seed));
+    }
+
+    // Segunda dimensão de Sobol: a matriz geradora é a de Pascal módulo 2, e cada coluna é a anterior
+    // combinada (xor) com ela mesma deslocada de um bit. O produto pela matriz é feito um byte do índice
+    // por vez, com a combinação das 8 colunas de cada byte já tabelada (8 tabelas de 256 valores).
+    using SobolTables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+    constexpr SobolTables make_sobol_second_tables() {
+        SobolTables tables{};
+        std::uint32_t column = 1u << 31;
+
+        for (int byte = 0; byte < 8; ++byte) {
+            std::uint32_t columns[8] = {};
+            for (int bit = 0; bit < 8; ++bit, column ^= column >> 1)
+                columns[bit] = column;
+
+            for (int value = 0; value < 256; ++value) {
+                std::uint32_t result = 0;
+                for (int bit = 0; bit < 8; ++bit)
+                    if (value & (1 << bit))
+                        result ^= columns[bit];
+                tables[byte][value] = result;
+            }
+        }
+
+        return tables;
+    }
+
+    constexpr SobolTables SOBOL_SECOND_TABLES = make_sobol_second_tables();
+
+    std::uint32_t sobol_second(std::uint64_t index) {
+        std::uint32_t result = 0;
+        for (int byte = 0; index != 0; ++byte, index >>= 8)
+            result ^= SOBOL_SECOND_TABLES[byte][index & 0xff];
+        return result;
+    }
+
+    double to_unit(std::uint32_t fraction) { return fraction * 0x1p-32; }
+
+} // namespace
+
+Sampler::Sampler(SamplerType type, std::uint64_t seed, int image_width, int image_height, int samples_per_pixel)
+    : m_type{type}, m_seed{seed}, m_image_width{image_width} {
+    // A curva Z cobre o quadrado de lado potência de 2 que contém a imagem; cada pixel ocupa
+    // log2(amostras) bits do índice (arredondado para cima: com menos amostras, só parte deles é usada)
+    m_log2_samples = ceil_log2(std::max(samples_per_pixel, 1));
+    m_base4_digits = ceil_log2(std::max({image_width, image_height, 1})) + (m_log2_samples + 1) / 2;
+}
+
+void Sampler::start_pixel_sample(int i, int j, std::uint32_t sample_index) {
+    m_pixel_index = std::uint64_t(j) * m_image_width + i;
+    m_sample_index = sample_index;
+    m_dimension = 0;
+
+    if (m_type == SamplerType::INDEPENDENT)
+        Random::begin_path(m_seed, m_pixel_index, sample_index);
+    else if (m_type == SamplerType::BLUE_NOISE)
+        m_morton_index = (morton_index(std::uint32_t(i), std::uint32_t(j)) << m_log2_samples) | sample_index;
+}
+
+void Sampler::start_bounce(int bounce) {
+    m_dimension = std::uint32_t(bounce) << 16;
+
+    if (m_type == SamplerType::INDEPENDENT)
+        Random::begin_bounce(std::uint64_t(bounce));
+}
+
+void Sampler::resume(int i, int j, std::uint32_t sample_index, int bounce) {
+    m_pixel_index = std::uint64_t(j) * m_image_width + i;
+    m_sample_index = sample_index;
+    m_dimension = std::uint32_t(bounce) << 16;
+
+    if (m_type == SamplerType::INDEPENDENT)
+        Random::begin_path(m_seed, m_pixel_index, sample_index, std::uint64_t(bounce));
+    else if (m_type == SamplerType::BLUE_NOISE)
+        m_morton_index = (morton_index(std::uint32_t(i), std::uint32_t(j)) << m_log2_samples) | sample_index;
+}
+
+std::uint64_t Sampler::dimension_hash() const {
+    // Em BLUE_NOISE a sequência é uma só para a imagem toda; os pixels já se diferenciam pelo índice
+    std::uint64_t pixel = m_type == SamplerType::SOBOL ? m_pixel_index : 0;
+    return Random::mix_bits(m_seed ^ Random::mix_bits(pixel ^ Random::mix_bits(m_dimension + 0x9e3779b97f4a7c15ULL)));
+}
+
+std::uint64_t Sampler::sobol_index(std::uint64_t dimension_hash) const {
+    // A ordem das amostras do pixel é embaralhada, com o próprio índice tratado como uma fração: as 2^k
+    // primeiras amostras viram um bloco alinhado de 2^k índices consecutivos da sequência, que também
+    // forma uma rede, e cada dimensão recebe um bloco e uma ordem diferentes.
+    if (m_type == SamplerType::SOBOL)
+        return owen_scramble(m_sample_index, std::uint32_t(Random::mix_bits(dimension_hash)));
+
+    // BLUE_NOISE: cada dígito de base 4 do índice (curva Z seguida da amostra) é permutado conforme os
+    // dígitos acima dele. Pixels de um mesmo bloco de 4^n pixels compartilham os dígitos de cima, e as
+    // amostras do bloco juntas percorrem um trecho contíguo da sequência.
+    bool odd_log2 = (m_log2_samples & 1) != 0;
+    std::uint64_t index = 0;
+
+    for (int digit = m_base4_digits - 1; digit >= (odd_log2 ? 1 : 0); --digit) {
+        int shift = 2 * digit - (odd_log2 ? 1 : 0);
+        auto value = (m_morton_index >> shift) & 3;
+        // Hash multiplicativo (Fibonacci) dos dígitos de cima, levado para [0, 24) pelos bits mais altos:
+        // bem mais barato que mix_bits, e qualquer escolha de permutação mantém as redes
+        auto mixed = ((m_morton_index >> (shift + 2)) ^ dimension_hash) * 0x9e3779b97f4a7c15ULL;
+        auto permutation = ((mixed >> 32) * 24) >> 32;
+        index |= std::uint64_t(BASE4_PERMUTATIONS[permutation][value]) << shift;
+    }
+
+    // Com um número ímpar de bits de amostra, o último dígito é de base 2
+    if (odd_log2)
+        index |= (m_morton_index & 1) ^ (Random::mix_bits((m_morton_index >> 1) ^ dimension_hash) & 1);
+
+    return index;
+}
+
+double Sampler::quasi_random_1d() {
+    auto hash = dimension_hash();
+    auto index = sobol_index(hash);
+    m_dimension += 1;
+
+    return to_unit(scrambled_sobol_first(index, std::uint32_t(hash)));
+}
+
+Sampling::Point2 Sampler::quasi_random_2d() {
+    auto hash = dimension_hash();
+    auto index = sobol_index(hash);
+    m_dimension += 2;
+
+    return Sampling::Point2{to_unit(scrambled_sobol_first(index, std::uint32_t(hash))),
+                            to_unit(owen_scramble(sobol_second(index), std::uint32_t(hash >> 32)))};
+}
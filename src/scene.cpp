@@ -0,0 +1,592 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "../lib/scene.hpp"
+#include "../lib/instance.hpp"
+#include "../lib/mapped_file.hpp"
+#include "../lib/material.hpp"
+#include "../lib/random.hpp"
+#include "../lib/sphere_soa.hpp"
+
+namespace {
+
+    // Cabeçalho da cena compilada. Cada seção começa em um múltiplo de SECTION_ALIGNMENT bytes e a sua
+    // posição fica registrada aqui; os números são gravados na ordem de bytes da máquina, e byte_order
+    // permite rejeitar um arquivo vindo de uma máquina com a ordem inversa.
+    constexpr char COMPILED_MAGIC[8] = {'R', 'T', 'S', 'C', 'E', 'N', '0', '1'};
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304u;
+    constexpr std::size_t SECTION_ALIGNMENT = 64;
+
+    struct CompiledHeader {
+        char magic[8];
+        std::uint32_t byte_order;
+        std::uint32_t node_size;
+
+        std::int32_t image_width;
+        std::int32_t samples_per_pixel;
+        std::int32_t max_depth;
+        std::uint32_t has_camera;
+        double camera[10]; // lookfrom, lookat, vup e vfov
+
+        std::uint64_t scene_hash;
+        std::uint64_t material_count;
+        std::uint64_t sphere_count;
+        std::uint64_t node_count;
+
+        std::uint64_t materials_offset;
+        std::uint64_t center_x_offset;
+        std::uint64_t center_y_offset;
+        std::uint64_t center_z_offset;
+        std::uint64_t radius_offset;
+        std::uint64_t material_index_offset;
+        std::uint64_t nodes_offset;
+    };
+
+    struct CompiledMaterial {
+        std::uint32_t type;
+        std::uint32_t padding;
+        double albedo[3];
+    };
+
+    std::uint64_t align_offset(std::uint64_t offset) {
+        return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    }
+
+    // Divide a linha em palavras separadas por espaços ou tabs
+    std::vector<std::string_view> split_tokens(std::string_view line) {
+        std::vector<std::string_view> tokens;
+
+        std::size_t position = 0;
+        while (position < line.size()) {
+            auto start = line.find_first_not_of(" \t\r", position);
+            if (start == std::string_view::npos)
+                break;
+
+            auto end = line.find_first_of(" \t\r", start);
+            if (end == std::string_view::npos)
+                end = line.size();
+
+            tokens.push_back(line.substr(start, end - start));
+            position = end;
+        }
+
+        return tokens;
+    }
+
+    bool parse_number(std::string_view token, double &value) {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        return result.ec == std::errc{} && result.ptr == token.data() + token.size();
+    }
+
+    bool parse_number(std::string_view token, int &value) {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        return result.ec == std::errc{} && result.ptr == token.data() + token.size();
+    }
+
+    // Lê count números a partir de tokens[first]
+    bool parse_numbers(const std::vector<std::string_view> &tokens, std::size_t first, std::size_t count, double *values) {
+        for (std::size_t k = 0; k < count; ++k)
+            if (!parse_number(tokens[first + k], values[k]))
+                return false;
+
+        return true;
+    }
+
+} // namespace
+
+bool Scene::parse(std::string_view text, std::string &error, const std::string &directory) {
+    *this = Scene{};
+
+    // Nome de cada material, na mesma ordem de m_materials, e arquivo de cada malha, na ordem de m_meshes
+    std::vector<std::string_view> material_names;
+    std::vector<std::string> mesh_paths;
+
+    std::size_t line_number = 0;
+    std::size_t position = 0;
+
+    while (position < text.size()) {
+        auto line_end = text.find('\n', position);
+        if (line_end == std::string_view::npos)
+            line_end = text.size();
+
+        auto line = text.substr(position, line_end - position);
+        position = line_end + 1;
+        ++line_number;
+
+        auto comment = line.find('#');
+        if (comment != std::string_view::npos)
+            line = line.substr(0, comment);
+
+        auto tokens = split_tokens(line);
+        if (tokens.empty())
+            continue;
+
+        auto fail = [&](const std::string &message) {
+            error = "linha " + std::to_string(line_number) + ": " + message;
+            return false;
+        };
+
+        auto command = tokens[0];
+
+        if (command == "image" || command == "samples" || command == "depth") {
+            int value;
+            if (tokens.size() != 2 || !parse_number(tokens[1], value) || value < 1)
+                return fail("'" + std::string(command) + "' espera um inteiro positivo");
+
+            if (command == "image")
+                m_image_width = value;
+            else if (command == "samples")
+                m_samples_per_pixel = value;
+            else
+                m_max_depth = value;
+        }
+
+        else if (command == "camera") {
+            double values[10];
+            if (tokens.size() != 11 || !parse_numbers(tokens, 1, 10, values))
+                return fail("'camera' espera origem (x y z), alvo (x y z), vetor para cima (x y z) e campo de visão");
+
+            m_camera = CameraSettings{Point3{values[0], values[1], values[2]}, Point3{values[3], values[4], values[5]},
+                                      Vec3{values[6], values[7], values[8]}, values[9]};
+
+            if ((m_camera.lookfrom - m_camera.lookat).near_zero() || !(values[9] > 0.0 && values[9] < 180.0))
+                return fail("câmera inválida (origem igual ao alvo ou campo de visão fora de (0, 180))");
+
+            m_has_camera = true;
+        }
+
+        else if (command == "material") {
+            double albedo[3];
+            if (tokens.size() != 6 || !parse_numbers(tokens, 3, 3, albedo))
+                return fail("'material' espera nome, tipo (lambertian, metal ou emissive) e albedo (r g b)");
+
+            MaterialDescription material{MaterialDescription::Type::LAMBERTIAN, Vec3{albedo[0], albedo[1], albedo[2]}};
+
+            if (tokens[2] == "metal")
+                material.type = MaterialDescription::Type::METAL;
+            else if (tokens[2] == "emissive")
+                material.type = MaterialDescription::Type::EMISSIVE;
+            else if (tokens[2] != "lambertian")
+                return fail("tipo de material desconhecido '" + std::string(tokens[2]) + "'");
+
+            if (std::find(material_names.begin(), material_names.end(), tokens[1]) != material_names.end())
+                return fail("material '" + std::string(tokens[1]) + "' definido mais de uma vez");
+
+            material_names.push_back(tokens[1]);
+            m_materials.push_back(material);
+        }
+
+        else if (command == "sphere") {
+            double values[4];
+            if (tokens.size() != 6 || !parse_numbers(tokens, 1, 4, values))
+                return fail("'sphere' espera centro (x y z), raio e nome do material");
+
+            if (!(values[3] >= 0.0))
+                return fail("raio negativo");
+
+            auto material = std::find(material_names.begin(), material_names.end(), tokens[5]);
+            if (material == material_names.end())
+                return fail("material '" + std::string(tokens[5]) + "' não definido");
+
+            m_spheres.push_back(SphereDescription{Point3{values[0], values[1], values[2]}, values[3],
+                                                  std::uint32_t(material - material_names.begin())});
+        }
+
+        else if (command == "mesh" || command == "instance") {
+            if (command == "mesh" ? tokens.size() != 3 : tokens.size() < 3)
+                return fail("'" + std::string(command) + "' espera o arquivo da malha e o nome do material"
+                            + (command == "mesh" ? "" : ", seguidos das transformações"));
+
+            auto material = std::find(material_names.begin(), material_names.end(), tokens[2]);
+            if (material == material_names.end())
+                return fail("material '" + std::string(tokens[2]) + "' não definido");
+
+            std::filesystem::path path{std::string(tokens[1])};
+            if (path.is_relative() && !directory.empty())
+                path = std::filesystem::path{directory} / path;
+
+            InstanceDescription instance{0, Transform{}, std::uint32_t(material - material_names.begin())};
+
+            for (std::size_t k = 3; k < tokens.size();) {
+                auto operation = tokens[k];
+                double values[4];
+
+                if (operation == "translate" && k + 3 < tokens.size() && parse_numbers(tokens, k + 1, 3, values)) {
+                    instance.transform = Transform::translate(Vec3{values[0], values[1], values[2]}) * instance.transform;
+                    k += 4;
+                }
+                else if (operation == "rotate" && k + 4 < tokens.size() && parse_numbers(tokens, k + 1, 4, values)
+                         && !Vec3{values[0], values[1], values[2]}.near_zero()) {
+                    instance.transform = Transform::rotate(Vec3{values[0], values[1], values[2]}, values[3]) * instance.transform;
+                    k += 5;
+                }
+                else if (operation == "scale" && k + 1 < tokens.size() && parse_number(tokens[k + 1], values[0])) {
+                    // Um fator para os três eixos, ou três fatores
+                    bool per_axis = k + 3 < tokens.size() && parse_numbers(tokens, k + 1, 3, values);
+                    Vec3 factors = per_axis ? Vec3{values[0], values[1], values[2]} : Vec3{values[0], values[0], values[0]};
+
+                    instance.transform = Transform::scale(factors) * instance.transform;
+                    k += per_axis ? 4 : 2;
+                }
+                else
+                    return fail("transformação inválida a partir de '" + std::string(operation)
+                                + "' (use translate x y z, rotate x y z graus ou scale s)");
+            }
+
+            if (!(std::fabs(instance.transform.determinant()) > 1e-12))
+                return fail("a transformação não é inversível");
+
+            // Um arquivo que já apareceu reaproveita a malha carregada
+            auto loaded = std::find(mesh_paths.begin(), mesh_paths.end(), path.string());
+            instance.mesh = std::uint32_t(loaded - mesh_paths.begin());
+
+            if (loaded == mesh_paths.end()) {
+                auto mesh = std::make_shared<TriangleMesh>();
+                std::string mesh_error;
+
+                if (!mesh->load(path.string().c_str(), instance.material, mesh_error))
+                    return fail("malha " + path.string() + ": " + mesh_error);
+
+                mesh_paths.push_back(path.string());
+                m_meshes.push_back(std::move(mesh));
+            }
+
+            m_instances.push_back(instance);
+        }
+
+        else if (command == "key") {
+            double frame;
+            if (tokens.size() < 3 || !parse_number(tokens[1], frame))
+                return fail("'key' espera o quadro, o que é animado (camera ou sphere) e os valores");
+
+            if (tokens[2] == "camera") {
+                double values[10];
+                if (tokens.size() != 13 || !parse_numbers(tokens, 3, 10, values))
+                    return fail("'key camera' espera origem (x y z), alvo (x y z), vetor para cima (x y z) e campo de visão");
+
+                CameraSettings camera{Point3{values[0], values[1], values[2]}, Point3{values[3], values[4], values[5]},
+                                      Vec3{values[6], values[7], values[8]}, values[9]};
+
+                if ((camera.lookfrom - camera.lookat).near_zero() || !(values[9] > 0.0 && values[9] < 180.0))
+                    return fail("câmera inválida (origem igual ao alvo ou campo de visão fora de (0, 180))");
+
+                m_animation.add_camera_key(frame, camera);
+            }
+
+            else if (tokens[2] == "sphere") {
+                int sphere;
+                double center[3];
+                if (tokens.size() != 7 || !parse_number(tokens[3], sphere) || !parse_numbers(tokens, 4, 3, center))
+                    return fail("'key sphere' espera o índice da esfera e o centro (x y z)");
+
+                if (sphere < 0 || std::size_t(sphere) >= m_spheres.size())
+                    return fail("esfera " + std::string(tokens[3]) + " não definida");
+
+                m_animation.add_sphere_key(std::uint32_t(sphere), frame, Point3{center[0], center[1], center[2]});
+            }
+
+            else
+                return fail("'key' anima apenas 'camera' ou 'sphere'");
+        }
+
+        else
+            return fail("instrução desconhecida '" + std::string(command) + "'");
+    }
+
+    update_hash();
+    return true;
+}
+
+void Scene::update_hash() {
+    // Só o que muda o valor das amostras: as amostras por pixel podem aumentar entre execuções com
+    // --resume, e o tamanho da imagem já entra na chave do checkpoint (Render::checkpoint_key)
+    std::uint64_t key = Random::mix_bits(std::uint64_t(m_max_depth));
+
+    if (m_has_camera) {
+        Random::mix_vector(key, m_camera.lookfrom);
+        Random::mix_vector(key, m_camera.lookat);
+        Random::mix_vector(key, m_camera.vup);
+        Random::mix_double(key, m_camera.vfov);
+    }
+
+    for (const auto &material : m_materials) {
+        key = Random::mix_bits(key ^ std::uint64_t(material.type));
+        Random::mix_vector(key, material.albedo);
+    }
+
+    for (const auto &sphere : m_spheres) {
+        Random::mix_vector(key, sphere.center);
+        Random::mix_double(key, sphere.radius);
+        key = Random::mix_bits(key ^ sphere.material);
+    }
+
+    // As malhas entram pelo tamanho e pela caixa, sem percorrer todos os vértices
+    for (const auto &mesh : m_meshes) {
+        key = Random::mix_bits(key ^ mesh->vertex_count() ^ (std::uint64_t(mesh->triangle_count()) << 32));
+        key = Random::mix_bits(key ^ mesh->material());
+        Random::mix_vector(key, mesh->bounding_box().min());
+        Random::mix_vector(key, mesh->bounding_box().max());
+    }
+
+    for (const auto &instance : m_instances) {
+        key = Random::mix_bits(key ^ instance.mesh ^ (std::uint64_t(instance.material) << 32));
+        for (int row = 0; row < 3; ++row)
+            for (int column = 0; column < 4; ++column)
+                Random::mix_double(key, instance.transform(row, column));
+    }
+
+    m_hash = key;
+}
+
+bool Scene::load(const char *filename, std::string &error) {
+    MappedFile file;
+
+    if (!file.open(filename)) {
+        error = "não foi possível abrir o arquivo";
+        return false;
+    }
+
+    if (file.size() >= sizeof(COMPILED_MAGIC) && std::memcmp(file.data(), COMPILED_MAGIC, sizeof(COMPILED_MAGIC)) == 0)
+        return load_compiled(file.data(), file.size(), error);
+
+    return parse(std::string_view{reinterpret_cast<const char *>(file.data()), file.size()}, error,
+                 std::filesystem::path{filename}.parent_path().string());
+}
+
+bool Scene::compile(const char *filename) const {
+    if (!m_meshes.empty())
+        return false;
+
+    // As esferas são gravadas na ordem das folhas, então a BVH pode ser usada sem nenhuma permutação
+    std::vector<AABB> bounds;
+    bounds.reserve(m_spheres.size());
+    for (const auto &sphere : m_spheres) {
+        Vec3 radius_vec{sphere.radius, sphere.radius, sphere.radius};
+        bounds.push_back(AABB{sphere.center - radius_vec, sphere.center + radius_vec});
+    }
+
+    std::vector<std::uint32_t> order;
+    auto nodes = build_bvh(bounds, order);
+
+    CompiledHeader header{};
+    std::memcpy(header.magic, COMPILED_MAGIC, sizeof(header.magic));
+    header.byte_order = BYTE_ORDER_MARK;
+    header.node_size = sizeof(BVHNode);
+    header.image_width = m_image_width;
+    header.samples_per_pixel = m_samples_per_pixel;
+    header.max_depth = m_max_depth;
+    header.has_camera = m_has_camera;
+
+    double camera[10] = {m_camera.lookfrom.x(), m_camera.lookfrom.y(), m_camera.lookfrom.z(),
+                         m_camera.lookat.x(), m_camera.lookat.y(), m_camera.lookat.z(),
+                         m_camera.vup.x(), m_camera.vup.y(), m_camera.vup.z(), m_camera.vfov};
+    std::memcpy(header.camera, camera, sizeof(camera));
+
+    header.scene_hash = m_hash;
+    header.material_count = m_materials.size();
+    header.sphere_count = m_spheres.size();
+    header.node_count = nodes.size();
+
+    auto count = m_spheres.size();
+    header.materials_offset = align_offset(sizeof(CompiledHeader));
+    header.center_x_offset = align_offset(header.materials_offset + m_materials.size() * sizeof(CompiledMaterial));
+    header.center_y_offset = align_offset(header.center_x_offset + count * sizeof(double));
+    header.center_z_offset = align_offset(header.center_y_offset + count * sizeof(double));
+    header.radius_offset = align_offset(header.center_z_offset + count * sizeof(double));
+    header.material_index_offset = align_offset(header.radius_offset + count * sizeof(double));
+    header.nodes_offset = align_offset(header.material_index_offset + count * sizeof(std::uint32_t));
+
+    std::vector<unsigned char> image(header.nodes_offset + nodes.size() * sizeof(BVHNode), 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    auto *materials = reinterpret_cast<CompiledMaterial *>(image.data() + header.materials_offset);
+    for (std::size_t k = 0; k < m_materials.size(); ++k) {
+        const auto &albedo = m_materials[k].albedo;
+        materials[k] = CompiledMaterial{std::uint32_t(m_materials[k].type), 0, {albedo.x(), albedo.y(), albedo.z()}};
+    }
+
+    auto *center_x = reinterpret_cast<double *>(image.data() + header.center_x_offset);
+    auto *center_y = reinterpret_cast<double *>(image.data() + header.center_y_offset);
+    auto *center_z = reinterpret_cast<double *>(image.data() + header.center_z_offset);
+    auto *radius = reinterpret_cast<double *>(image.data() + header.radius_offset);
+    auto *material_index = reinterpret_cast<std::uint32_t *>(image.data() + header.material_index_offset);
+
+    for (std::size_t k = 0; k < count; ++k) {
+        const auto &sphere = m_spheres[order[k]];
+        center_x[k] = sphere.center.x();
+        center_y[k] = sphere.center.y();
+        center_z[k] = sphere.center.z();
+        radius[k] = sphere.radius;
+        material_index[k] = sphere.material;
+    }
+
+    if (!nodes.empty())
+        std::memcpy(image.data() + header.nodes_offset, nodes.data(), nodes.size() * sizeof(BVHNode));
+
+    // Mesmo cuidado dos checkpoints: arquivo temporário e depois a troca pelo definitivo
+    std::string temporary_filename = std::string(filename) + ".tmp";
+
+    {
+        std::ofstream output_file(temporary_filename, std::ofstream::out | std::ofstream::trunc | std::ios_base::binary);
+
+        if (!output_file)
+            return false;
+
+        output_file.write(reinterpret_cast<const char *>(image.data()), std::streamsize(image.size()));
+
+        if (!output_file.flush())
+            return false;
+    }
+
+    return std::rename(temporary_filename.c_str(), filename) == 0;
+}
+
+bool Scene::load_compiled(const unsigned char *data, std::size_t size, std::string &error) {
+    *this = Scene{};
+
+    auto fail = [&](const char *message) {
+        error = message;
+        return false;
+    };
+
+    if (size < sizeof(CompiledHeader))
+        return fail("cena compilada truncada");
+
+    CompiledHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.byte_order != BYTE_ORDER_MARK || header.node_size != sizeof(BVHNode))
+        return fail("cena compilada em outra máquina ou por outra versão do programa");
+
+    auto section_fits = [&](std::uint64_t offset, std::uint64_t count, std::size_t element_size) {
+        return offset <= size && offset % SECTION_ALIGNMENT == 0 && count <= (size - offset) / element_size;
+    };
+
+    auto count = header.sphere_count;
+
+    if (!section_fits(header.materials_offset, header.material_count, sizeof(CompiledMaterial))
+        || !section_fits(header.center_x_offset, count, sizeof(double))
+        || !section_fits(header.center_y_offset, count, sizeof(double))
+        || !section_fits(header.center_z_offset, count, sizeof(double))
+        || !section_fits(header.radius_offset, count, sizeof(double))
+        || !section_fits(header.material_index_offset, count, sizeof(std::uint32_t))
+        || !section_fits(header.nodes_offset, header.node_count, sizeof(BVHNode)))
+        return fail("cena compilada truncada");
+
+    m_image_width = header.image_width;
+    m_samples_per_pixel = header.samples_per_pixel;
+    m_max_depth = header.max_depth;
+    m_has_camera = header.has_camera != 0;
+    m_camera = CameraSettings{Point3{header.camera[0], header.camera[1], header.camera[2]},
+                              Point3{header.camera[3], header.camera[4], header.camera[5]},
+                              Vec3{header.camera[6], header.camera[7], header.camera[8]}, header.camera[9]};
+
+    m_materials.resize(header.material_count);
+    for (std::size_t k = 0; k < m_materials.size(); ++k) {
+        CompiledMaterial material;
+        std::memcpy(&material, data + header.materials_offset + k * sizeof(CompiledMaterial), sizeof(material));
+
+        if (material.type > std::uint32_t(MaterialDescription::Type::EMISSIVE))
+            return fail("material inválido na cena compilada");
+
+        m_materials[k] = MaterialDescription{MaterialDescription::Type(material.type),
+                                             Vec3{material.albedo[0], material.albedo[1], material.albedo[2]}};
+    }
+
+    // NOTE: as seções são alinhadas a 64 bytes e o mapeamento começa no início de uma página, então
+    // os ponteiros abaixo estão sempre alinhados para os tipos lidos
+    auto *material_index = reinterpret_cast<const std::uint32_t *>(data + header.material_index_offset);
+    auto *mapped_nodes = reinterpret_cast<const BVHNode *>(data + header.nodes_offset);
+
+    // Cópia em bloco dos nós mapeados, sem interpretar nada objeto a objeto
+    std::vector<BVHNode> nodes(mapped_nodes, mapped_nodes + header.node_count);
+
+    // Um arquivo corrompido não pode fazer a travessia ler fora dos vetores
+    if (std::any_of(material_index, material_index + count, [&](std::uint32_t index) { return index >= header.material_count; }))
+        return fail("material inválido na cena compilada");
+
+    if (!valid_bvh_nodes(nodes.data(), nodes.size(), count))
+        return fail("BVH inválida na cena compilada");
+
+    auto sphere_array = [&](std::uint64_t offset) { return reinterpret_cast<const double *>(data + offset); };
+
+    SphereSoA spheres;
+    spheres.assign(count, sphere_array(header.center_x_offset), sphere_array(header.center_y_offset),
+                   sphere_array(header.center_z_offset), sphere_array(header.radius_offset), material_index);
+
+    for (std::size_t k = 0; k < count; ++k) {
+        if (m_materials[material_index[k]].type == MaterialDescription::Type::EMISSIVE)
+            m_compiled_lights.push_back(SphereDescription{spheres.center(k), sphere_array(header.radius_offset)[k], material_index[k]});
+    }
+
+    m_compiled = std::make_shared<BVH>(std::move(nodes), std::move(spheres));
+    m_compiled_sphere_count = count;
+    m_hash = header.scene_hash;
+
+    return true;
+}
+
+MaterialTable Scene::make_materials() const {
+    MaterialTable materials;
+
+    // Os índices da tabela são os mesmos de m_materials
+    for (const auto &material : m_materials) {
+        if (material.type == MaterialDescription::Type::METAL)
+            materials.add(Metal{material.albedo});
+        else if (material.type == MaterialDescription::Type::EMISSIVE)
+            materials.add(Emissive{material.albedo});
+        else
+            materials.add(Lambertian{material.albedo});
+    }
+
+    return materials;
+}
+
+HittableList Scene::world() const {
+    HittableList world;
+    world.materials = make_materials();
+
+    if (m_compiled) {
+        world.set_acceleration(m_compiled);
+
+        // As esferas da BVH compilada não são objetos; as luzes ganham cópias próprias
+        for (const auto &light : m_compiled_lights)
+            world.lights.add(std::make_shared<Sphere>(light.center, light.radius, light.material), world.materials.emission(light.material));
+
+        return world;
+    }
+
+    world.objects.reserve(m_spheres.size() + m_instances.size());
+    for (const auto &sphere : m_spheres)
+        world.objects.push_back(std::make_shared<Sphere>(sphere.center, sphere.radius, sphere.material));
+
+    // Uma cópia sem transformação e com o material da malha é a própria malha
+    for (const auto &instance : m_instances) {
+        const auto &mesh = m_meshes[instance.mesh];
+
+        if (instance.transform.is_identity() && instance.material == mesh->material())
+            world.objects.push_back(mesh);
+        else
+            world.objects.push_back(std::make_shared<Instance>(mesh, instance.transform, instance.material));
+    }
+
+    world.build_acceleration();
+    world.lights.add_emissive(world.objects, world.materials);
+    return world;
+}
+
+void Scene::configure(Render &render) const {
+    if (m_image_width > 0)
+        render.set_image_width(m_image_width);
+    if (m_samples_per_pixel > 0)
+        render.set_samples_per_pixel(m_samples_per_pixel);
+    if (m_max_depth > 0)
+        render.set_max_depth(m_max_depth);
+    if (m_has_camera)
+        render.set_camera(m_camera);
+}
@@ -0,0 +1,417 @@
+#include <cmath>
+#include <limits>
+
+#include "../lib/sphere_soa.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RT_HAS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+    // Ponteiros para os vetores de esferas e o raio já decomposto em escalares, que é o que os
+    // kernels precisam para testar o trecho [first, end)
+    struct KernelInput {
+        const double *center_x;
+        const double *center_y;
+        const double *center_z;
+        const double *radius;
+        std::size_t first;
+        std::size_t end;
+        double origin[3];
+        double direction[3];
+        double a; // d * d
+        double t_min;
+    };
+
+    // Todos os kernels seguem a mesma conta de Sphere::hit (ver objects.cpp): para cada esfera,
+    // h = d * (C - Q), c = (C - Q)² - r², discriminante = h² - ac e t = (h -/+ sqrt(discriminante)) / a.
+    // Retornam o índice da esfera mais próxima com t em (t_min, t_max), ou -1, e atualizam t_max.
+
+    long closest_sphere_scalar(const KernelInput &in, double &t_max) {
+        long closest = -1;
+
+        for (std::size_t k = in.first; k < in.end; ++k) {
+            double ocx = in.center_x[k] - in.origin[0];
+            double ocy = in.center_y[k] - in.origin[1];
+            double ocz = in.center_z[k] - in.origin[2];
+
+            double h = in.direction[0] * ocx + in.direction[1] * ocy + in.direction[2] * ocz;
+            double c = (ocx * ocx + ocy * ocy + ocz * ocz) - in.radius[k] * in.radius[k];
+            double discriminant = h * h - in.a * c;
+
+            if (!(discriminant >= 0))
+                continue;
+
+            double sqrt_discriminant = std::sqrt(discriminant);
+            double t = (h - sqrt_discriminant) / in.a;
+
+            if (!(t > in.t_min && t < t_max)) {
+                t = (h + sqrt_discriminant) / in.a;
+
+                if (!(t > in.t_min && t < t_max))
+                    continue;
+            }
+
+            t_max = t;
+            closest = long(k);
+        }
+
+        return closest;
+    }
+
+#ifdef RT_HAS_X86_KERNELS
+
+    // Cada lane guarda o melhor t e o índice (como double, exato até 2^53) que encontrou. No final,
+    // a lane com o menor t vence.
+    long pick_closest_lane(const double *lane_t, const double *lane_index, int lanes, double &t_max) {
+        long closest = -1;
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            if (lane_index[lane] >= 0 && lane_t[lane] < t_max) {
+                t_max = lane_t[lane];
+                closest = long(lane_index[lane]);
+            }
+        }
+
+        return closest;
+    }
+
+    __attribute__((target("sse2")))
+    long closest_sphere_sse2(const KernelInput &in, double &t_max) {
+        const __m128d origin_x = _mm_set1_pd(in.origin[0]);
+        const __m128d origin_y = _mm_set1_pd(in.origin[1]);
+        const __m128d origin_z = _mm_set1_pd(in.origin[2]);
+        const __m128d direction_x = _mm_set1_pd(in.direction[0]);
+        const __m128d direction_y = _mm_set1_pd(in.direction[1]);
+        const __m128d direction_z = _mm_set1_pd(in.direction[2]);
+        const __m128d a = _mm_set1_pd(in.a);
+        const __m128d t_min = _mm_set1_pd(in.t_min);
+        const __m128d end = _mm_set1_pd(double(in.end));
+        const __m128d zero = _mm_setzero_pd();
+
+        __m128d best_t = _mm_set1_pd(t_max);
+        __m128d best_index = _mm_set1_pd(-1.0);
+        __m128d index = _mm_set_pd(double(in.first + 1), double(in.first));
+        const __m128d index_step = _mm_set1_pd(2.0);
+
+        for (std::size_t k = in.first; k < in.end; k += 2) {
+            __m128d ocx = _mm_sub_pd(_mm_loadu_pd(in.center_x + k), origin_x);
+            __m128d ocy = _mm_sub_pd(_mm_loadu_pd(in.center_y + k), origin_y);
+            __m128d ocz = _mm_sub_pd(_mm_loadu_pd(in.center_z + k), origin_z);
+            __m128d radius = _mm_loadu_pd(in.radius + k);
+
+            __m128d h = _mm_add_pd(_mm_add_pd(_mm_mul_pd(direction_x, ocx), _mm_mul_pd(direction_y, ocy)), _mm_mul_pd(direction_z, ocz));
+            __m128d oc2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(ocx, ocx), _mm_mul_pd(ocy, ocy)), _mm_mul_pd(ocz, ocz));
+            __m128d c = _mm_sub_pd(oc2, _mm_mul_pd(radius, radius));
+            __m128d discriminant = _mm_sub_pd(_mm_mul_pd(h, h), _mm_mul_pd(a, c));
+
+            // NaN (esferas de preenchimento) falha em qualquer comparação ordenada
+            __m128d valid = _mm_and_pd(_mm_cmpge_pd(discriminant, zero), _mm_cmplt_pd(index, end));
+
+            // A maioria dos grupos não tem nenhuma esfera no caminho do raio: pula a raíz e as divisões
+            if (_mm_movemask_pd(valid) == 0) {
+                index = _mm_add_pd(index, index_step);
+                continue;
+            }
+
+            __m128d sqrt_discriminant = _mm_sqrt_pd(_mm_max_pd(discriminant, zero));
+
+            __m128d t1 = _mm_div_pd(_mm_sub_pd(h, sqrt_discriminant), a);
+            __m128d t2 = _mm_div_pd(_mm_add_pd(h, sqrt_discriminant), a);
+
+            __m128d t1_ok = _mm_and_pd(_mm_cmpgt_pd(t1, t_min), _mm_cmplt_pd(t1, best_t));
+            __m128d t2_ok = _mm_and_pd(_mm_cmpgt_pd(t2, t_min), _mm_cmplt_pd(t2, best_t));
+
+            __m128d t = _mm_or_pd(_mm_and_pd(t1_ok, t1), _mm_andnot_pd(t1_ok, t2));
+            __m128d accept = _mm_and_pd(valid, _mm_or_pd(t1_ok, t2_ok));
+
+            best_t = _mm_or_pd(_mm_and_pd(accept, t), _mm_andnot_pd(accept, best_t));
+            best_index = _mm_or_pd(_mm_and_pd(accept, index), _mm_andnot_pd(accept, best_index));
+            index = _mm_add_pd(index, index_step);
+        }
+
+        alignas(16) double lane_t[2];
+        alignas(16) double lane_index[2];
+        _mm_store_pd(lane_t, best_t);
+        _mm_store_pd(lane_index, best_index);
+
+        return pick_closest_lane(lane_t, lane_index, 2, t_max);
+    }
+
+    // NOTE: apenas "avx2" (sem "fma") para que o compilador não funda multiplicações e somas, o que
+    // mudaria o arredondamento em relação aos outros kernels
+    __attribute__((target("avx2")))
+    long closest_sphere_avx2(const KernelInput &in, double &t_max) {
+        const __m256d origin_x = _mm256_set1_pd(in.origin[0]);
+        const __m256d origin_y = _mm256_set1_pd(in.origin[1]);
+        const __m256d origin_z = _mm256_set1_pd(in.origin[2]);
+        const __m256d direction_x = _mm256_set1_pd(in.direction[0]);
+        const __m256d direction_y = _mm256_set1_pd(in.direction[1]);
+        const __m256d direction_z = _mm256_set1_pd(in.direction[2]);
+        const __m256d a = _mm256_set1_pd(in.a);
+        const __m256d t_min = _mm256_set1_pd(in.t_min);
+        const __m256d end = _mm256_set1_pd(double(in.end));
+        const __m256d zero = _mm256_setzero_pd();
+
+        __m256d best_t = _mm256_set1_pd(t_max);
+        __m256d best_index = _mm256_set1_pd(-1.0);
+        __m256d index = _mm256_set_pd(double(in.first + 3), double(in.first + 2), double(in.first + 1), double(in.first));
+        const __m256d index_step = _mm256_set1_pd(4.0);
+
+        for (std::size_t k = in.first; k < in.end; k += 4) {
+            __m256d ocx = _mm256_sub_pd(_mm256_loadu_pd(in.center_x + k), origin_x);
+            __m256d ocy = _mm256_sub_pd(_mm256_loadu_pd(in.center_y + k), origin_y);
+            __m256d ocz = _mm256_sub_pd(_mm256_loadu_pd(in.center_z + k), origin_z);
+            __m256d radius = _mm256_loadu_pd(in.radius + k);
+
+            __m256d h = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(direction_x, ocx), _mm256_mul_pd(direction_y, ocy)), _mm256_mul_pd(direction_z, ocz));
+            __m256d oc2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ocx, ocx), _mm256_mul_pd(ocy, ocy)), _mm256_mul_pd(ocz, ocz));
+            __m256d c = _mm256_sub_pd(oc2, _mm256_mul_pd(radius, radius));
+            __m256d discriminant = _mm256_sub_pd(_mm256_mul_pd(h, h), _mm256_mul_pd(a, c));
+
+            __m256d valid = _mm256_and_pd(_mm256_cmp_pd(discriminant, zero, _CMP_GE_OQ), _mm256_cmp_pd(index, end, _CMP_LT_OQ));
+
+            if (_mm256_movemask_pd(valid) == 0) {
+                index = _mm256_add_pd(index, index_step);
+                continue;
+            }
+
+            __m256d sqrt_discriminant = _mm256_sqrt_pd(_mm256_max_pd(discriminant, zero));
+
+            __m256d t1 = _mm256_div_pd(_mm256_sub_pd(h, sqrt_discriminant), a);
+            __m256d t2 = _mm256_div_pd(_mm256_add_pd(h, sqrt_discriminant), a);
+
+            __m256d t1_ok = _mm256_and_pd(_mm256_cmp_pd(t1, t_min, _CMP_GT_OQ), _mm256_cmp_pd(t1, best_t, _CMP_LT_OQ));
+            __m256d t2_ok = _mm256_and_pd(_mm256_cmp_pd(t2, t_min, _CMP_GT_OQ), _mm256_cmp_pd(t2, best_t, _CMP_LT_OQ));
+
+            __m256d t = _mm256_blendv_pd(t2, t1, t1_ok);
+            __m256d accept = _mm256_and_pd(valid, _mm256_or_pd(t1_ok, t2_ok));
+
+            best_t = _mm256_blendv_pd(best_t, t, accept);
+            best_index = _mm256_blendv_pd(best_index, index, accept);
+            index = _mm256_add_pd(index, index_step);
+        }
+
+        alignas(32) double lane_t[4];
+        alignas(32) double lane_index[4];
+        _mm256_store_pd(lane_t, best_t);
+        _mm256_store_pd(lane_index, best_index);
+
+        return pick_closest_lane(lane_t, lane_index, 4, t_max);
+    }
+
+#endif // RT_HAS_X86_KERNELS
+
+} // namespace
+
+bool SphereSoA::kernel_supported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::SCALAR:
+            return true;
+
+#ifdef RT_HAS_X86_KERNELS
+        case Kernel::SSE2:
+            return __builtin_cpu_supports("sse2");
+
+        case Kernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+
+        default:
+            return false;
+    }
+}
+
+SphereSoA::Kernel SphereSoA::best_kernel() {
+    // A detecção é feita uma única vez, na primeira chamada
+    static const Kernel best = kernel_supported(Kernel::AVX2) ? Kernel::AVX2
+                             : kernel_supported(Kernel::SSE2) ? Kernel::SSE2
+                             : Kernel::SCALAR;
+    return best;
+}
+
+void SphereSoA::reserve(std::size_t count) {
+    auto padded = count + LANE_PADDING - 1;
+
+    m_center_x.reserve(padded);
+    m_center_y.reserve(padded);
+    m_center_z.reserve(padded);
+    m_radius.reserve(padded);
+    m_material_index.reserve(count);
+}
+
+void SphereSoA::add(const Point3 &center, double radius, std::uint32_t material) {
+    // Mantém LANE_PADDING - 1 esferas de preenchimento depois da última esfera válida
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    while (m_radius.size() < m_count + LANE_PADDING) {
+        m_center_x.push_back(NaN);
+        m_center_y.push_back(NaN);
+        m_center_z.push_back(NaN);
+        m_radius.push_back(NaN);
+    }
+
+    m_center_x[m_count] = center.x();
+    m_center_y[m_count] = center.y();
+    m_center_z[m_count] = center.z();
+    m_radius[m_count] = std::fmax(0, radius);
+    ++m_count;
+
+    m_material_index.push_back(material);
+}
+
+void SphereSoA::assign(std::size_t count, const double *center_x, const double *center_y, const double *center_z,
+                       const double *radius, const std::uint32_t *material_index) {
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+    // Cada vetor é escrito uma única vez: as esferas e depois o preenchimento
+    auto fill = [&](std::vector<double> &values, const double *source) {
+        values.clear();
+        values.reserve(count + LANE_PADDING - 1);
+        values.insert(values.end(), source, source + count);
+        values.insert(values.end(), LANE_PADDING - 1, NaN);
+    };
+
+    m_count = count;
+    fill(m_center_x, center_x);
+    fill(m_center_y, center_y);
+    fill(m_center_z, center_z);
+    fill(m_radius, radius);
+
+    m_material_index.assign(material_index, material_index + count);
+}
+
+bool SphereSoA::add_if_all_spheres(const std::vector<std::shared_ptr<Hittable>> &objects) {
+    std::vector<const Sphere *> spheres;
+    spheres.reserve(objects.size());
+
+    for (const auto &object : objects) {
+        auto sphere = dynamic_cast<const Sphere *>(object.get());
+        if (sphere == nullptr)
+            return false;
+
+        spheres.push_back(sphere);
+    }
+
+    reserve(size() + spheres.size());
+    for (auto sphere : spheres)
+        add(sphere->center(), sphere->radius(), sphere->material());
+
+    return true;
+}
+
+AABB SphereSoA::sphere_bounds(std::size_t index) const {
+    Vec3 radius_vec{m_radius[index], m_radius[index], m_radius[index]};
+    return AABB{center(index) - radius_vec, center(index) + radius_vec};
+}
+
+AABB SphereSoA::bounding_box() const {
+    AABB box;
+
+    for (std::size_t index = 0; index < m_count; ++index)
+        box.expand(sphere_bounds(index));
+
+    return box;
+}
+
+bool SphereSoA::hit_range(const Ray &r, std::size_t first, std::size_t count, Interval acceptable_t_interval, HitRecord &h_rec) const {
+    const auto &origin = r.origin();
+    const auto &direction = r.direction();
+
+    KernelInput input{m_center_x.data(), m_center_y.data(), m_center_z.data(), m_radius.data(),
+                      first, first + count,
+                      {origin.x(), origin.y(), origin.z()},
+                      {direction.x(), direction.y(), direction.z()},
+                      direction.squared_length(),
+                      acceptable_t_interval.min()};
+
+    double closest_t = acceptable_t_interval.max();
+    long closest = -1;
+
+    switch (m_kernel) {
+#ifdef RT_HAS_X86_KERNELS
+        case Kernel::AVX2: closest = closest_sphere_avx2(input, closest_t); break;
+        case Kernel::SSE2: closest = closest_sphere_sse2(input, closest_t); break;
+#endif
+        default: closest = closest_sphere_scalar(input, closest_t); break;
+    }
+
+    if (closest < 0)
+        return false;
+
+    // Apenas a esfera vencedora tem o registro completo calculado
+    fill_record(r, std::size_t(closest), closest_t, h_rec);
+    return true;
+}
+
+// Mesmo registro montado por Sphere::hit
+void SphereSoA::fill_record(const Ray &r, std::size_t index, double t, HitRecord &h_rec) const {
+    h_rec.t = t;
+    h_rec.point = r.at(t);
+
+    Vec3 outward_normal = (h_rec.point - center(index)) / m_radius[index];
+    h_rec.set_face_normal(r, outward_normal);
+    h_rec.material = m_material_index[index];
+}
+
+void SphereSoA::hit_range_packet(const RayPacket &packet, std::size_t first, std::size_t count, double t_min, double *t_max, long *closest) const {
+    double a[RayPacket::MAX_SIZE];
+    for (int k = 0; k < packet.size; ++k)
+        a[k] = packet.direction_x[k] * packet.direction_x[k] + packet.direction_y[k] * packet.direction_y[k] + packet.direction_z[k] * packet.direction_z[k];
+
+    for (auto index = first; index < first + count; ++index) {
+        double center_x = m_center_x[index];
+        double center_y = m_center_y[index];
+        double center_z = m_center_z[index];
+        double radius_squared = m_radius[index] * m_radius[index];
+
+        // NOTE: o corpo é escrito sem desvios (apenas seleções) para que o compilador processe vários
+        // raios por instrução; a conta é a mesma de closest_sphere_scalar
+        for (int k = 0; k < packet.size; ++k) {
+            double ocx = center_x - packet.origin_x[k];
+            double ocy = center_y - packet.origin_y[k];
+            double ocz = center_z - packet.origin_z[k];
+
+            double h = packet.direction_x[k] * ocx + packet.direction_y[k] * ocy + packet.direction_z[k] * ocz;
+            double c = (ocx * ocx + ocy * ocy + ocz * ocz) - radius_squared;
+            double discriminant = h * h - a[k] * c;
+
+            bool valid = discriminant >= 0;
+            double sqrt_discriminant = std::sqrt(valid ? discriminant : 0.0);
+
+            double t1 = (h - sqrt_discriminant) / a[k];
+            double t2 = (h + sqrt_discriminant) / a[k];
+
+            bool t1_ok = t1 > t_min && t1 < t_max[k];
+            bool t2_ok = t2 > t_min && t2 < t_max[k];
+
+            bool accept = valid && (t1_ok || t2_ok);
+            double t = t1_ok ? t1 : t2;
+
+            t_max[k] = accept ? t : t_max[k];
+            closest[k] = accept ? long(index) : closest[k];
+        }
+    }
+}
+
+void SphereSoA::hit_packet(const RayPacket &packet, Interval acceptable_t_interval, HitRecord *h_recs, bool *hits) const {
+    double t_max[RayPacket::MAX_SIZE];
+    long closest[RayPacket::MAX_SIZE];
+
+    for (int k = 0; k < packet.size; ++k) {
+        t_max[k] = acceptable_t_interval.max();
+        closest[k] = -1;
+    }
+
+    hit_range_packet(packet, 0, size(), acceptable_t_interval.min(), t_max, closest);
+    Stats::t_counters.primitive_tests += size() * std::uint64_t(packet.size);
+
+    for (int k = 0; k < packet.size; ++k) {
+        hits[k] = closest[k] >= 0;
+
+        if (hits[k])
+            fill_record(packet.ray(k), std::size_t(closest[k]), t_max[k], h_recs[k]);
+    }
+}
@@ -0,0 +1,116 @@
+#include "../lib/thread_pool.hpp"
+
+ThreadPool::ThreadPool(int thread_count) {
+    if (thread_count <= 0)
+        thread_count = default_thread_count();
+
+    m_queues = std::make_unique<WorkQueue[]>(thread_count);
+
+    for (int worker_id = 0; worker_id < thread_count; ++worker_id)
+        m_workers.emplace_back(&ThreadPool::worker_loop, this, worker_id);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wake_workers.notify_all();
+
+    for (auto &worker : m_workers)
+        worker.join();
+}
+
+int ThreadPool::default_thread_count() {
+    // hardware_concurrency() pode retornar 0 quando a informação não está disponível
+    auto hardware_threads = static_cast<int>(std::thread::hardware_concurrency());
+    return hardware_threads > 0 ? hardware_threads : 1;
+}
+
+void ThreadPool::run(int task_count, const std::function<void(int, int)> &task) {
+    if (task_count <= 0)
+        return;
+
+    // As tarefas são distribuídas em blocos contíguos, um por thread. Tarefas vizinhas (tiles
+    // vizinhos) tendem a acessar os mesmos dados, então é melhor que fiquem com a mesma thread
+    // enquanto não for necessário roubá-las.
+    int worker_count = size();
+    for (int worker_id = 0; worker_id < worker_count; ++worker_id) {
+        int begin = static_cast<int>(static_cast<long long>(task_count) * worker_id / worker_count);
+        int end = static_cast<int>(static_cast<long long>(task_count) * (worker_id + 1) / worker_count);
+
+        std::lock_guard<std::mutex> queue_lock(m_queues[worker_id].mutex);
+        for (int task_index = begin; task_index < end; ++task_index)
+            m_queues[worker_id].tasks.push_back(task_index);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_finished_workers = 0;
+    ++m_generation;
+    m_wake_workers.notify_all();
+
+    // NOTE: espera-se todas as threads confirmarem o fim do lote (e não apenas as tarefas acabarem)
+    // para garantir que nenhuma delas continue segurando a referência para task depois do retorno
+    m_workers_finished.wait(lock, [this, worker_count] { return m_finished_workers == worker_count; });
+    m_task = nullptr;
+}
+
+bool ThreadPool::pop_task(int worker_id, int &task) {
+    {
+        auto &own_queue = m_queues[worker_id];
+        std::lock_guard<std::mutex> lock(own_queue.mutex);
+
+        if (!own_queue.tasks.empty()) {
+            task = own_queue.tasks.front();
+            own_queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Fila própria vazia: tenta roubar do final da fila das outras threads, começando pela vizinha
+    int worker_count = size();
+    for (int offset = 1; offset < worker_count; ++offset) {
+        auto &victim_queue = m_queues[(worker_id + offset) % worker_count];
+        std::lock_guard<std::mutex> lock(victim_queue.mutex);
+
+        if (!victim_queue.tasks.empty()) {
+            task = victim_queue.tasks.back();
+            victim_queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::worker_loop(int worker_id) {
+    std::uint64_t last_generation = 0;
+
+    while (true) {
+        const std::function<void(int, int)> *task_function = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake_workers.wait(lock, [this, last_generation] { return m_stop || m_generation != last_generation; });
+
+            if (m_stop)
+                return;
+
+            last_generation = m_generation;
+            task_function = m_task;
+        }
+
+        int task;
+        while (pop_task(worker_id, task))
+            (*task_function)(task, worker_id);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_finished_workers;
+        }
+
+        m_workers_finished.notify_one();
+    }
+}
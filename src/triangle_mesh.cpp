@@ -0,0 +1,487 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+#include "../lib/triangle_mesh.hpp"
+#include "../lib/render_stats.hpp"
+
+namespace {
+
+    // Cabeçalho do formato binário; os números são gravados na ordem de bytes da máquina, como na
+    // cena compilada
+    constexpr char MESH_MAGIC[8] = {'R', 'T', 'M', 'E', 'S', 'H', '0', '1'};
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304u;
+    constexpr std::size_t SECTION_ALIGNMENT = 64;
+
+    struct MeshHeader {
+        char magic[8];
+        std::uint32_t byte_order;
+        std::uint32_t node_size;
+
+        std::uint64_t vertex_count;
+        std::uint64_t triangle_count;
+        std::uint64_t node_count;
+
+        std::uint64_t vertices_offset;
+        std::uint64_t indices_offset;
+        std::uint64_t nodes_offset;
+    };
+
+    std::uint64_t align_offset(std::uint64_t offset) {
+        return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    }
+
+    // Raio preparado para o teste estanque: kz é o eixo em que a direção é maior (em módulo), kx e
+    // ky os outros dois (trocados se a direção em kz for negativa, para manter a orientação), e
+    // (shear_x, shear_y, shear_z) a transformação que leva a direção para (0, 0, 1)
+    struct WatertightRay {
+        int kx, ky, kz;
+        double shear_x, shear_y, shear_z;
+        Point3 origin;
+
+        explicit WatertightRay(const Ray &r) : origin{r.origin()} {
+            const auto &direction = r.direction();
+
+            kz = 0;
+            if (std::fabs(direction[1]) > std::fabs(direction[kz]))
+                kz = 1;
+            if (std::fabs(direction[2]) > std::fabs(direction[kz]))
+                kz = 2;
+
+            kx = (kz + 1) % 3;
+            ky = (kx + 1) % 3;
+            if (direction[kz] < 0)
+                std::swap(kx, ky);
+
+            shear_x = direction[kx] / direction[kz];
+            shear_y = direction[ky] / direction[kz];
+            shear_z = 1.0 / direction[kz];
+        }
+    };
+
+    // Triângulos testados de uma vez por folha. As coordenadas dos vértices são copiadas primeiro
+    // para vetores de tamanho fixo e o teste em si é um laço sem desvios nem divisões sobre eles, que
+    // o compilador consegue vetorizar.
+    constexpr int TRIANGLE_BATCH = 8;
+
+    // Margem relativa das caixas dos triângulos (ver build_bvh_and_reorder)
+    constexpr double BOX_MARGIN = 1e-9;
+
+    bool parse_double(std::string_view token, double &value) {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        return result.ec == std::errc{} && result.ptr == token.data() + token.size();
+    }
+
+    // Índice de vértice de uma face OBJ ("i", "i/t", "i//n" ou "i/t/n"), convertido para base 0
+    bool parse_face_index(std::string_view token, std::size_t vertex_count, std::uint32_t &index) {
+        token = token.substr(0, token.find('/'));
+
+        long long value;
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (result.ec != std::errc{} || result.ptr != token.data() + token.size() || value == 0)
+            return false;
+
+        // Índices negativos são relativos ao último vértice lido
+        auto absolute = value > 0 ? value - 1 : static_cast<long long>(vertex_count) + value;
+        if (absolute < 0 || static_cast<unsigned long long>(absolute) >= vertex_count)
+            return false;
+
+        index = static_cast<std::uint32_t>(absolute);
+        return true;
+    }
+
+} // namespace
+
+TriangleMesh::TriangleMesh(std::vector<double> vertices, std::vector<std::uint32_t> indices, std::uint32_t material)
+    : m_material{material}, m_owned_vertices{std::move(vertices)}, m_owned_indices{std::move(indices)} {
+    build_bvh_and_reorder();
+}
+
+void TriangleMesh::use_owned_buffers() {
+    m_file.reset();
+
+    m_vertices = m_owned_vertices.data();
+    m_indices = m_owned_indices.data();
+    m_nodes = m_owned_nodes.data();
+
+    m_vertex_count = m_owned_vertices.size() / 3;
+    m_triangle_count = m_owned_indices.size() / 3;
+    m_node_count = m_owned_nodes.size();
+}
+
+void TriangleMesh::build_bvh_and_reorder() {
+    auto triangle_count = m_owned_indices.size() / 3;
+    m_owned_indices.resize(3 * triangle_count);
+
+    auto vertex = [&](std::uint32_t index) {
+        return Point3{m_owned_vertices[3 * index], m_owned_vertices[3 * index + 1], m_owned_vertices[3 * index + 2]};
+    };
+
+    // O teste das caixas não é exato: um raio que passa exatamente por um vértice (que fica no canto da
+    // caixa) pode ser descartado por arredondamento, e a malha deixaria de ser estanque. Cada caixa
+    // é aumentada por uma margem relativa ao tamanho das coordenadas.
+    std::vector<AABB> bounds(triangle_count);
+    for (std::size_t k = 0; k < triangle_count; ++k) {
+        AABB box;
+        box.expand(vertex(m_owned_indices[3 * k]));
+        box.expand(vertex(m_owned_indices[3 * k + 1]));
+        box.expand(vertex(m_owned_indices[3 * k + 2]));
+
+        double magnitude = 1.0;
+        for (int axis = 0; axis < 3; ++axis)
+            magnitude = std::max({magnitude, std::fabs(box.min()[axis]), std::fabs(box.max()[axis])});
+
+        Vec3 margin{BOX_MARGIN * magnitude, BOX_MARGIN * magnitude, BOX_MARGIN * magnitude};
+        bounds[k] = AABB{box.min() - margin, box.max() + margin};
+    }
+
+    std::vector<std::uint32_t> order;
+    m_owned_nodes = build_bvh(bounds, order);
+
+    // As folhas referenciam trechos contíguos de triângulos
+    std::vector<std::uint32_t> ordered_indices(m_owned_indices.size());
+    for (std::size_t k = 0; k < triangle_count; ++k)
+        std::copy_n(&m_owned_indices[3 * std::size_t(order[k])], 3, &ordered_indices[3 * k]);
+
+    m_owned_indices = std::move(ordered_indices);
+    use_owned_buffers();
+}
+
+bool TriangleMesh::hit(const Ray &r, Interval acceptable_t_interval, HitRecord &h_rec) const {
+    if (m_node_count == 0)
+        return false;
+
+    WatertightRay ray{r};
+
+    const auto &direction = r.direction();
+    Vec3 inverse_direction{1.0 / direction.x(), 1.0 / direction.y(), 1.0 / direction.z()};
+    bool direction_is_negative[3] = {direction.x() < 0, direction.y() < 0, direction.z() < 0};
+
+    auto t_min = acceptable_t_interval.min();
+    auto closest_so_far = acceptable_t_interval.max();
+    std::size_t closest_triangle = m_triangle_count;
+
+    std::uint64_t box_tests = 0;
+    std::uint64_t primitive_tests = 0;
+
+    // Coordenadas dos vértices relativas à origem do raio, já no sistema do raio (a, b e c são os
+    // três vértices de cada triângulo do lote)
+    alignas(64) double ax[TRIANGLE_BATCH], ay[TRIANGLE_BATCH], az[TRIANGLE_BATCH];
+    alignas(64) double bx[TRIANGLE_BATCH], by[TRIANGLE_BATCH], bz[TRIANGLE_BATCH];
+    alignas(64) double cx[TRIANGLE_BATCH], cy[TRIANGLE_BATCH], cz[TRIANGLE_BATCH];
+    alignas(64) double t_batch[TRIANGLE_BATCH], det_batch[TRIANGLE_BATCH];
+
+    auto load_vertex = [&](std::uint32_t index, double &x, double &y, double &z) {
+        const double *position = m_vertices + 3 * std::size_t(index);
+        double relative[3] = {position[0] - ray.origin[0], position[1] - ray.origin[1], position[2] - ray.origin[2]};
+
+        x = relative[ray.kx] - ray.shear_x * relative[ray.kz];
+        y = relative[ray.ky] - ray.shear_y * relative[ray.kz];
+        z = ray.shear_z * relative[ray.kz];
+    };
+
+    std::uint32_t stack[BVH_STACK_SIZE];
+    int stack_size = 0;
+    std::uint32_t current = 0;
+
+    while (true) {
+        const auto &node = m_nodes[current];
+        ++box_tests;
+
+        if (node.bounds.hit(r.origin(), inverse_direction, t_min, closest_so_far)) {
+            if (!node.is_leaf()) {
+                if (direction_is_negative[node.split_axis]) {
+                    stack[stack_size++] = current + 1;
+                    current = node.offset;
+                }
+                else {
+                    stack[stack_size++] = node.offset;
+                    current = current + 1;
+                }
+
+                continue;
+            }
+
+            primitive_tests += node.primitive_count;
+
+            for (std::uint32_t first = node.offset; first < node.offset + node.primitive_count; first += TRIANGLE_BATCH) {
+                auto count = std::min<std::uint32_t>(TRIANGLE_BATCH, node.offset + node.primitive_count - first);
+
+                for (std::uint32_t j = 0; j < count; ++j) {
+                    load_vertex(vertex_index(first + j, 0), ax[j], ay[j], az[j]);
+                    load_vertex(vertex_index(first + j, 1), bx[j], by[j], bz[j]);
+                    load_vertex(vertex_index(first + j, 2), cx[j], cy[j], cz[j]);
+                }
+
+                for (std::uint32_t j = 0; j < count; ++j) {
+                    // Funções das arestas: o raio passa dentro do triângulo se as três tiverem o mesmo sinal
+                    double u = cx[j] * by[j] - cy[j] * bx[j];
+                    double v = ax[j] * cy[j] - ay[j] * cx[j];
+                    double w = bx[j] * ay[j] - by[j] * ax[j];
+
+                    bool outside = (u < 0 || v < 0 || w < 0) && (u > 0 || v > 0 || w > 0);
+
+                    // t = t_scaled / det, mas o intervalo é testado sem a divisão, multiplicando-o por |det|
+                    double det = u + v + w;
+                    double sign = det < 0 ? -1.0 : 1.0;
+                    double abs_det = sign * det;
+                    double t_scaled = sign * (u * az[j] + v * bz[j] + w * cz[j]);
+
+                    bool valid = !outside && abs_det > 0.0 && t_scaled > t_min * abs_det && t_scaled < closest_so_far * abs_det;
+
+                    t_batch[j] = t_scaled;
+                    det_batch[j] = valid ? abs_det : 0.0;
+                }
+
+                // A divisão só é feita para os triângulos tocados
+                for (std::uint32_t j = 0; j < count; ++j) {
+                    if (det_batch[j] > 0.0 && t_batch[j] / det_batch[j] < closest_so_far) {
+                        closest_so_far = t_batch[j] / det_batch[j];
+                        closest_triangle = first + j;
+                    }
+                }
+            }
+        }
+
+        if (stack_size == 0)
+            break;
+
+        current = stack[--stack_size];
+    }
+
+    Stats::t_counters.box_tests += box_tests;
+    Stats::t_counters.primitive_tests += primitive_tests;
+
+    if (closest_triangle == m_triangle_count)
+        return false;
+
+    auto a = vertex(vertex_index(closest_triangle, 0));
+    auto b = vertex(vertex_index(closest_triangle, 1));
+    auto c = vertex(vertex_index(closest_triangle, 2));
+
+    h_rec.t = closest_so_far;
+    h_rec.point = r.at(closest_so_far);
+    h_rec.set_face_normal(r, ((b - a) % (c - a)).unit());
+    h_rec.material = m_material;
+
+    return true;
+}
+
+bool TriangleMesh::load_obj(const char *filename, std::uint32_t material, std::string &error) {
+    MappedFile file;
+
+    if (!file.open(filename)) {
+        error = "não foi possível abrir o arquivo";
+        return false;
+    }
+
+    std::string_view text{reinterpret_cast<const char *>(file.data()), file.size()};
+
+    std::vector<double> vertices;
+    std::vector<std::uint32_t> indices;
+    std::vector<std::uint32_t> face;
+
+    std::size_t line_number = 0;
+    std::size_t position = 0;
+
+    while (position < text.size()) {
+        auto line_end = text.find('\n', position);
+        if (line_end == std::string_view::npos)
+            line_end = text.size();
+
+        auto line = text.substr(position, line_end - position);
+        position = line_end + 1;
+        ++line_number;
+
+        auto fail = [&](const char *message) {
+            error = "linha " + std::to_string(line_number) + ": " + message;
+            return false;
+        };
+
+        // Apenas vértices e faces interessam; normais, coordenadas de textura, grupos e materiais são ignorados
+        bool is_vertex = line.size() > 1 && line[0] == 'v' && (line[1] == ' ' || line[1] == '\t');
+        bool is_face = line.size() > 1 && line[0] == 'f' && (line[1] == ' ' || line[1] == '\t');
+
+        if (!is_vertex && !is_face)
+            continue;
+
+        auto comment = line.find('#');
+        if (comment != std::string_view::npos)
+            line = line.substr(0, comment);
+
+        // Palavras depois do comando
+        std::size_t token_count = 0;
+        face.clear();
+
+        for (std::size_t cursor = 1; cursor < line.size();) {
+            auto start = line.find_first_not_of(" \t\r", cursor);
+            if (start == std::string_view::npos)
+                break;
+
+            auto end = line.find_first_of(" \t\r", start);
+            if (end == std::string_view::npos)
+                end = line.size();
+
+            auto token = line.substr(start, end - start);
+            cursor = end;
+
+            if (is_vertex) {
+                // A quarta coordenada (w), quando presente, é ignorada
+                double value;
+                if (token_count < 3 && !parse_double(token, value))
+                    return fail("coordenada de vértice inválida");
+
+                if (token_count < 3)
+                    vertices.push_back(value);
+            }
+            else {
+                std::uint32_t index;
+                if (!parse_face_index(token, vertices.size() / 3, index))
+                    return fail("índice de vértice inválido");
+
+                face.push_back(index);
+            }
+
+            ++token_count;
+        }
+
+        if (is_vertex && token_count < 3)
+            return fail("'v' espera as coordenadas x y z");
+
+        if (is_face) {
+            if (face.size() < 3)
+                return fail("'f' espera pelo menos 3 vértices");
+
+            // Polígonos são divididos em leque a partir do primeiro vértice
+            for (std::size_t k = 1; k + 1 < face.size(); ++k)
+                indices.insert(indices.end(), {face[0], face[k], face[k + 1]});
+        }
+    }
+
+    *this = TriangleMesh{};
+    m_material = material;
+    m_owned_vertices = std::move(vertices);
+    m_owned_indices = std::move(indices);
+    build_bvh_and_reorder();
+
+    return true;
+}
+
+bool TriangleMesh::load_binary(const char *filename, std::uint32_t material, std::string &error) {
+    auto file = std::make_shared<MappedFile>();
+
+    auto fail = [&](const char *message) {
+        error = message;
+        return false;
+    };
+
+    // Sem carregar o arquivo inteiro: só as páginas que a validação e a travessia tocam são lidas
+    if (!file->open(filename, false))
+        return fail("não foi possível abrir o arquivo");
+
+    const auto *data = file->data();
+    auto size = file->size();
+
+    MeshHeader header;
+    if (size < sizeof(header))
+        return fail("malha truncada");
+
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MESH_MAGIC, sizeof(MESH_MAGIC)) != 0)
+        return fail("não é uma malha binária");
+
+    if (header.byte_order != BYTE_ORDER_MARK || header.node_size != sizeof(BVHNode))
+        return fail("malha gravada em outra máquina ou por outra versão do programa");
+
+    auto section_fits = [&](std::uint64_t offset, std::uint64_t count, std::size_t element_size) {
+        return offset <= size && offset % SECTION_ALIGNMENT == 0 && count <= (size - offset) / element_size;
+    };
+
+    if (!section_fits(header.vertices_offset, header.vertex_count, 3 * sizeof(double))
+        || !section_fits(header.indices_offset, header.triangle_count, 3 * sizeof(std::uint32_t))
+        || !section_fits(header.nodes_offset, header.node_count, sizeof(BVHNode))
+        || (header.triangle_count > 0) != (header.node_count > 0)
+        || (header.triangle_count > 0 && header.vertex_count == 0))
+        return fail("malha truncada");
+
+    // NOTE: o mapeamento começa no início de uma página e as seções são alinhadas a 64 bytes
+    const auto *indices = reinterpret_cast<const std::uint32_t *>(data + header.indices_offset);
+    const auto *nodes = reinterpret_cast<const BVHNode *>(data + header.nodes_offset);
+
+    // Um arquivo corrompido não pode fazer a travessia ler fora dos vetores. Os nós são conferidos aqui,
+    // o que lê a seção inteira uma vez, em sequência (as páginas podem ser descartadas depois); os índices
+    // de vértice não são lidos: vertex_index os limita ao último vértice quando o triângulo é testado.
+    if (!valid_bvh_nodes(nodes, header.node_count, header.triangle_count))
+        return fail("BVH inválida na malha");
+
+    *this = TriangleMesh{};
+    m_material = material;
+    m_vertices = reinterpret_cast<const double *>(data + header.vertices_offset);
+    m_indices = indices;
+    m_nodes = nodes;
+    m_vertex_count = header.vertex_count;
+    m_triangle_count = header.triangle_count;
+    m_node_count = header.node_count;
+    m_file = std::move(file);
+
+    return true;
+}
+
+bool TriangleMesh::load(const char *filename, std::uint32_t material, std::string &error) {
+    char magic[sizeof(MESH_MAGIC)] = {};
+
+    if (std::ifstream input{filename, std::ios_base::binary}; input)
+        input.read(magic, sizeof(magic));
+
+    if (std::memcmp(magic, MESH_MAGIC, sizeof(MESH_MAGIC)) == 0)
+        return load_binary(filename, material, error);
+
+    return load_obj(filename, material, error);
+}
+
+bool TriangleMesh::save_binary(const char *filename) const {
+    MeshHeader header{};
+    std::memcpy(header.magic, MESH_MAGIC, sizeof(header.magic));
+    header.byte_order = BYTE_ORDER_MARK;
+    header.node_size = sizeof(BVHNode);
+    header.vertex_count = m_vertex_count;
+    header.triangle_count = m_triangle_count;
+    header.node_count = m_node_count;
+
+    header.vertices_offset = align_offset(sizeof(MeshHeader));
+    header.indices_offset = align_offset(header.vertices_offset + m_vertex_count * 3 * sizeof(double));
+    header.nodes_offset = align_offset(header.indices_offset + m_triangle_count * 3 * sizeof(std::uint32_t));
+
+    // As seções são escritas diretamente dos vetores, sem montar o arquivo inteiro na memória
+    std::string temporary_filename = std::string(filename) + ".tmp";
+
+    {
+        std::ofstream output_file(temporary_filename, std::ofstream::out | std::ofstream::trunc | std::ios_base::binary);
+
+        if (!output_file)
+            return false;
+
+        std::uint64_t written = 0;
+        auto write_section = [&](std::uint64_t offset, const void *section, std::size_t size) {
+            static const char padding[SECTION_ALIGNMENT] = {};
+            output_file.write(padding, std::streamsize(offset - written));
+            output_file.write(static_cast<const char *>(section), std::streamsize(size));
+            written = offset + size;
+        };
+
+        write_section(0, &header, sizeof(header));
+        write_section(header.vertices_offset, m_vertices, m_vertex_count * 3 * sizeof(double));
+        write_section(header.indices_offset, m_indices, m_triangle_count * 3 * sizeof(std::uint32_t));
+        write_section(header.nodes_offset, m_nodes, m_node_count * sizeof(BVHNode));
+
+        if (!output_file.flush())
+            return false;
+    }
+
+    return std::rename(temporary_filename.c_str(), filename) == 0;
+}
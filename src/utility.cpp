@@ -1,11 +1,7 @@
+#include "../lib/sampling.hpp"
 #include "../lib/utility.hpp"
 #include "../lib/vector3d.hpp"
 
-double Utility::random_double() {
-    // Sempre resultará em um número decimal
-    return std::rand() / (RAND_MAX + 1.0);
-}
-
 double Utility::random_double(double min, double max) {
     return min + (max - min) * Utility::random_double();
 }
@@ -22,20 +18,10 @@ Vec3 Utility::random_vec() {
 
 Vec3 Utility::random_unit_vec() {
 
-    // NOTE: Utiliza-se o método da tentativa e descarte para achar um vetor que
-    // esteja contido na esfera se for aceito, então retorna o vetor unitário com
-    // a ponta exatamente em algum ponto da superfície
-    while (true) {
-      Vec3 random_vec = Utility::random_vec(-1, 1);
-      auto random_vec_length = random_vec.squared_length();
-
-      // NOTE: É preciso verificar se o tamanho d^2 é maior que esse expoente
-      // pequeno para evitar problemas em relação a aproximação de float. Caso
-      // contrário, a divisão random_vec / (random_vec_length)^1/2 resultará em
-      // componentes tendendo ao infinito pelo denominador se aproximando de 0.
-      if (random_vec_length <= 1 && 1e-160 < random_vec_length)
-          return random_vec / std::sqrt(random_vec_length);
-    }
+    // NOTE: Antes era usado o método da tentativa e descarte (um ponto do cubo [-1, 1]³ aceito só se
+    // estivesse dentro da esfera), que jogava fora quase metade dos sorteios de três números. A
+    // transformação fechada usa sempre dois números e não tem laço (ver sampling.hpp)
+    return Sampling::uniform_sphere(Sampling::random_point2());
 }
 
 Vec3 Utility::random_vec_on_hemisphere(const Vec3& normal_vec) {
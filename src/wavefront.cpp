@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <type_traits>
+#include <variant>
+
+#include "../lib/material.hpp"
+#include "../lib/render.hpp"
+#include "../lib/wavefront.hpp"
+
+void WavefrontPaths::resize(std::size_t size) {
+    pixel.resize(size);
+    sample.resize(size);
+    bounce.resize(size);
+
+    origin.resize(size);
+    direction.resize(size);
+    hit.resize(size);
+
+    throughput.resize(size);
+    radiance.resize(size);
+    scatter_pdf.resize(size);
+
+    albedo.resize(size);
+    normal.resize(size);
+    depth.resize(size);
+
+    // Cada caminho traça no máximo um raio de sombra por trecho
+    shadow_path.resize(size);
+    shadow_origin.resize(size);
+    shadow_direction.resize(size);
+    shadow_distance.resize(size);
+    shadow_light.resize(size);
+
+    active.reserve(size);
+    hits.reserve(size);
+    by_material.resize(size);
+    next.reserve(size);
+    ray_keys.reserve(size);
+}
+
+namespace {
+
+    // Os buffers de cada thread são reaproveitados por todos os tiles e rodadas que ela renderiza
+    thread_local WavefrontPaths t_paths;
+
+    // O que os estágios de uma rodada compartilham
+    struct WavefrontStage {
+        const Render &render;
+        const Tile &tile;
+        const HittableList &world;
+        WavefrontPaths &paths;
+        Sampler &sampler;
+        int max_depth;
+        int roulette_min_depth;
+        bool sort_rays;
+
+        int pixel_i(std::uint32_t pixel) const { return tile.start_i + int(pixel % std::uint32_t(tile.end_i - tile.start_i)); }
+        int pixel_j(std::uint32_t pixel) const { return tile.start_j + int(pixel / std::uint32_t(tile.end_i - tile.start_i)); }
+    };
+
+    // Raios da câmera dos caminhos [0, count)
+    void generate(WavefrontStage &stage, std::size_t count) {
+        auto &paths = stage.paths;
+        paths.active.clear();
+
+        for (std::size_t k = 0; k < count; ++k) {
+            int i = stage.pixel_i(paths.pixel[k]);
+            int j = stage.pixel_j(paths.pixel[k]);
+
+            stage.sampler.start_pixel_sample(i, j, paths.sample[k]);
+            paths.set_ray(k, stage.render.get_ray(i, j, stage.sampler));
+            paths.bounce[k] = 0;
+
+            paths.throughput.set(k, Vec3{1, 1, 1});
+            paths.radiance.set(k, Vec3{0, 0, 0});
+            paths.scatter_pdf[k] = 0.0;
+
+            paths.active.push_back(std::uint32_t(k));
+        }
+    }
+
+    // Espalha os 16 bits de baixo de x, um a cada três bits, para intercalá-los com os de outros dois eixos
+    std::uint64_t spread_bits_3d(std::uint64_t x) {
+        x &= 0xffff;
+        x = (x | (x << 16)) & 0x0000ff0000ffULL;
+        x = (x | (x << 8)) & 0x00f00f00f00fULL;
+        x = (x | (x << 4)) & 0x0c30c30c30c3ULL;
+        x = (x | (x << 2)) & 0x249249249249ULL;
+        return x;
+    }
+
+    // Reordena a fila de ativos pela chave de Morton de cada raio. Os 48 bits de cima intercalam as
+    // coordenadas da origem (16 bits por eixo, dentro da caixa que contém as origens da fila) e os 12 de
+    // baixo, as da direção unitária (4 bits por eixo). Depois do primeiro quique difuso, raios vizinhos na
+    // fila partem de pontos distantes em direções quaisquer; ordenados, raios seguidos partem de pontos
+    // próximos em direções parecidas, percorrem os mesmos nós da BVH e encontram na cache os nós e as
+    // esferas que o raio anterior acabou de ler. Como cada caminho só depende do próprio estado, a
+    // ordem não altera a imagem.
+    void sort_by_morton_key(WavefrontStage &stage) {
+        auto &paths = stage.paths;
+
+        double lower[3] = {+Utility::INFTY, +Utility::INFTY, +Utility::INFTY};
+        double upper[3] = {-Utility::INFTY, -Utility::INFTY, -Utility::INFTY};
+        for (auto k : paths.active) {
+            auto origin = paths.origin.get(k);
+            for (int axis = 0; axis < 3; ++axis) {
+                lower[axis] = std::min(lower[axis], origin[axis]);
+                upper[axis] = std::max(upper[axis], origin[axis]);
+            }
+        }
+
+        double scale[3];
+        for (int axis = 0; axis < 3; ++axis)
+            scale[axis] = upper[axis] > lower[axis] ? 65535.0 / (upper[axis] - lower[axis]) : 0.0;
+
+        paths.ray_keys.clear();
+        for (auto k : paths.active) {
+            auto origin = paths.origin.get(k);
+            auto direction = paths.direction.get(k).unit();
+
+            std::uint64_t origin_key = 0, direction_key = 0;
+            for (int axis = 0; axis < 3; ++axis) {
+                auto cell = std::uint64_t((origin[axis] - lower[axis]) * scale[axis]);
+                auto octant = std::uint64_t(std::clamp((direction[axis] + 1.0) * 8.0, 0.0, 15.0));
+                origin_key |= spread_bits_3d(cell) << axis;
+                direction_key |= spread_bits_3d(octant) << axis;
+            }
+
+            paths.ray_keys.emplace_back((origin_key << 12) | direction_key, k);
+        }
+
+        std::sort(paths.ray_keys.begin(), paths.ray_keys.end());
+
+        for (std::size_t r = 0; r < paths.ray_keys.size(); ++r)
+            paths.active[r] = paths.ray_keys[r].second;
+    }
+
+    // Testa o raio de cada caminho ativo. Os que saem da cena recebem a luz do fundo e terminam; os
+    // demais vão para a fila hits.
+    void intersect(WavefrontStage &stage) {
+        auto &paths = stage.paths;
+        const auto &lights = stage.world.lights;
+        paths.hits.clear();
+
+        for (auto k : paths.active) {
+            Ray ray = paths.ray(k);
+            bool primary = paths.bounce[k] == 0;
+
+            if (primary)
+                ++Stats::t_counters.primary_rays;
+            else
+                ++Stats::t_counters.secondary_rays;
+
+            if (stage.world.hit(ray, Interval(0.001, +Utility::INFTY), paths.hit[k])) {
+                const auto &rec = paths.hit[k];
+
+                if (primary) {
+                    paths.albedo.set(k, stage.world.materials.albedo(rec.material));
+                    paths.normal.set(k, rec.normal_sur_vector);
+                    paths.depth[k] = rec.t * ray.direction().length();
+                }
+
+                paths.hits.push_back(k);
+                continue;
+            }
+
+            // No raio da câmera o peso é 1 e o throughput (1, 1, 1): a cor é exatamente a do céu
+            auto background = stage.render.background_color(ray, lights);
+            double scatter_pdf = paths.scatter_pdf[k];
+            double weight = scatter_pdf > 0.0 ? Sampling::power_heuristic(scatter_pdf, lights.environment_pdf(ray.direction())) : 1.0;
+            paths.radiance.set(k, paths.radiance.get(k) + weight * Utility::product_component(paths.throughput.get(k), background));
+
+            if (primary) {
+                paths.albedo.set(k, background);
+                paths.normal.set(k, Vec3{0, 0, 0});
+                paths.depth[k] = 0.0;
+            }
+        }
+    }
+
+    // Agrupa a fila hits por material com uma ordenação por contagem (estável, então cada grupo mantém a
+    // ordem dos caminhos)
+    void sort_by_material(WavefrontStage &stage) {
+        auto &paths = stage.paths;
+        auto material_count = stage.world.materials.size();
+
+        paths.material_start.assign(material_count + 1, 0);
+        for (auto k : paths.hits)
+            ++paths.material_start[paths.hit[k].material + 1];
+
+        for (std::size_t m = 0; m < material_count; ++m)
+            paths.material_start[m + 1] += paths.material_start[m];
+
+        // material_start[m] avança até o fim do grupo m, que é o início do grupo m + 1
+        for (auto k : paths.hits)
+            paths.by_material[paths.material_start[paths.hit[k].material]++] = k;
+
+        std::rotate(paths.material_start.begin(), paths.material_start.end() - 1, paths.material_start.end());
+        paths.material_start[0] = 0;
+    }
+
+    // Um quique de todos os caminhos [first, last) de by_material, que tocaram o mesmo material: as mesmas
+    // contas de Render::shade_hit, com o material já resolvido (sem std::visit por caminho). A amostragem
+    // direta das luzes entra na fila de raios de sombra e os caminhos que continuam, na fila next.
+    template <typename MaterialType>
+    void shade(WavefrontStage &stage, const MaterialType &material, const std::uint32_t *first, const std::uint32_t *last) {
+        auto &paths = stage.paths;
+        const auto &lights = stage.world.lights;
+
+        for (const auto *path = first; path != last; ++path) {
+            auto k = *path;
+            const auto &rec = paths.hit[k];
+            int bounce = paths.bounce[k] + 1;
+
+            // Uma luz termina o caminho (o seu desvio sempre falha), sem consumir números do amostrador
+            if constexpr (std::is_same_v<MaterialType, Emissive>) {
+                double scatter_pdf = paths.scatter_pdf[k];
+                double weight = scatter_pdf > 0.0 ? Sampling::power_heuristic(scatter_pdf, lights.pdf(paths.origin.get(k), rec)) : 1.0;
+                paths.radiance.set(k, paths.radiance.get(k) + weight * Utility::product_component(paths.throughput.get(k), material.emission()));
+
+                ++Stats::t_counters.bounces;
+                continue;
+            }
+            else {
+                // O amostrador volta ao trecho deste caminho, que usa as mesmas dimensões do MEGAKERNEL
+                stage.sampler.resume(stage.pixel_i(paths.pixel[k]), stage.pixel_j(paths.pixel[k]), paths.sample[k], bounce);
+                ++Stats::t_counters.bounces;
+
+                Ray scattered;
+                Vec3 color_attenuation;
+                if (!material.scatter(paths.ray(k), rec, stage.sampler, color_attenuation, scattered) || bounce >= stage.max_depth)
+                    continue;
+
+                auto throughput = paths.throughput.get(k);
+                double scatter_pdf = 0.0;
+
+                if constexpr (std::is_same_v<MaterialType, Lambertian>) {
+                    if (!lights.empty()) {
+                        Ray shadow_ray;
+                        double shadow_distance;
+                        Vec3 light;
+
+                        if (lights.sample_direct(rec, material.albedo(), stage.sampler, shadow_ray, shadow_distance, light)) {
+                            auto s = paths.shadow_count++;
+                            paths.shadow_path[s] = k;
+                            paths.shadow_origin.set(s, shadow_ray.origin());
+                            paths.shadow_direction.set(s, shadow_ray.direction());
+                            paths.shadow_distance[s] = shadow_distance;
+                            paths.shadow_light.set(s, Utility::product_component(throughput, light));
+                        }
+
+                        scatter_pdf = Sampling::cosine_hemisphere_pdf(scattered.direction() * rec.normal_sur_vector);
+                    }
+                }
+
+                throughput = Utility::product_component(throughput, color_attenuation);
+
+                if (bounce >= stage.roulette_min_depth) {
+                    auto survival = std::min(1.0, std::max({throughput.x(), throughput.y(), throughput.z()}));
+
+                    if (stage.sampler.get_1d() >= survival)
+                        continue;
+
+                    throughput *= 1.0 / survival;
+                }
+
+                paths.throughput.set(k, throughput);
+                paths.scatter_pdf[k] = scatter_pdf;
+                paths.bounce[k] = bounce;
+                paths.set_ray(k, scattered);
+                paths.next.push_back(k);
+            }
+        }
+    }
+
+    // Testa os raios de sombra da fila e soma a luz dos que estão livres
+    void trace_shadows(WavefrontStage &stage) {
+        auto &paths = stage.paths;
+
+        for (std::size_t s = 0; s < paths.shadow_count; ++s) {
+            ++Stats::t_counters.shadow_rays;
+
+            HitRecord blocker;
+            Ray shadow_ray{paths.shadow_origin.get(s), paths.shadow_direction.get(s)};
+            if (stage.world.hit(shadow_ray, Interval(0.001, paths.shadow_distance[s]), blocker))
+                continue;
+
+            auto k = paths.shadow_path[s];
+            paths.radiance.set(k, paths.radiance.get(k) + paths.shadow_light.get(s));
+        }
+
+        paths.shadow_count = 0;
+    }
+
+    // Segue os caminhos [0, count) até que todos terminem
+    void trace(WavefrontStage &stage, std::size_t count) {
+        auto &paths = stage.paths;
+        const auto &materials = stage.world.materials;
+
+        generate(stage, count);
+
+        // Os raios da câmera já saem em ordem de pixels vizinhos
+        for (bool primary = true; !paths.active.empty(); primary = false) {
+            if (stage.sort_rays && !primary)
+                sort_by_morton_key(stage);
+
+            intersect(stage);
+
+            // Os demais estágios voltam a percorrer os caminhos na ordem da memória
+            if (stage.sort_rays && !primary)
+                std::sort(paths.hits.begin(), paths.hits.end());
+
+            sort_by_material(stage);
+
+            paths.next.clear();
+            for (std::size_t m = 0; m < materials.size(); ++m) {
+                auto first = paths.material_start[m], last = paths.material_start[m + 1];
+                if (first == last)
+                    continue;
+
+                std::visit([&](const auto &material) { shade(stage, material, &paths.by_material[first], &paths.by_material[last]); },
+                           materials[std::uint32_t(m)]);
+            }
+
+            // A luz das amostras diretas entra antes da emissão que o próximo trecho pode encontrar,
+            // na mesma ordem do MEGAKERNEL
+            trace_shadows(stage);
+
+            // Os caminhos que continuam formam a nova fila de ativos, na ordem da fila by_material
+            std::swap(paths.active, paths.next);
+        }
+    }
+
+} // namespace
+
+void Render::sample_tile_wavefront(const Tile &tile, const HittableList &world, SampleBuffer &samples, const std::vector<std::uint32_t> &targets) {
+    // Sem nenhum trecho, nem o raio da câmera é testado
+    if (m_max_recursive_depth <= 0) {
+        sample_tile(tile, world, samples, targets);
+        return;
+    }
+
+    auto tile_width = tile.end_i - tile.start_i;
+    auto sampler = make_sampler();
+
+    auto &paths = t_paths;
+    if (paths.pixel.size() < WavefrontPaths::MAX_PATHS)
+        paths.resize(WavefrontPaths::MAX_PATHS);
+
+    WavefrontStage stage{*this, tile, world, paths, sampler, m_max_recursive_depth, m_roulette_min_depth, m_sort_rays};
+    std::size_t count = 0;
+
+    // As amostras de cada pixel são acumuladas na ordem dos índices, como em sample_tile
+    auto flush = [&]() {
+        trace(stage, count);
+
+        for (std::size_t k = 0; k < count; ++k) {
+            auto &estimate = samples.pixel(stage.pixel_i(paths.pixel[k]), stage.pixel_j(paths.pixel[k]));
+            estimate.add(paths.radiance.get(k));
+            estimate.add_features(paths.albedo.get(k), paths.normal.get(k), paths.depth[k]);
+        }
+
+        count = 0;
+    };
+
+    for (auto j = tile.start_j; j < tile.end_j; ++j) {
+      for (auto i = tile.start_i; i < tile.end_i; ++i) {
+        auto pixel = std::uint32_t(j - tile.start_j) * std::uint32_t(tile_width) + std::uint32_t(i - tile.start_i);
+
+        for (auto sample = samples.pixel(i, j).count; sample < targets[pixel]; ++sample) {
+            if (count == WavefrontPaths::MAX_PATHS)
+                flush();
+
+            paths.pixel[count] = pixel;
+            paths.sample[count] = sample;
+            ++count;
+        }
+      }
+    }
+
+    if (count > 0)
+        flush();
+}
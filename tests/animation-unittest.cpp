@@ -0,0 +1,139 @@
+#include "../lib/animation.hpp"
+#include "../lib/random.hpp"
+#include "../lib/scene.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+
+namespace {
+
+    std::string ler_arquivo(const std::string &nome) {
+        std::ifstream arquivo(nome, std::ios_base::binary);
+        return std::string(std::istreambuf_iterator<char>(arquivo), std::istreambuf_iterator<char>());
+    }
+
+} // namespace
+
+TEST(Animacao, SplinePassaPelosQuadrosChaveEFicaParadaForaDeles) {
+    Animation animacao;
+    animacao.add_sphere_key(0, 10, Point3{0, 0, 0});
+    animacao.add_sphere_key(0, 0, Point3{-2, 1, 0});
+    animacao.add_sphere_key(0, 30, Point3{4, 0, 2});
+
+    EXPECT_EQ(animacao.sphere_center_at(0, 0).x(), -2);
+    EXPECT_EQ(animacao.sphere_center_at(0, 10).y(), 0);
+    EXPECT_EQ(animacao.sphere_center_at(0, 30).z(), 2);
+
+    EXPECT_EQ(animacao.sphere_center_at(0, -5).x(), -2);
+    EXPECT_EQ(animacao.sphere_center_at(0, 100).x(), 4);
+
+    // Entre dois quadros-chave, o valor fica entre eles (a spline não "passa do ponto" neste caso)
+    auto meio = animacao.sphere_center_at(0, 20);
+    EXPECT_GT(meio.x(), 0);
+    EXPECT_LT(meio.x(), 4);
+}
+
+TEST(Animacao, DoisQuadrosChaveResultamEmMovimentoUniforme) {
+    Animation animacao;
+    animacao.add_camera_key(0, CameraSettings{Point3{0, 0, 0}, Point3{0, 0, -1}, Vec3{0, 1, 0}, 90});
+    animacao.add_camera_key(8, CameraSettings{Point3{4, 0, 0}, Point3{0, 0, -1}, Vec3{0, 1, 0}, 50});
+
+    auto camera = animacao.camera_at(2);
+    EXPECT_NEAR(camera.lookfrom.x(), 1.0, 1e-12);
+    EXPECT_NEAR(camera.vfov, 80.0, 1e-12);
+}
+
+TEST(Animacao, NomeDosQuadros) {
+    EXPECT_EQ(frame_filename("quadro_####.ppm", 12), "quadro_0012.ppm");
+    EXPECT_EQ(frame_filename("q#.ppm", 123), "q123.ppm");
+    EXPECT_EQ(frame_filename("saida/anim.pfm", 7), "saida/anim_0007.pfm");
+    EXPECT_EQ(frame_filename("saida.d/anim", 7), "saida.d/anim_0007");
+}
+
+TEST(Animacao, BVHAjustadaEncontraOsMesmosObjetosQueUmaNova) {
+    HittableList movida;
+    movida.materials.add(Lambertian{Vec3{0.5, 0.5, 0.5}});
+
+    for (int k = 0; k < 40; ++k)
+        movida.add_to_obj_list(std::make_shared<Sphere>(Point3{k % 8 - 4.0, k / 8 - 2.0, -6.0}, 0.3, 0));
+
+    movida.build_acceleration();
+
+    Animation animacao;
+    for (std::uint32_t k = 0; k < 40; k += 3) {
+        animacao.add_sphere_key(k, 0, Point3{0, 0, -6});
+        animacao.add_sphere_key(k, 4, Point3{k * 0.2 - 4.0, 3.0 - k * 0.1, -3.0 - k * 0.05});
+    }
+
+    ASSERT_TRUE(animacao.apply(2.5, movida));
+
+    // A mesma cena montada do zero nas posições finais
+    HittableList nova;
+    for (const auto &objeto : movida.objects) {
+        auto esfera = std::static_pointer_cast<Sphere>(objeto);
+        nova.add_to_obj_list(std::make_shared<Sphere>(esfera->center(), esfera->radius(), 0));
+    }
+    nova.build_acceleration();
+
+    Pcg32 gerador{3};
+    for (int k = 0; k < 2000; ++k) {
+        Ray raio{Point3{0, 0, 2}, Vec3{gerador.next_double() - 0.5, gerador.next_double() - 0.5, -1}};
+
+        HitRecord obtido, esperado;
+        bool tocou = movida.hit(raio, Interval(0.001, Utility::INFTY), obtido);
+
+        ASSERT_EQ(tocou, nova.hit(raio, Interval(0.001, Utility::INFTY), esperado));
+        if (tocou)
+            EXPECT_EQ(obtido.t, esperado.t);
+    }
+}
+
+TEST(Animacao, QuadrosGravadosSaoIguaisAUmaRenderizacaoIsolada) {
+    Scene cena;
+    std::string erro;
+    ASSERT_TRUE(cena.parse("material m lambertian 0.5 0.5 0.5\n"
+                           "sphere 0 -100.5 -1 100 m\n"
+                           "sphere 0 0 -1 0.5 m\n"
+                           "key 0 camera 0 0 0  0 0 -1  0 1 0  90\n"
+                           "key 2 camera 1 0.5 0  0 0 -1  0 1 0  70\n"
+                           "key 0 sphere 1  0 0 -1\n"
+                           "key 2 sphere 1  0.5 0.2 -1.5\n", erro)) << erro;
+
+    auto padrao = (std::filesystem::temp_directory_path() / "ray_tracing_quadro_##.pfm").string();
+
+    Render render{64};
+    render.set_samples_per_pixel(4);
+    render.set_thread_count(2);
+    render.set_seed(5);
+    render.set_quiet(true);
+
+    auto mundo = cena.world();
+    ASSERT_TRUE(render_animation(render, mundo, cena.animation(), 0, 2, padrao, ImageFormat::PFM));
+
+    // O quadro 1, renderizado sozinho a partir da cena original
+    Render isolado{64};
+    isolado.set_samples_per_pixel(4);
+    isolado.set_thread_count(1);
+    isolado.set_seed(Random::mix_bits(5 ^ std::uint64_t(1)));
+    isolado.set_quiet(true);
+    isolado.set_camera(cena.animation().camera_at(1));
+
+    auto mundo_isolado = cena.world();
+    ASSERT_TRUE(cena.animation().apply(1, mundo_isolado));
+
+    auto esperado = (std::filesystem::temp_directory_path() / "ray_tracing_quadro_isolado.pfm").string();
+    SampleBuffer amostras;
+    while (!isolado.render(mundo_isolado, amostras)) {}
+    ASSERT_TRUE(isolado.write_images(amostras, esperado.c_str(), ImageFormat::PFM));
+
+    EXPECT_EQ(ler_arquivo(frame_filename(padrao, 1)), ler_arquivo(esperado));
+    EXPECT_NE(ler_arquivo(frame_filename(padrao, 0)), ler_arquivo(esperado));
+
+    for (int quadro = 0; quadro <= 2; ++quadro) {
+        EXPECT_TRUE(std::filesystem::exists(frame_filename(padrao, quadro)));
+        std::filesystem::remove(frame_filename(padrao, quadro));
+    }
+    std::filesystem::remove(esperado);
+}
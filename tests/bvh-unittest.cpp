@@ -0,0 +1,155 @@
+#include "../lib/bvh.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/random.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+    std::vector<std::shared_ptr<Hittable>> esferas_aleatorias(std::size_t quantidade, Pcg32 &gerador) {
+        std::vector<std::shared_ptr<Hittable>> esferas;
+
+        for (std::size_t k = 0; k < quantidade; ++k) {
+            Vec3 centro{20 * gerador.next_double() - 10, 20 * gerador.next_double() - 10, 20 * gerador.next_double() - 10};
+            esferas.push_back(std::make_shared<Sphere>(centro, 0.1 + gerador.next_double(), 0));
+        }
+
+        return esferas;
+    }
+}
+
+TEST(BVH, MesmoResultadoQueListaLinear) {
+    Pcg32 gerador{1};
+
+    HittableList lista;
+    lista.objects = esferas_aleatorias(2000, gerador);
+    BVH bvh{lista.objects};
+
+    for (int k = 0; k < 5000; ++k) {
+        Vec3 origem{30 * gerador.next_double() - 15, 30 * gerador.next_double() - 15, 30 * gerador.next_double() - 15};
+        Vec3 direcao{gerador.next_double() - 0.5, gerador.next_double() - 0.5, gerador.next_double() - 0.5};
+        Ray raio{origem, direcao};
+
+        HitRecord registro_lista;
+        HitRecord registro_bvh;
+
+        bool acertou_lista = lista.hit(raio, Interval(0.001, Utility::INFTY), registro_lista);
+        bool acertou_bvh = bvh.hit(raio, Interval(0.001, Utility::INFTY), registro_bvh);
+
+        ASSERT_EQ(acertou_lista, acertou_bvh);
+
+        if (acertou_lista)
+            EXPECT_DOUBLE_EQ(registro_lista.t, registro_bvh.t);
+    }
+}
+
+TEST(BVH, CaixaEnvolveTodosOsObjetos) {
+    Pcg32 gerador{2};
+    auto esferas = esferas_aleatorias(500, gerador);
+    BVH bvh{esferas};
+
+    auto caixa = bvh.bounding_box();
+    for (const auto &esfera : esferas) {
+        auto caixa_esfera = esfera->bounding_box();
+
+        EXPECT_LE(caixa.min().x(), caixa_esfera.min().x());
+        EXPECT_LE(caixa.min().y(), caixa_esfera.min().y());
+        EXPECT_LE(caixa.min().z(), caixa_esfera.min().z());
+        EXPECT_GE(caixa.max().x(), caixa_esfera.max().x());
+        EXPECT_GE(caixa.max().y(), caixa_esfera.max().y());
+        EXPECT_GE(caixa.max().z(), caixa_esfera.max().z());
+    }
+}
+
+TEST(BVH, ListaGrandeUsaAceleracao) {
+    Pcg32 gerador{3};
+
+    HittableList lista;
+    lista.objects = esferas_aleatorias(100, gerador);
+
+    Ray raio{Vec3{-20, 0, 0}, Vec3{1, 0, 0}};
+    HitRecord antes;
+    HitRecord depois;
+
+    bool acertou_antes = lista.hit(raio, Interval(0.001, Utility::INFTY), antes);
+    lista.build_acceleration();
+    bool acertou_depois = lista.hit(raio, Interval(0.001, Utility::INFTY), depois);
+
+    ASSERT_EQ(acertou_antes, acertou_depois);
+    if (acertou_antes)
+        EXPECT_DOUBLE_EQ(antes.t, depois.t);
+}
+
+TEST(BVH, PacoteIgualARaiosIndividuais) {
+    Pcg32 gerador{4};
+
+    // Esferas (caminho SphereSoA) e lista mista com outra BVH dentro (caminho de chamadas virtuais)
+    auto esferas = esferas_aleatorias(300, gerador);
+    BVH bvh_esferas{esferas};
+
+    std::vector<std::shared_ptr<Hittable>> objetos_mistos = esferas_aleatorias(50, gerador);
+    objetos_mistos.push_back(std::make_shared<BVH>(esferas_aleatorias(50, gerador)));
+    BVH bvh_misto{objetos_mistos};
+
+    for (const BVH *bvh : {&bvh_esferas, &bvh_misto}) {
+        for (int k = 0; k < 200; ++k) {
+            RayPacket pacote;
+            Vec3 origem{30 * gerador.next_double() - 15, 30 * gerador.next_double() - 15, 30 * gerador.next_double() - 15};
+            Vec3 alvo{4 * gerador.next_double() - 2, 4 * gerador.next_double() - 2, 4 * gerador.next_double() - 2};
+
+            for (int raio = 0; raio < RayPacket::MAX_SIZE; ++raio) {
+                Vec3 desvio{gerador.next_double() - 0.5, gerador.next_double() - 0.5, gerador.next_double() - 0.5};
+                pacote.add(Ray{origem, alvo + desvio - origem});
+            }
+
+            HitRecord registros[RayPacket::MAX_SIZE];
+            bool acertos[RayPacket::MAX_SIZE];
+            bvh->hit_packet(pacote, Interval(0.001, Utility::INFTY), registros, acertos);
+
+            for (int raio = 0; raio < pacote.size; ++raio) {
+                HitRecord registro;
+                bool acertou = bvh->hit(pacote.ray(raio), Interval(0.001, Utility::INFTY), registro);
+
+                ASSERT_EQ(acertou, acertos[raio]);
+                if (acertou)
+                    EXPECT_EQ(registro.t, registros[raio].t);
+            }
+        }
+    }
+}
+
+TEST(BVH, ValidacaoRejeitaNosInvalidosEArvoresAltas) {
+    Pcg32 gerador{11};
+    std::vector<AABB> caixas;
+    for (const auto &esfera : esferas_aleatorias(1000, gerador))
+        caixas.push_back(esfera->bounding_box());
+
+    std::vector<std::uint32_t> ordem;
+    auto nos = build_bvh(caixas, ordem);
+    EXPECT_TRUE(valid_bvh_nodes(nos.data(), nos.size(), caixas.size()));
+    EXPECT_FALSE(valid_bvh_nodes(nos.data(), nos.size(), caixas.size() - 1));
+
+    // Corrente de nós internos em que o filho esquerdo de cada um é uma folha e o direito é o próximo nó
+    // interno: com mais de BVH_STACK_SIZE nós internos a travessia poderia estourar a pilha
+    auto corrente = [](std::size_t internos) {
+        std::vector<BVHNode> nos(2 * internos + 1);
+        for (std::size_t k = 0; k < internos; ++k) {
+            nos[2 * k] = BVHNode{AABB{}, std::uint32_t(2 * k + 2), 0, 0};
+            nos[2 * k + 1] = BVHNode{AABB{}, 0, 1, 0};
+        }
+        nos.back() = BVHNode{AABB{}, 0, 1, 0};
+        return nos;
+    };
+
+    auto rasa = corrente(BVH_STACK_SIZE);
+    EXPECT_TRUE(valid_bvh_nodes(rasa.data(), rasa.size(), 1));
+
+    auto funda = corrente(BVH_STACK_SIZE + 1);
+    EXPECT_FALSE(valid_bvh_nodes(funda.data(), funda.size(), 1));
+
+    // Filho direito antes do pai
+    auto ciclo = corrente(2);
+    ciclo[2].offset = 0;
+    EXPECT_FALSE(valid_bvh_nodes(ciclo.data(), ciclo.size(), 1));
+}
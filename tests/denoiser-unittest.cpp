@@ -0,0 +1,137 @@
+#include "../lib/denoiser.hpp"
+#include "../lib/render.hpp"
+#include "../lib/random.hpp"
+
+#include <cmath>
+#include <filesystem>
+#include <gtest/gtest.h>
+
+namespace {
+
+    // Erro quadrático médio entre duas imagens, depois da correção gamma (como a imagem é vista)
+    double erro_medio(const Framebuffer &imagem, const Framebuffer &referencia) {
+        double soma = 0.0;
+        for (int j = 0; j < imagem.height(); ++j) {
+            for (int i = 0; i < imagem.width(); ++i) {
+                for (int canal = 0; canal < 3; ++canal) {
+                    double diferenca = std::sqrt(std::max(imagem.pixel(i, j)[canal], 0.0))
+                                     - std::sqrt(std::max(referencia.pixel(i, j)[canal], 0.0));
+                    soma += diferenca * diferenca;
+                }
+            }
+        }
+        return std::sqrt(soma / (3.0 * imagem.width() * imagem.height()));
+    }
+
+    SampleBuffer renderizar(const HittableList &mundo, int amostras, std::uint64_t semente) {
+        Render render{128};
+        render.set_samples_per_pixel(amostras);
+        render.set_seed(semente);
+        render.set_quiet(true);
+
+        SampleBuffer buffer;
+        while (!render.render(mundo, buffer)) {}
+        return buffer;
+    }
+
+} // namespace
+
+TEST(FiltroDeRuido, AtributosDoPrimeiroPontoSaoGravadosComAsAmostras) {
+    auto mundo = Render::default_scene();
+    auto amostras = renderizar(mundo, 4, 1);
+
+    // Centro da imagem: esfera difusa em (0, 0, -1.2), de raio 0.5, vista de frente
+    const auto &centro = amostras.pixel(64, 36);
+    EXPECT_NEAR(centro.albedo().x(), 0.1, 1e-12);
+    EXPECT_NEAR(centro.albedo().z(), 0.5, 1e-12);
+    EXPECT_NEAR(centro.depth(), 0.7, 0.01);
+    EXPECT_GT(centro.normal().z(), 0.99);
+
+    // Canto superior: céu, sem normal nem profundidade
+    const auto &ceu = amostras.pixel(0, 0);
+    EXPECT_EQ(ceu.depth(), 0.0);
+    EXPECT_TRUE(ceu.normal().near_zero());
+    EXPECT_GT(ceu.albedo().z(), ceu.albedo().x());
+
+    // Os atributos sobrevivem ao checkpoint
+    auto arquivo = (std::filesystem::temp_directory_path() / "ray_tracing_atributos.ckpt").string();
+    ASSERT_TRUE(amostras.save(arquivo.c_str(), 7));
+
+    SampleBuffer lido;
+    ASSERT_TRUE(lido.load(arquivo.c_str(), 7));
+    EXPECT_EQ(lido.pixel(64, 36).albedo_sum.x(), centro.albedo_sum.x());
+    EXPECT_EQ(lido.pixel(64, 36).normal_sum.z(), centro.normal_sum.z());
+    EXPECT_EQ(lido.pixel(64, 36).depth_sum, centro.depth_sum);
+
+    std::filesystem::remove(arquivo);
+}
+
+TEST(FiltroDeRuido, ReduzADiferencaEntreSementesSemMudarOBrilho) {
+    auto mundo = Render::default_scene();
+
+    // Sem uma referência convergida (cara demais aqui), o ruído é medido pela diferença entre duas
+    // renderizações com sementes diferentes
+    auto primeira = renderizar(mundo, 16, 3);
+    auto segunda = renderizar(mundo, 16, 4);
+
+    Framebuffer primeira_sem_filtro, segunda_sem_filtro, primeira_filtrada, segunda_filtrada;
+    primeira.resolve(primeira_sem_filtro);
+    segunda.resolve(segunda_sem_filtro);
+
+    ThreadPool threads{2};
+    Denoiser{}.apply(primeira, primeira_filtrada, &threads);
+    Denoiser{}.apply(segunda, segunda_filtrada, &threads);
+
+    // Desvio padrão pelo menos pela metade (variância 4 vezes menor) mesmo nesta imagem pequena, em
+    // que as bordas ocupam boa parte dos pixels
+    EXPECT_LT(erro_medio(primeira_filtrada, segunda_filtrada), 0.5 * erro_medio(primeira_sem_filtro, segunda_sem_filtro));
+
+    // O mesmo resultado com e sem as threads
+    Framebuffer sem_threads;
+    Denoiser{}.apply(primeira, sem_threads);
+    EXPECT_EQ(erro_medio(sem_threads, primeira_filtrada), 0.0);
+
+    // O filtro redistribui a luz entre vizinhos, sem criar nem tirar energia da imagem
+    double soma_filtrada = 0.0, soma_sem_filtro = 0.0;
+    for (int j = 0; j < primeira.height(); ++j) {
+        for (int i = 0; i < primeira.width(); ++i) {
+            soma_filtrada += primeira_filtrada.pixel(i, j).y();
+            soma_sem_filtro += primeira_sem_filtro.pixel(i, j).y();
+        }
+    }
+    EXPECT_NEAR(soma_filtrada / soma_sem_filtro, 1.0, 0.02);
+}
+
+TEST(FiltroDeRuido, BordasEntreMateriaisContinuamNitidas) {
+    // Metade esquerda com albedo escuro, metade direita claro, mesma normal e profundidade; a
+    // iluminação (cor / albedo) é 1 mais ruído nas duas metades
+    SampleBuffer amostras;
+    amostras.resize(32, 16);
+    Pcg32 gerador{5};
+
+    for (int j = 0; j < 16; ++j) {
+        for (int i = 0; i < 32; ++i) {
+            Vec3 albedo = i < 16 ? Vec3{0.1, 0.1, 0.1} : Vec3{0.9, 0.9, 0.9};
+            auto &pixel = amostras.pixel(i, j);
+
+            for (int k = 0; k < 8; ++k) {
+                pixel.add((0.5 + gerador.next_double()) * albedo);
+                pixel.add_features(albedo, Vec3{0, 0, 1}, 2.0);
+            }
+        }
+    }
+
+    Framebuffer filtrada;
+    Denoiser{}.apply(amostras, filtrada);
+
+    for (int j = 0; j < 16; ++j) {
+        EXPECT_NEAR(filtrada.pixel(15, j).x(), 0.1, 0.02);
+        EXPECT_NEAR(filtrada.pixel(16, j).x(), 0.9, 0.1);
+    }
+
+    // Longe da borda, o ruído (em torno de 1 * albedo) diminui
+    double variacao = 0.0;
+    for (int i = 20; i < 30; ++i)
+        variacao += std::fabs(filtrada.pixel(i, 8).x() - 0.9);
+    EXPECT_LT(variacao / 10, 0.05);
+}
@@ -0,0 +1,146 @@
+#include "../lib/distributed.hpp"
+#include "../lib/random.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+    void configurar(Render &render) {
+        render.set_samples_per_pixel(6);
+        render.set_thread_count(1);
+        render.set_quiet(true);
+    }
+
+    void esperar_iguais(const SampleBuffer &obtido, const SampleBuffer &esperado) {
+        ASSERT_EQ(obtido.width(), esperado.width());
+        ASSERT_EQ(obtido.total_samples(), esperado.total_samples());
+
+        for (int j = 0; j < esperado.height(); ++j) {
+            for (int i = 0; i < esperado.width(); ++i) {
+                EXPECT_EQ(obtido.pixel(i, j).sum.x(), esperado.pixel(i, j).sum.x());
+                EXPECT_EQ(obtido.pixel(i, j).sum.y(), esperado.pixel(i, j).sum.y());
+                EXPECT_EQ(obtido.pixel(i, j).luminance_m2, esperado.pixel(i, j).luminance_m2);
+            }
+        }
+    }
+
+} // namespace
+
+TEST(Distribuido, JuncaoDeEstimativasEquivaleASomarAsAmostras) {
+    Pcg32 gerador{9};
+    PixelEstimate todas, primeira, segunda;
+
+    for (int k = 0; k < 50; ++k) {
+        Vec3 cor{gerador.next_double(), gerador.next_double(), 2 * gerador.next_double()};
+        todas.add(cor);
+        (k < 18 ? primeira : segunda).add(cor);
+    }
+
+    primeira.merge(segunda);
+
+    EXPECT_EQ(primeira.count, todas.count);
+    EXPECT_NEAR(primeira.sum.z(), todas.sum.z(), 1e-12);
+    EXPECT_NEAR(primeira.luminance_mean, todas.luminance_mean, 1e-12);
+    EXPECT_NEAR(primeira.luminance_m2, todas.luminance_m2, 1e-10);
+}
+
+TEST(Distribuido, TilesEmPartesSeparadasFormamAMesmaImagem) {
+    auto world = Render::default_scene();
+
+    Render direto{80};
+    configurar(direto);
+    SampleBuffer esperado;
+    while (!direto.render(world, esperado)) {}
+
+    Render render{80};
+    configurar(render);
+    int tiles = int(render.split_into_tiles().size());
+
+    std::vector<int> pares, impares;
+    for (int k = 0; k < tiles; ++k)
+        (k % 2 ? impares : pares).push_back(k);
+
+    SampleBuffer parte_a, parte_b;
+    while (!render.render(world, parte_a, pares)) {}
+    while (!render.render(world, parte_b, impares)) {}
+
+    ASSERT_TRUE(parte_a.merge(parte_b));
+    esperar_iguais(parte_a, esperado);
+}
+
+TEST(Distribuido, CoordenadorRedistribuiOsTilesDeUmWorkerQueFalhou) {
+    auto world = Render::default_scene();
+
+    Render direto{96};
+    configurar(direto);
+    SampleBuffer esperado;
+    while (!direto.render(world, esperado)) {}
+
+    Render coordenador{96};
+    configurar(coordenador);
+    auto tiles = coordenador.split_into_tiles().size();
+
+    // Quatro workers em threads, ligados ao coordenador por pipes: dois que renderizam, um que fecha os
+    // pipes sem responder e um que só falha depois que todos os outros tiles já foram entregues. Os que
+    // renderizam recebem os índices por uma thread que os conta antes de repassá-los.
+    std::vector<Distributed::Worker> workers;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> entregues{0};
+
+    for (int k = 0; k < 4; ++k) {
+        int para_worker[2];
+        int do_worker[2];
+        ASSERT_EQ(::pipe(para_worker), 0);
+        ASSERT_EQ(::pipe(do_worker), 0);
+
+        workers.push_back(Distributed::Worker{para_worker[1], do_worker[0], -1});
+
+        threads.emplace_back([&, entrada = para_worker[0], saida = do_worker[1], k]() {
+            if (k < 2) {
+                int repasse[2];
+                if (::pipe(repasse) == 0) {
+                    std::thread contar([&, destino = repasse[1]]() {
+                        std::uint32_t tile;
+                        while (::read(entrada, &tile, sizeof(tile)) == sizeof(tile)) {
+                            ++entregues;
+                            if (::write(destino, &tile, sizeof(tile)) != sizeof(tile))
+                                break;
+                        }
+                        ::close(destino);
+                    });
+
+                    Render render{96};
+                    configurar(render);
+                    Distributed::run_worker(render, world, repasse[0], saida);
+
+                    ::close(repasse[0]);
+                    contar.join();
+                }
+            }
+            else if (k == 3) {
+                // Espera a fila esvaziar (os seus PIPELINE_DEPTH tiles nunca são respondidos) e dá tempo
+                // para os outros workers ficarem sem trabalho
+                while (entregues < tiles - Distributed::PIPELINE_DEPTH)
+                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            }
+
+            ::close(entrada);
+            ::close(saida);
+        });
+    }
+
+    SampleBuffer obtido;
+    bool terminou = Distributed::distribute_tiles(coordenador, workers, obtido);
+
+    Distributed::finish_workers(workers);
+    for (auto &thread : threads)
+        thread.join();
+
+    ASSERT_TRUE(terminou);
+    esperar_iguais(obtido, esperado);
+}
@@ -0,0 +1,181 @@
+#include "../lib/environment.hpp"
+#include "../lib/framebuffer.hpp"
+#include "../lib/random.hpp"
+#include "../lib/render.hpp"
+
+#include <cmath>
+#include <filesystem>
+#include <gtest/gtest.h>
+
+namespace {
+
+    // Céu azulado de 64 x 32 pixels com um "sol" de 2 x 2 pixels, bem mais claro que o resto
+    std::vector<float> ceu_com_sol(int largura, int altura) {
+        std::vector<float> rgb(3 * std::size_t(largura) * altura);
+
+        for (int y = 0; y < altura; ++y) {
+            for (int x = 0; x < largura; ++x) {
+                float *pixel = &rgb[3 * (std::size_t(y) * largura + x)];
+                bool sol = (x == 40 || x == 41) && (y == 9 || y == 10);
+
+                pixel[0] = sol ? 3000.0f : 0.3f;
+                pixel[1] = sol ? 2800.0f : 0.4f;
+                pixel[2] = sol ? 2500.0f : 0.6f;
+            }
+        }
+
+        return rgb;
+    }
+
+    // Direção do centro do pixel (x, y) do mapa
+    Vec3 direcao_do_pixel(const EnvironmentMap &mapa, int x, int y) {
+        double theta = Utility::PI * (y + 0.5) / mapa.height();
+        double phi = 2.0 * Utility::PI * ((x + 0.5) / mapa.width() - 0.5);
+        return Vec3{std::sin(theta) * std::sin(phi), std::cos(theta), -std::sin(theta) * std::cos(phi)};
+    }
+
+    // Chão difuso (quase um plano em y = 0) sob o mapa de ambiente
+    HittableList chao_sob_o_mapa(std::shared_ptr<const EnvironmentMap> mapa, bool amostrado) {
+        HittableList mundo;
+        auto chao = mundo.materials.add(Lambertian{Vec3{0.5, 0.5, 0.5}});
+        mundo.add_to_obj_list(std::make_shared<Sphere>(Vec3{0, -1000, 0}, 1000.0, chao));
+        mundo.lights.set_environment(std::move(mapa), amostrado);
+        return mundo;
+    }
+
+    struct Estimativa {
+        double media;
+        double desvio_padrao;
+    };
+
+    // Média e desvio padrão da luz refletida pela origem do chão, vista de cima
+    Estimativa luz_no_chao(const HittableList &mundo, int amostras) {
+        Render render{64};
+        double soma = 0.0, soma_quadrados = 0.0;
+
+        for (int amostra = 0; amostra < amostras; ++amostra) {
+            Random::begin_path(21, 0, std::uint64_t(amostra));
+            auto cor = render.ray_color(Ray{Point3{0, 1, 0}, Vec3{0, -1, 0}}, mundo, 50);
+            soma += cor.y();
+            soma_quadrados += cor.y() * cor.y();
+        }
+
+        double media = soma / amostras;
+        return Estimativa{media, std::sqrt(std::max(0.0, soma_quadrados / amostras - media * media))};
+    }
+
+} // namespace
+
+TEST(MapaDeAmbiente, LeituraDoPfm) {
+    Framebuffer imagem{8, 4};
+    for (int j = 0; j < 4; ++j)
+        for (int i = 0; i < 8; ++i)
+            imagem.set_pixel(i, j, Vec3{double(i), double(j), 0.25 * (i + j)});
+
+    auto arquivo = (std::filesystem::temp_directory_path() / "ray_tracing_ambiente.pfm").string();
+    ASSERT_TRUE(imagem.write(arquivo.c_str(), ImageFormat::PFM));
+
+    EnvironmentMap mapa;
+    std::string erro;
+    ASSERT_TRUE(mapa.load(arquivo.c_str(), erro)) << erro;
+    EXPECT_EQ(mapa.width(), 8);
+    EXPECT_EQ(mapa.height(), 4);
+
+    // A linha de cima do PFM (gravado de baixo para cima) é a do céu acima (+y)
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 0; i < 8; ++i) {
+            auto cor = mapa.radiance(direcao_do_pixel(mapa, i, j));
+            EXPECT_EQ(cor.x(), double(i));
+            EXPECT_EQ(cor.y(), double(j));
+        }
+    }
+
+    // O centro da imagem fica à frente da câmera padrão (-z)
+    EXPECT_EQ(mapa.radiance(Vec3{0, 0.1, -1}).x(), 4.0);
+
+    std::filesystem::remove(arquivo);
+    EXPECT_FALSE(mapa.load(arquivo.c_str(), erro));
+}
+
+TEST(MapaDeAmbiente, DistribuicaoIntegraUmEFavoreceOSol) {
+    EnvironmentMap mapa;
+    mapa.assign(64, 32, ceu_com_sol(64, 32));
+
+    // A densidade integra 1 na esfera: com direções uniformes, E[pdf / (1 / 4π)] = 1
+    Pcg32 gerador{8};
+    constexpr int N = 400000;
+    double soma = 0.0;
+    for (int k = 0; k < N; ++k) {
+        double u = gerador.next_double();
+        soma += mapa.pdf(Sampling::uniform_sphere(Sampling::Point2{u, gerador.next_double()})) / Sampling::uniform_sphere_pdf();
+    }
+    EXPECT_NEAR(soma / N, 1.0, 0.02);
+
+    // Parte do peso (luminância vezes sin θ) que fica no sol
+    double peso_do_sol = 0.0, peso_total = 0.0;
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            auto cor = mapa.radiance(direcao_do_pixel(mapa, x, y));
+            double peso = (0.2126 * cor.x() + 0.7152 * cor.y() + 0.0722 * cor.z()) * std::sin(Utility::PI * (y + 0.5) / 32);
+            peso_total += peso;
+            peso_do_sol += cor.x() > 1000.0 ? peso : 0.0;
+        }
+    }
+
+    // As amostras trazem a mesma densidade e cor que pdf() e radiance() dão à direção sorteada, e caem
+    // no sol na proporção do peso dele (quase toda a luz do mapa, em 4 de 2048 pixels)
+    int no_sol = 0;
+    for (int k = 0; k < 10000; ++k) {
+        Vec3 direcao, cor;
+        double densidade;
+        double u = gerador.next_double();
+        ASSERT_TRUE(mapa.sample(Sampling::Point2{u, gerador.next_double()}, direcao, cor, densidade));
+        ASSERT_NEAR(direcao.length(), 1.0, 1e-12);
+
+        EXPECT_NEAR(densidade, mapa.pdf(direcao), 1e-9 * densidade);
+        EXPECT_EQ(cor.x(), mapa.radiance(direcao).x());
+        no_sol += cor.x() > 1000.0;
+    }
+    EXPECT_NEAR(no_sol / 10000.0, peso_do_sol / peso_total, 0.01);
+
+    // Um mapa todo preto não tem o que amostrar
+    EnvironmentMap preto;
+    preto.assign(4, 2, std::vector<float>(24, 0.0f));
+    Vec3 direcao, cor;
+    double densidade;
+    EXPECT_FALSE(preto.sample(Sampling::Point2{0.5, 0.5}, direcao, cor, densidade));
+    EXPECT_EQ(preto.pdf(Vec3{0, 1, 0}), 0.0);
+    EXPECT_NE(preto.hash(), mapa.hash());
+}
+
+TEST(MapaDeAmbiente, CeuConstanteIluminaOChaoPorInteiro) {
+    // Radiância L em todo o hemisfério: o chão difuso recebe πL e reflete albedo * L
+    auto mapa = std::make_shared<EnvironmentMap>();
+    mapa->assign(16, 8, std::vector<float>(3 * 16 * 8, 0.5f));
+
+    EXPECT_NEAR(luz_no_chao(chao_sob_o_mapa(mapa, true), 20000).media, 0.25, 0.0025);
+    EXPECT_NEAR(luz_no_chao(chao_sob_o_mapa(mapa, false), 20000).media, 0.25, 0.0025);
+}
+
+TEST(MapaDeAmbiente, AmostragemDoSolConcordaComOsQuiquesEReduzORuido) {
+    auto mapa = std::make_shared<EnvironmentMap>();
+    mapa->assign(64, 32, ceu_com_sol(64, 32));
+
+    // Valor exato: a soma, sobre os pixels acima do horizonte, de albedo / π * L * cos(θ) * ângulo sólido
+    double esperado = 0.0;
+    for (int y = 0; y < 16; ++y) {
+        double theta_0 = Utility::PI * y / 32, theta_1 = Utility::PI * (y + 1) / 32;
+        for (int x = 0; x < 64; ++x) {
+            // ∫ cos θ sin θ dθ dφ sobre o pixel
+            double integral = 0.5 * (std::sin(theta_1) * std::sin(theta_1) - std::sin(theta_0) * std::sin(theta_0)) * 2.0 * Utility::PI / 64;
+            esperado += 0.5 / Utility::PI * mapa->radiance(direcao_do_pixel(*mapa, x, y)).y() * integral;
+        }
+    }
+
+    auto com_amostragem = luz_no_chao(chao_sob_o_mapa(mapa, true), 20000);
+    auto sem_amostragem = luz_no_chao(chao_sob_o_mapa(mapa, false), 800000);
+
+    EXPECT_NEAR(com_amostragem.media, esperado, 0.01 * esperado);
+    EXPECT_NEAR(sem_amostragem.media, esperado, 0.05 * esperado);
+    EXPECT_LT(com_amostragem.desvio_padrao, 0.1 * sem_amostragem.desvio_padrao);
+}
@@ -0,0 +1,186 @@
+#include "../lib/instance.hpp"
+#include "../lib/random.hpp"
+#include "../lib/scene.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace {
+
+    void esperar_perto(const Vec3 &obtido, const Vec3 &esperado, double tolerancia) {
+        EXPECT_NEAR(obtido.x(), esperado.x(), tolerancia);
+        EXPECT_NEAR(obtido.y(), esperado.y(), tolerancia);
+        EXPECT_NEAR(obtido.z(), esperado.z(), tolerancia);
+    }
+
+    Vec3 vetor_aleatorio(Pcg32 &gerador) {
+        return Vec3{2 * gerador.next_double() - 1, 2 * gerador.next_double() - 1, 2 * gerador.next_double() - 1};
+    }
+
+} // namespace
+
+TEST(Transformacao, ComposicaoEInversa) {
+    auto rotacao = Transform::rotate(Vec3{0, 0, 1}, 90);
+    esperar_perto(rotacao.apply_vector(Vec3{1, 0, 0}), Vec3{0, 1, 0}, 1e-15);
+
+    // scale é aplicada primeiro, depois rotate e por último translate
+    auto composta = Transform::translate(Vec3{1, 2, 3}) * rotacao * Transform::scale(Vec3{2, 1, 1});
+    esperar_perto(composta.apply_point(Point3{1, 0, 0}), Point3{1, 4, 3}, 1e-15);
+    esperar_perto(composta.apply_vector(Vec3{1, 0, 0}), Vec3{0, 2, 0}, 1e-15);
+
+    auto inversa = composta.inverse();
+    EXPECT_TRUE((Transform{} * Transform{}).is_identity());
+    EXPECT_FALSE(composta.is_identity());
+
+    Pcg32 gerador{12};
+    for (int k = 0; k < 100; ++k) {
+        auto ponto = vetor_aleatorio(gerador);
+        esperar_perto(inversa.apply_point(composta.apply_point(ponto)), ponto, 1e-14);
+    }
+}
+
+TEST(Instancia, EsferaTransladadaEEscaladaIgualAEsferaEquivalente) {
+    auto unitaria = std::make_shared<Sphere>(Point3{0, 0, 0}, 1.0, 0);
+    Instance instancia{unitaria, Transform::translate(Vec3{3, 0, -5}) * Transform::scale(Vec3{2, 2, 2}), 4};
+    Sphere esperada{Point3{3, 0, -5}, 2.0, 4};
+
+    esperar_perto(instancia.bounding_box().min(), esperada.bounding_box().min(), 1e-15);
+    esperar_perto(instancia.bounding_box().max(), esperada.bounding_box().max(), 1e-15);
+
+    Pcg32 gerador{6};
+    int acertos = 0;
+
+    for (int k = 0; k < 2000; ++k) {
+        Ray raio{Point3{3, 0, -5} + 3.0 * vetor_aleatorio(gerador), vetor_aleatorio(gerador)};
+        HitRecord obtido, referencia;
+
+        bool tocou = esperada.hit(raio, Interval(0.001, Utility::INFTY), referencia);
+        ASSERT_EQ(instancia.hit(raio, Interval(0.001, Utility::INFTY), obtido), tocou);
+
+        if (tocou) {
+            EXPECT_NEAR(obtido.t, referencia.t, 1e-12);
+            esperar_perto(obtido.point, referencia.point, 1e-12);
+            esperar_perto(obtido.normal_sur_vector, referencia.normal_sur_vector, 1e-12);
+            EXPECT_EQ(obtido.is_front_face, referencia.is_front_face);
+            EXPECT_EQ(obtido.material, 4u);
+            ++acertos;
+        }
+    }
+
+    EXPECT_GT(acertos, 200);
+}
+
+TEST(Instancia, NormalDeEscalaNaoUniformeContinuaPerpendicularASuperficie) {
+    // Elipsoide x²/4 + y² + z² = 1, centrado na origem
+    Instance elipsoide{std::make_shared<Sphere>(Point3{0, 0, 0}, 1.0, 1), Transform::scale(Vec3{2, 1, 1})};
+
+    Pcg32 gerador{2};
+    for (int k = 0; k < 200; ++k) {
+        Ray raio{Point3{0, 0, 0} + 5.0 * vetor_aleatorio(gerador).unit(), Point3{0, 0, 0} + 0.3 * vetor_aleatorio(gerador)};
+        raio = Ray{raio.origin(), raio.direction() - raio.origin()};
+
+        HitRecord registro;
+        ASSERT_TRUE(elipsoide.hit(raio, Interval(0.001, Utility::INFTY), registro));
+
+        // O gradiente da equação do elipsoide é a normal para fora
+        const auto &p = registro.point;
+        EXPECT_NEAR(p.x() * p.x() / 4 + p.y() * p.y() + p.z() * p.z(), 1.0, 1e-12);
+        esperar_perto(registro.normal_sur_vector, Vec3{p.x() / 4, p.y(), p.z()}.unit(), 1e-12);
+        EXPECT_TRUE(registro.is_front_face);
+        EXPECT_EQ(registro.material, 1u);
+    }
+}
+
+TEST(Instancia, BVHDeInstanciasEncontraOMesmoQueOTesteLinear) {
+    std::vector<double> vertices = {-1, -1, 0, 1, -1, 0, 0, 1, 0, 0, 0, 1};
+    std::vector<std::uint32_t> indices = {0, 1, 2, 0, 1, 3, 1, 2, 3, 2, 0, 3};
+    auto tetraedro = std::make_shared<TriangleMesh>(vertices, indices, 0);
+
+    HittableList com_bvh, linear;
+    Pcg32 gerador{17};
+
+    for (int k = 0; k < 60; ++k) {
+        auto transformacao = Transform::translate(Vec3{8 * gerador.next_double() - 4, 6 * gerador.next_double() - 3, -4 - 6 * gerador.next_double()})
+                             * Transform::rotate(vetor_aleatorio(gerador), 360 * gerador.next_double())
+                             * Transform::scale(Vec3{0.3 + 0.4 * gerador.next_double(), 0.5, 0.4});
+        auto instancia = std::make_shared<Instance>(tetraedro, transformacao);
+
+        com_bvh.add_to_obj_list(instancia);
+        linear.add_to_obj_list(instancia);
+    }
+
+    com_bvh.build_acceleration();
+
+    int acertos = 0;
+    for (int k = 0; k < 3000; ++k) {
+        Ray raio{Point3{0, 0, 1}, Vec3{gerador.next_double() - 0.5, gerador.next_double() - 0.5, -1}};
+        HitRecord obtido, esperado;
+
+        bool tocou = linear.hit(raio, Interval(0.001, Utility::INFTY), esperado);
+        ASSERT_EQ(com_bvh.hit(raio, Interval(0.001, Utility::INFTY), obtido), tocou);
+
+        if (tocou) {
+            EXPECT_EQ(obtido.t, esperado.t);
+            ++acertos;
+        }
+    }
+
+    EXPECT_GT(acertos, 100);
+}
+
+TEST(Instancia, CenaCarregaCadaMalhaUmaUnicaVez) {
+    auto diretorio = std::filesystem::temp_directory_path() / "ray_tracing_cena_com_instancias";
+    std::filesystem::create_directories(diretorio);
+
+    {
+        std::ofstream malha((diretorio / "tri.obj").string());
+        malha << "v -1 -1 0\nv 1 -1 0\nv 0 1 0\nf 1 2 3\n";
+    }
+
+    std::string texto = "material a lambertian 0.5 0.5 0.5\n"
+                        "material b metal 0.8 0.8 0.8\n"
+                        "mesh tri.obj a\n"
+                        "instance tri.obj b  scale 0.5  translate 0 0 -2\n"
+                        "instance tri.obj a  rotate 0 1 0 180  scale 2 1 1  translate 5 0 -3\n";
+
+    Scene cena;
+    std::string erro;
+    ASSERT_TRUE(cena.parse(texto, erro, diretorio.string())) << erro;
+
+    EXPECT_EQ(cena.meshes().size(), 1u);
+    ASSERT_EQ(cena.instances().size(), 3u);
+
+    auto mundo = cena.world();
+    ASSERT_EQ(mundo.objects.size(), 3u);
+
+    // A cópia sem transformação é a própria malha
+    EXPECT_EQ(mundo.objects[0], cena.meshes()[0]);
+
+    HitRecord registro;
+    ASSERT_TRUE(mundo.hit(Ray{Point3{0, 0, 1}, Vec3{0, 0, -1}}, Interval(0.001, Utility::INFTY), registro));
+    EXPECT_NEAR(registro.t, 1.0, 1e-12);
+    EXPECT_EQ(registro.material, 0u);
+
+    ASSERT_TRUE(mundo.hit(Ray{Point3{0.2, -0.2, 1}, Vec3{0, 0, -1}}, Interval(1.5, Utility::INFTY), registro));
+    EXPECT_NEAR(registro.t, 3.0, 1e-12);
+    EXPECT_EQ(registro.material, 1u);
+
+    // Triângulo escalado para x em [3, 7] e girado (o vértice de cima continua no meio)
+    ASSERT_TRUE(mundo.hit(Ray{Point3{6.5, -0.9, 1}, Vec3{0, 0, -1}}, Interval(0.001, Utility::INFTY), registro));
+    EXPECT_NEAR(registro.t, 4.0, 1e-12);
+    EXPECT_FALSE(mundo.hit(Ray{Point3{7.5, -0.9, 1}, Vec3{0, 0, -1}}, Interval(0.001, Utility::INFTY), registro));
+
+    // A transformação entra na identificação da cena
+    auto hash = cena.hash();
+    texto.replace(texto.find("translate 5"), 11, "translate 6");
+    ASSERT_TRUE(cena.parse(texto, erro, diretorio.string())) << erro;
+    EXPECT_NE(cena.hash(), hash);
+
+    EXPECT_FALSE(cena.parse("material a lambertian 0.5 0.5 0.5\ninstance tri.obj a scale 0\n", erro, diretorio.string()));
+    EXPECT_NE(erro.find("linha 2"), std::string::npos) << erro;
+    EXPECT_FALSE(cena.parse("material a lambertian 0.5 0.5 0.5\ninstance tri.obj a translate 1 2\n", erro, diretorio.string()));
+    EXPECT_FALSE(cena.parse("material a lambertian 0.5 0.5 0.5\ninstance tri.obj a rotate 0 0 0 30\n", erro, diretorio.string()));
+
+    std::filesystem::remove_all(diretorio);
+}
@@ -0,0 +1,170 @@
+#include "../lib/render.hpp"
+#include "../lib/random.hpp"
+#include "../lib/scene.hpp"
+
+#include <cmath>
+#include <filesystem>
+#include <gtest/gtest.h>
+
+namespace {
+
+    // Chão difuso (uma esfera enorme, quase um plano em y = 0) iluminado por uma lâmpada esférica de raio
+    // 0,25 centrada em (0, 1, 0), dentro de uma sala que absorve toda a luz (albedo 0)
+    HittableList sala_com_lampada(double albedo_do_chao) {
+        HittableList mundo;
+
+        auto chao = mundo.materials.add(Lambertian{Vec3{albedo_do_chao, albedo_do_chao, albedo_do_chao}});
+        auto parede = mundo.materials.add(Lambertian{Vec3{0, 0, 0}});
+        auto lampada = mundo.materials.add(Emissive{Vec3{1, 1, 1}});
+
+        mundo.add_to_obj_list(std::make_shared<Sphere>(Vec3{0, -1000, 0}, 1000.0, chao));
+        mundo.add_to_obj_list(std::make_shared<Sphere>(Vec3{0, 0, 0}, 50.0, parede));
+        mundo.add_to_obj_list(std::make_shared<Sphere>(Vec3{0, 1, 0}, 0.25, lampada));
+
+        mundo.build_acceleration();
+        mundo.lights.add_emissive(mundo.objects, mundo.materials);
+        return mundo;
+    }
+
+    struct Estimativa {
+        double media;
+        double desvio_padrao;
+    };
+
+    // Média e desvio padrão da luz que chega à câmera, em (0, 0.5, 0), vinda da origem do chão
+    Estimativa luz_no_chao(Render &render, const HittableList &mundo, const LightList &luzes, int amostras) {
+        double soma = 0.0, soma_quadrados = 0.0;
+
+        for (int amostra = 0; amostra < amostras; ++amostra) {
+            Random::begin_path(77, 0, std::uint64_t(amostra));
+            auto cor = render.ray_color(Ray{Point3{0, 0.5, 0}, Vec3{0, -1, 0}}, mundo, mundo.materials, luzes, 50);
+            soma += cor.x();
+            soma_quadrados += cor.x() * cor.x();
+        }
+
+        double media = soma / amostras;
+        return Estimativa{media, std::sqrt(std::max(0.0, soma_quadrados / amostras - media * media))};
+    }
+
+} // namespace
+
+TEST(Luzes, AmostraCaiSobreAEsferaComADensidadeDoCone) {
+    MaterialTable materiais;
+    auto lampada = materiais.add(Emissive{Vec3{2, 3, 4}});
+    auto esfera = std::make_shared<Sphere>(Vec3{1, 2, -3}, 0.5, lampada);
+
+    LightList luzes;
+    luzes.add(esfera, materiais.emission(lampada));
+
+    Point3 ponto{0.2, -0.4, 1.0};
+    Pcg32 gerador{6};
+
+    for (int k = 0; k < 10000; ++k) {
+        LightSample amostra;
+        double escolha = gerador.next_double();
+        double u = gerador.next_double();
+        ASSERT_TRUE(luzes.sample(ponto, escolha, Sampling::Point2{u, gerador.next_double()}, amostra));
+        ASSERT_NEAR(amostra.direction.length(), 1.0, 1e-12);
+        EXPECT_EQ(amostra.emission.z(), 4.0);
+
+        // A direção toca a esfera na distância informada, e pdf() reconhece o ponto tocado
+        HitRecord registro;
+        ASSERT_TRUE(esfera->hit(Ray{ponto, amostra.direction}, Interval(0.001, Utility::INFTY), registro));
+        ASSERT_NEAR(registro.t, amostra.distance, 1e-9);
+        ASSERT_NEAR(luzes.pdf(ponto, registro), amostra.pdf, 1e-9 * amostra.pdf);
+    }
+
+    // Direções uniformes na esfera tocam a luz com probabilidade (ângulo sólido / 4π) = 1 / (4π pdf)
+    LightSample amostra;
+    luzes.sample(ponto, 0.5, Sampling::Point2{0.5, 0.5}, amostra);
+
+    constexpr int N = 400000;
+    int acertos = 0;
+    for (int k = 0; k < N; ++k) {
+        HitRecord registro;
+        double u = gerador.next_double();
+        acertos += esfera->hit(Ray{ponto, Sampling::uniform_sphere(Sampling::Point2{u, gerador.next_double()})}, Interval(0.001, Utility::INFTY), registro);
+    }
+    EXPECT_NEAR(double(acertos) / N, 1.0 / (4.0 * Utility::PI * amostra.pdf), 0.001);
+
+    // Dentro da esfera não há cone, e um ponto que não é da luz tem densidade 0
+    EXPECT_FALSE(luzes.sample(Point3{1, 2.1, -3}, 0.5, Sampling::Point2{0.5, 0.5}, amostra));
+
+    HitRecord fora;
+    fora.point = Point3{1, 2.6, -3};
+    fora.material = lampada;
+    EXPECT_EQ(luzes.pdf(ponto, fora), 0.0);
+}
+
+TEST(Luzes, AmostragemDiretaConcordaComOsQuiquesEReduzORuido) {
+    Render render{64};
+    auto mundo = sala_com_lampada(0.5);
+
+    // A lâmpada, de radiância 1, ocupa do ponto (0, 0, 0) um cone com sin²(θmax) = 0,25² / 1²; a luz
+    // que chega ao chão difuso é π sin²(θmax) e a refletida, albedo sin²(θmax)
+    double esperado = 0.5 * 0.0625;
+
+    auto com_luzes = luz_no_chao(render, mundo, mundo.lights, 20000);
+    auto sem_luzes = luz_no_chao(render, mundo, LightList{}, 200000);
+
+    EXPECT_NEAR(com_luzes.media, esperado, 0.01 * esperado);
+    EXPECT_NEAR(sem_luzes.media, esperado, 0.03 * esperado);
+
+    // Sem a amostragem direta, apenas 1 em cada 16 quiques encontra a lâmpada
+    EXPECT_LT(com_luzes.desvio_padrao, 0.1 * sem_luzes.desvio_padrao);
+}
+
+TEST(Luzes, LampadaVistaDiretamenteEQuiquesSobreMetal) {
+    Render render{64};
+    auto mundo = sala_com_lampada(0.5);
+
+    // A câmera vê a própria emissão, com peso 1 (o raio primário não poderia ter amostrado a luz)
+    Random::begin_path(1, 0, 0);
+    auto lampada = render.ray_color(Ray{Point3{0, 0.5, 0}, Vec3{0, 1, 0}}, mundo, 50);
+    EXPECT_EQ(lampada.x(), 1.0);
+    EXPECT_EQ(lampada.z(), 1.0);
+
+    // Com uma cena só com esferas difusas e metálicas, a lista fica vazia
+    EXPECT_EQ(mundo.lights.size(), 1u);
+    EXPECT_TRUE(Render::default_scene().lights.empty());
+}
+
+TEST(Luzes, CenaComMaterialEmissivo) {
+    const char *texto =
+        "material chao lambertian 0.5 0.5 0.5\n"
+        "material lampada emissive 4 3.5 3\n"
+        "sphere 0 -100 0  100 chao\n"
+        "sphere 0 2 0  0.2 lampada\n"
+        "sphere 1 2 0  0.3 lampada\n";
+
+    Scene cena;
+    std::string erro;
+    ASSERT_TRUE(cena.parse(texto, erro)) << erro;
+    EXPECT_EQ(cena.materials()[1].type, MaterialDescription::Type::EMISSIVE);
+    EXPECT_EQ(cena.world().lights.size(), 2u);
+    EXPECT_EQ(cena.world().materials.emission(1).y(), 3.5);
+
+    // A cena compilada guarda o tipo do material, e as esferas emissivas continuam sendo luzes
+    auto arquivo = (std::filesystem::temp_directory_path() / "ray_tracing_cena_luzes.bin").string();
+    ASSERT_TRUE(cena.compile(arquivo.c_str()));
+
+    Scene compilada;
+    ASSERT_TRUE(compilada.load(arquivo.c_str(), erro)) << erro;
+    EXPECT_EQ(compilada.hash(), cena.hash());
+
+    auto mundo = compilada.world();
+    ASSERT_EQ(mundo.lights.size(), 2u);
+
+    HitRecord registro;
+    registro.point = Point3{1, 2.3, 0};
+    registro.material = 1;
+    EXPECT_GT(mundo.lights.pdf(Point3{0, 0, 0}, registro), 0.0);
+
+    std::filesystem::remove(arquivo);
+
+    Scene diferente;
+    ASSERT_TRUE(diferente.parse("material lampada lambertian 4 3.5 3\n", erro));
+    Scene emissiva;
+    ASSERT_TRUE(emissiva.parse("material lampada emissive 4 3.5 3\n", erro));
+    EXPECT_NE(diferente.hash(), emissiva.hash());
+}
@@ -0,0 +1,57 @@
+#include "../lib/material.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/sampler.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+TEST(Material, TabelaDespachaPeloIndice) {
+    MaterialTable materiais;
+    auto difuso = materiais.add(Lambertian{Vec3{0.1, 0.2, 0.3}});
+    auto metal = materiais.add(Metal{Vec3{0.7, 0.8, 0.9}});
+
+    EXPECT_EQ(difuso, 0u);
+    EXPECT_EQ(metal, 1u);
+    EXPECT_EQ(materiais.size(), 2u);
+
+    HitRecord registro;
+    registro.point = Point3{0, 0, 0};
+    registro.normal_sur_vector = Vec3{0, 1, 0};
+
+    Ray incidente{Point3{-1, 1, 0}, Vec3{1, -1, 0}};
+    Vec3 atenuacao;
+    Ray desviado;
+    Sampler amostrador;
+
+    // O metal reflete o raio como um espelho
+    ASSERT_TRUE(materiais.scatter(metal, incidente, registro, amostrador, atenuacao, desviado));
+    EXPECT_EQ(atenuacao.x(), 0.7);
+    EXPECT_EQ(atenuacao.z(), 0.9);
+    EXPECT_DOUBLE_EQ(desviado.direction().x(), 1.0);
+    EXPECT_DOUBLE_EQ(desviado.direction().y(), 1.0);
+
+    // O material difuso desvia para o mesmo hemisfério da normal
+    ASSERT_TRUE(materiais.scatter(difuso, incidente, registro, amostrador, atenuacao, desviado));
+    EXPECT_EQ(atenuacao.y(), 0.2);
+    EXPECT_GE(desviado.direction().y(), 0.0);
+}
+
+TEST(Material, ListaRetornaOMaterialDoObjetoMaisProximo) {
+    HittableList lista;
+    auto longe = lista.materials.add(Lambertian{Vec3{1, 0, 0}});
+    auto perto = lista.materials.add(Metal{Vec3{0, 1, 0}});
+
+    // Sem build_acceleration(): testa o laço linear, que escreve direto no registro
+    lista.add_to_obj_list(std::make_shared<Sphere>(Vec3{0, 0, -5}, 0.5, longe));
+    lista.add_to_obj_list(std::make_shared<Sphere>(Vec3{0, 0, -2}, 0.5, perto));
+    lista.add_to_obj_list(std::make_shared<Sphere>(Vec3{0, 0, -9}, 0.5, longe));
+
+    HitRecord registro;
+    ASSERT_TRUE(lista.hit(Ray{Point3{0, 0, 0}, Vec3{0, 0, -1}}, Interval(0.001, 100), registro));
+    EXPECT_EQ(registro.material, perto);
+    EXPECT_DOUBLE_EQ(registro.t, 1.5);
+
+    // Um raio que não toca nada deixa o registro intacto
+    EXPECT_FALSE(lista.hit(Ray{Point3{0, 0, 0}, Vec3{0, 1, 0}}, Interval(0.001, 100), registro));
+    EXPECT_EQ(registro.material, perto);
+}
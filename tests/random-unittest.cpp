@@ -0,0 +1,53 @@
+#include "../lib/random.hpp"
+#include "../lib/utility.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(GeradorAleatorio, IntervaloSemiAberto) {
+    Pcg32 gerador{42};
+
+    for (int i = 0; i < 100000; ++i) {
+        double valor = gerador.next_double();
+
+        EXPECT_GE(valor, 0.0);
+        EXPECT_LT(valor, 1.0);
+    }
+}
+
+TEST(GeradorAleatorio, MesmoCaminhoMesmaSequencia) {
+    std::vector<double> primeira_sequencia;
+    std::vector<double> segunda_sequencia;
+
+    Random::begin_path(7, 1234, 5);
+    for (int i = 0; i < 16; ++i)
+        primeira_sequencia.push_back(Utility::random_double());
+
+    // Números consumidos por outro caminho não podem interferir na sequência
+    Random::begin_path(7, 99, 0);
+    Utility::random_double();
+
+    Random::begin_path(7, 1234, 5);
+    for (int i = 0; i < 16; ++i)
+        segunda_sequencia.push_back(Utility::random_double());
+
+    EXPECT_EQ(primeira_sequencia, segunda_sequencia);
+}
+
+TEST(GeradorAleatorio, CaminhosDiferentesSequenciasDiferentes) {
+    Random::begin_path(7, 1234, 5);
+    double amostra = Utility::random_double();
+
+    Random::begin_path(7, 1235, 5);
+    EXPECT_NE(amostra, Utility::random_double());
+
+    Random::begin_path(7, 1234, 6);
+    EXPECT_NE(amostra, Utility::random_double());
+
+    Random::begin_path(8, 1234, 5);
+    EXPECT_NE(amostra, Utility::random_double());
+
+    Random::begin_path(7, 1234, 5);
+    Random::begin_bounce(1);
+    EXPECT_NE(amostra, Utility::random_double());
+}
@@ -0,0 +1,286 @@
+#include "../lib/render.hpp"
+#include "../lib/random.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+    // Média de muitas amostras do pixel (i, j) da cena padrão
+    Vec3 mean_pixel_color(Render &render, const HittableList &world, int i, int j, int samples) {
+        Vec3 sum;
+        for (int sample = 0; sample < samples; ++sample) {
+            Random::begin_path(1234, std::uint64_t(j) * 1000 + i, sample);
+            sum += render.ray_color(render.get_ray(i, j), world, 50);
+        }
+        return sum / samples;
+    }
+
+} // namespace
+
+TEST(Integrador, RoletaRussaNaoAlteraMedia) {
+    auto world = Render::default_scene();
+
+    // Pixels que acertam o chão, a esfera difusa e a metálica, onde os caminhos quicam várias vezes
+    for (auto [i, j] : {std::pair{200, 200}, std::pair{100, 140}, std::pair{320, 110}}) {
+        Render sem_roleta{400};
+        sem_roleta.set_roulette_min_depth(50);
+
+        Render com_roleta{400};
+        com_roleta.set_roulette_min_depth(1);
+
+        auto esperado = mean_pixel_color(sem_roleta, world, i, j, 20000);
+        auto obtido = mean_pixel_color(com_roleta, world, i, j, 20000);
+
+        EXPECT_NEAR(obtido.x(), esperado.x(), 0.01);
+        EXPECT_NEAR(obtido.y(), esperado.y(), 0.01);
+        EXPECT_NEAR(obtido.z(), esperado.z(), 0.01);
+    }
+}
+
+TEST(Integrador, CaminhoRespeitaProfundidadeMaxima) {
+    auto world = Render::default_scene();
+    Render render{400};
+
+    // O pixel (200, 200) vê a esfera do centro e o (200, 0), apenas o céu
+    HitRecord registro;
+    ASSERT_TRUE(world.hit(render.get_ray(200, 200), Interval(0.001, Utility::INFTY), registro));
+    ASSERT_FALSE(world.hit(render.get_ray(200, 0), Interval(0.001, Utility::INFTY), registro));
+
+    // Sem nenhum trecho permitido, nenhuma luz chega à câmera. Com apenas o primário, um raio que toca
+    // uma superfície (que não emite luz) não contribui com nada, e um que não toca nada vê o céu.
+    Random::begin_path(0, 0, 0);
+    auto sem_trechos = render.ray_color(render.get_ray(200, 200), world, 0);
+    auto apenas_primario = render.ray_color(render.get_ray(200, 200), world, 1);
+
+    EXPECT_TRUE(sem_trechos.near_zero());
+    EXPECT_TRUE(apenas_primario.near_zero());
+
+    auto raio_do_ceu = render.get_ray(200, 0);
+    auto ceu = render.ray_color(raio_do_ceu, world, 1);
+    auto esperado = render.background_color(raio_do_ceu);
+
+    EXPECT_FALSE(ceu.near_zero());
+    EXPECT_EQ(ceu.x(), esperado.x());
+    EXPECT_EQ(ceu.y(), esperado.y());
+    EXPECT_EQ(ceu.z(), esperado.z());
+}
+
+TEST(AmostragemAdaptativa, MediaEVarianciaIncrementais) {
+    PixelEstimate estimate;
+    double luminancias[] = {0.1, 0.5, 0.2, 0.9, 0.4};
+
+    for (auto valor : luminancias)
+        estimate.add(Vec3{valor, valor, valor});
+
+    // Média 0.42 e variância amostral (n - 1) 0.097, calculadas em duas passadas
+    EXPECT_EQ(estimate.count, 5u);
+    EXPECT_NEAR(estimate.luminance_mean, 0.42, 1e-12);
+    EXPECT_NEAR(estimate.luminance_m2 / 4, 0.097, 1e-12);
+    EXPECT_NEAR(estimate.mean().x(), 0.42, 1e-12);
+}
+
+TEST(AmostragemAdaptativa, RespeitaLimitesDeAmostras) {
+    auto world = Render::default_scene();
+
+    Render render{64};
+    render.set_samples_per_pixel(64);
+    render.set_adaptive_sampling(8, 0.02);
+
+    SampleBuffer samples;
+    render.render(world, samples);
+
+    std::uint32_t menor = 64, maior = 0;
+    for (int j = 0; j < samples.height(); ++j) {
+        for (int i = 0; i < samples.width(); ++i) {
+            menor = std::min(menor, samples.pixel(i, j).count);
+            maior = std::max(maior, samples.pixel(i, j).count);
+        }
+    }
+
+    // O céu converge com o mínimo de amostras e o chão difuso precisa de mais
+    EXPECT_EQ(menor, 8u);
+    EXPECT_GT(maior, 8u);
+    EXPECT_LE(maior, 64u);
+    EXPECT_LT(samples.total_samples(), std::uint64_t(64) * samples.width() * samples.height());
+}
+
+TEST(RenderizacaoProgressiva, ContinuarDoCheckpointDaAMesmaImagem) {
+    auto world = Render::default_scene();
+    auto checkpoint = (std::filesystem::temp_directory_path() / "ray_tracing_checkpoint_teste.bin").string();
+
+    Render direto{48};
+    direto.set_samples_per_pixel(12);
+
+    SampleBuffer esperado;
+    while (!direto.render(world, esperado)) {}
+
+    // Primeira execução: uma passada de 5 amostras, salva no checkpoint
+    Render primeira{48};
+    primeira.set_samples_per_pixel(12);
+    primeira.set_progressive(5, checkpoint.c_str(), false);
+
+    SampleBuffer parcial;
+    EXPECT_FALSE(primeira.render(world, parcial));
+    ASSERT_TRUE(parcial.save(checkpoint.c_str(), primeira.checkpoint_key(1)));
+
+    // Segunda execução: carrega o checkpoint e termina as amostras que faltam
+    Render segunda{48};
+    segunda.set_samples_per_pixel(12);
+    segunda.set_progressive(5, checkpoint.c_str(), true);
+
+    SampleBuffer continuado;
+    ASSERT_TRUE(continuado.load(checkpoint.c_str(), segunda.checkpoint_key(1)));
+    EXPECT_EQ(continuado.total_samples(), parcial.total_samples());
+
+    while (!segunda.render(world, continuado)) {}
+
+    ASSERT_EQ(continuado.total_samples(), esperado.total_samples());
+    for (int j = 0; j < esperado.height(); ++j) {
+        for (int i = 0; i < esperado.width(); ++i) {
+            EXPECT_EQ(continuado.pixel(i, j).sum.x(), esperado.pixel(i, j).sum.x());
+            EXPECT_EQ(continuado.pixel(i, j).sum.z(), esperado.pixel(i, j).sum.z());
+        }
+    }
+
+    // Outra cena (ou outra semente) não pode reaproveitar o checkpoint
+    Render outra_semente{48};
+    outra_semente.set_seed(7);
+
+    SampleBuffer rejeitado;
+    EXPECT_FALSE(rejeitado.load(checkpoint.c_str(), segunda.checkpoint_key(2)));
+    EXPECT_FALSE(rejeitado.load(checkpoint.c_str(), outra_semente.checkpoint_key(1)));
+
+    std::filesystem::remove(checkpoint);
+}
+
+TEST(RenderizacaoProgressiva, ContinuarDoCheckpointComBlueNoise) {
+    auto world = Render::default_scene();
+    auto checkpoint = (std::filesystem::temp_directory_path() / "ray_tracing_checkpoint_blue_noise.bin").string();
+
+    auto configurar = [](Render &render, int amostras) {
+        render.set_samples_per_pixel(amostras);
+        render.set_sampler(SamplerType::BLUE_NOISE);
+        render.set_quiet(true);
+    };
+
+    Render direto{48};
+    configurar(direto, 16);
+
+    SampleBuffer esperado;
+    while (!direto.render(world, esperado)) {}
+
+    // Primeira execução com 12 amostras; a segunda aumenta para 16, que arredonda para a mesma potência de 2
+    Render primeira{48};
+    configurar(primeira, 12);
+
+    SampleBuffer parcial;
+    while (!primeira.render(world, parcial)) {}
+    ASSERT_TRUE(parcial.save(checkpoint.c_str(), primeira.checkpoint_key(1)));
+
+    Render segunda{48};
+    configurar(segunda, 16);
+
+    SampleBuffer continuado;
+    ASSERT_TRUE(continuado.load(checkpoint.c_str(), segunda.checkpoint_key(1)));
+    while (!segunda.render(world, continuado)) {}
+
+    ASSERT_EQ(continuado.total_samples(), esperado.total_samples());
+    for (int j = 0; j < esperado.height(); ++j) {
+        for (int i = 0; i < esperado.width(); ++i) {
+            EXPECT_EQ(continuado.pixel(i, j).sum.x(), esperado.pixel(i, j).sum.x());
+            EXPECT_EQ(continuado.pixel(i, j).sum.z(), esperado.pixel(i, j).sum.z());
+        }
+    }
+
+    // Com 17 amostras a disposição do índice muda, e o checkpoint não pode ser continuado
+    Render mais_amostras{48};
+    configurar(mais_amostras, 17);
+
+    SampleBuffer rejeitado;
+    EXPECT_FALSE(rejeitado.load(checkpoint.c_str(), mais_amostras.checkpoint_key(1)));
+
+    std::filesystem::remove(checkpoint);
+}
+
+TEST(RenderizacaoProgressiva, CheckpointCorrompidoERejeitado) {
+    auto checkpoint = (std::filesystem::temp_directory_path() / "ray_tracing_checkpoint_corrompido.bin").string();
+
+    SampleBuffer original;
+    original.resize(8, 4);
+    original.pixel(3, 2).add(Vec3{0.5, 0.25, 1.0});
+    ASSERT_TRUE(original.save(checkpoint.c_str(), 1));
+
+    SampleBuffer carregado;
+    ASSERT_TRUE(carregado.load(checkpoint.c_str(), 1));
+    EXPECT_EQ(carregado.pixel(3, 2).count, 1u);
+
+    // Largura e altura ficam logo depois de magic, byte_order e record_size. Um cabeçalho que declara
+    // uma imagem enorme é rejeitado sem tentar alocar os pixels.
+    std::int32_t enorme[2] = {1 << 30, 1 << 30};
+    {
+        std::fstream arquivo(checkpoint, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        arquivo.seekp(16);
+        arquivo.write(reinterpret_cast<const char *>(enorme), sizeof(enorme));
+    }
+    EXPECT_FALSE(carregado.load(checkpoint.c_str(), 1));
+
+    // Arquivo truncado
+    ASSERT_TRUE(original.save(checkpoint.c_str(), 1));
+    std::filesystem::resize_file(checkpoint, std::filesystem::file_size(checkpoint) - 1);
+    EXPECT_FALSE(carregado.load(checkpoint.c_str(), 1));
+
+    std::filesystem::remove(checkpoint);
+}
+
+TEST(RenderizacaoProgressiva, HashDaCenaPadraoVemDoConteudo) {
+    auto hash = Render::default_scene_hash();
+    EXPECT_EQ(hash, Render::world_hash(Render::default_scene()));
+
+    // Qualquer mudança em um material ou em uma esfera muda o hash
+    auto outro_material = Render::default_scene();
+    outro_material.materials = MaterialTable{};
+    outro_material.materials.add(Lambertian{Vec3{0.8, 0.8, 0.0}});
+    outro_material.materials.add(Lambertian{Vec3{0.1, 0.2, 0.5}});
+    outro_material.materials.add(Metal{Vec3{0.8, 0.8, 0.8}});
+    outro_material.materials.add(Lambertian{Vec3{0.8, 0.6, 0.2}});
+    EXPECT_NE(Render::world_hash(outro_material), hash);
+
+    auto outro_raio = Render::default_scene();
+    outro_raio.objects[1] = std::make_shared<Sphere>(Vec3(0.0, 0.0, -1.2), 0.6, 1);
+    EXPECT_NE(Render::world_hash(outro_raio), hash);
+
+    auto outro_indice = Render::default_scene();
+    outro_indice.objects[1] = std::make_shared<Sphere>(Vec3(0.0, 0.0, -1.2), 0.5, 2);
+    EXPECT_NE(Render::world_hash(outro_indice), hash);
+}
+
+TEST(Integrador, EstatisticasContamOsRaiosDeTodasAsThreads) {
+    auto world = Render::default_scene();
+
+    for (int packet_size : {0, 8}) {
+        Render render{64};
+        render.set_samples_per_pixel(6);
+        render.set_thread_count(3);
+        render.set_tile_size(8);
+        render.set_packet_size(packet_size);
+        render.set_progress_interval(std::chrono::milliseconds{0});
+
+        SampleBuffer samples;
+        while (!render.render(world, samples)) {}
+
+        auto totals = render.stats().totals();
+        std::uint64_t por_thread = 0;
+        for (int k = 0; k < render.stats().thread_count(); ++k)
+            por_thread += render.stats().thread_totals(k).primary_rays;
+
+        EXPECT_EQ(totals.primary_rays, std::uint64_t(render.image_width()) * render.image_height() * 6);
+        EXPECT_EQ(por_thread, totals.primary_rays);
+        EXPECT_EQ(totals.tiles, 8u * 5u);
+        EXPECT_GT(totals.secondary_rays, 0u);
+        EXPECT_GE(totals.bounces, totals.secondary_rays);
+        EXPECT_GT(totals.primitive_tests, totals.primary_rays);
+    }
+}
@@ -0,0 +1,187 @@
+#include "../lib/render.hpp"
+#include "../lib/sampler.hpp"
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+    // Se os pontos formam uma rede (0, k, 2): cada retângulo 2^-a x 2^-(k-a), para todo a, tem exatamente
+    // um ponto (são 2^k pontos)
+    bool forma_rede(const std::vector<Sampling::Point2> &pontos) {
+        int k = 0;
+        while ((std::size_t(1) << k) < pontos.size())
+            ++k;
+
+        for (int a = 0; a <= k; ++a) {
+            std::vector<int> contagem(pontos.size(), 0);
+            for (const auto &ponto : pontos) {
+                auto coluna = std::size_t(ponto.u * double(1 << a));
+                auto linha = std::size_t(ponto.v * double(1 << (k - a)));
+                if (++contagem[(linha << a) | coluna] > 1)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Pontos da dimensão 2D número "dimensao" do trecho "trecho" das amostras [0, quantidade) do pixel
+    std::vector<Sampling::Point2> pontos_do_pixel(Sampler amostrador, int i, int j, int trecho, int dimensao, int quantidade) {
+        std::vector<Sampling::Point2> pontos;
+        for (int amostra = 0; amostra < quantidade; ++amostra) {
+            amostrador.start_pixel_sample(i, j, std::uint32_t(amostra));
+            amostrador.start_bounce(trecho);
+            for (int d = 0; d < dimensao; ++d)
+                amostrador.get_2d();
+            pontos.push_back(amostrador.get_2d());
+        }
+        return pontos;
+    }
+
+} // namespace
+
+TEST(Amostrador, IndependenteUsaOGeradorDoCaminho) {
+    Sampler amostrador{SamplerType::INDEPENDENT, 7, 100, 50, 16};
+    amostrador.start_pixel_sample(34, 12, 5);
+    auto primeiro = amostrador.get_2d();
+    amostrador.start_bounce(2);
+    auto quique = amostrador.get_1d();
+
+    Random::begin_path(7, 12 * 100 + 34, 5);
+    EXPECT_EQ(primeiro.u, Random::next_double());
+    EXPECT_EQ(primeiro.v, Random::next_double());
+    Random::begin_bounce(2);
+    EXPECT_EQ(quique, Random::next_double());
+}
+
+TEST(Amostrador, SobolFormaRedesEmCadaPixelEDimensao) {
+    Sampler amostrador{SamplerType::SOBOL, 3, 64, 36, 64};
+
+    for (int pixel = 0; pixel < 4; ++pixel) {
+        for (int trecho = 0; trecho < 3; ++trecho) {
+            for (int dimensao = 0; dimensao < 3; ++dimensao) {
+                auto pontos = pontos_do_pixel(amostrador, 5 + 7 * pixel, 3 * pixel, trecho, dimensao, 64);
+                EXPECT_TRUE(forma_rede(pontos)) << pixel << " " << trecho << " " << dimensao;
+
+                // Cada prefixo de potência de 2 também é uma rede: as amostras podem ser acrescentadas aos poucos
+                EXPECT_TRUE(forma_rede(std::vector<Sampling::Point2>(pontos.begin(), pontos.begin() + 16)));
+            }
+        }
+    }
+
+    // Uma dimensão: as 32 primeiras amostras caem cada uma em um intervalo de 1/32
+    std::vector<int> intervalos(32, 0);
+    for (std::uint32_t amostra = 0; amostra < 32; ++amostra) {
+        amostrador.start_pixel_sample(10, 10, amostra);
+        amostrador.start_bounce(1);
+        ++intervalos[std::size_t(amostrador.get_1d() * 32)];
+    }
+    for (int contagem : intervalos)
+        EXPECT_EQ(contagem, 1);
+
+    // Pixels e dimensões diferentes não recebem os mesmos pontos
+    auto a = pontos_do_pixel(amostrador, 1, 1, 1, 0, 4);
+    auto b = pontos_do_pixel(amostrador, 2, 1, 1, 0, 4);
+    auto c = pontos_do_pixel(amostrador, 1, 1, 1, 1, 4);
+    EXPECT_NE(a[0].u, b[0].u);
+    EXPECT_NE(a[0].u, c[0].u);
+}
+
+TEST(Amostrador, RuidoAzulFormaRedesNosBlocosDePixels) {
+    // 4 amostras por pixel: cada pixel tem uma rede de 4 pontos e cada bloco alinhado de 2x2 pixels,
+    // uma rede de 16 pontos
+    Sampler amostrador{SamplerType::BLUE_NOISE, 11, 16, 16, 4};
+
+    for (int bloco_j = 0; bloco_j < 16; bloco_j += 2) {
+        for (int bloco_i = 0; bloco_i < 16; bloco_i += 2) {
+            for (int trecho : {0, 1, 4}) {
+                std::vector<Sampling::Point2> bloco;
+
+                for (int j = bloco_j; j < bloco_j + 2; ++j) {
+                    for (int i = bloco_i; i < bloco_i + 2; ++i) {
+                        auto pontos = pontos_do_pixel(amostrador, i, j, trecho, 0, 4);
+                        EXPECT_TRUE(forma_rede(pontos));
+                        bloco.insert(bloco.end(), pontos.begin(), pontos.end());
+                    }
+                }
+
+                EXPECT_TRUE(forma_rede(bloco)) << bloco_i << " " << bloco_j << " " << trecho;
+            }
+        }
+    }
+
+    // Com um número ímpar de bits de amostra (8 amostras), o mesmo para os blocos de 2x2 (32 pontos)
+    Sampler impar{SamplerType::BLUE_NOISE, 11, 16, 16, 8};
+    std::vector<Sampling::Point2> bloco;
+    for (int j = 4; j < 6; ++j) {
+        for (int i = 6; i < 8; ++i) {
+            auto pontos = pontos_do_pixel(impar, i, j, 1, 1, 8);
+            EXPECT_TRUE(forma_rede(pontos));
+            bloco.insert(bloco.end(), pontos.begin(), pontos.end());
+        }
+    }
+    EXPECT_TRUE(forma_rede(bloco));
+}
+
+TEST(Amostrador, SobolIntegraFuncaoSuaveComErroMenor) {
+    // Integral de sin(π u) * v² em [0, 1)², que vale (2/π) * (1/3), com 64 amostras em cada um de 200 pixels
+    auto integral = 2.0 / (3.0 * Utility::PI);
+
+    auto erro_medio = [&](SamplerType tipo) {
+        Sampler amostrador{tipo, 5, 20, 10, 64};
+        double soma_dos_erros = 0.0;
+
+        for (int pixel = 0; pixel < 200; ++pixel) {
+            double soma = 0.0;
+            for (std::uint32_t amostra = 0; amostra < 64; ++amostra) {
+                amostrador.start_pixel_sample(pixel % 20, pixel / 20, amostra);
+                auto ponto = amostrador.get_2d();
+                soma += std::sin(Utility::PI * ponto.u) * ponto.v * ponto.v;
+            }
+            soma_dos_erros += std::fabs(soma / 64 - integral);
+        }
+
+        return soma_dos_erros / 200;
+    };
+
+    auto independente = erro_medio(SamplerType::INDEPENDENT);
+    EXPECT_LT(erro_medio(SamplerType::SOBOL), 0.2 * independente);
+    EXPECT_LT(erro_medio(SamplerType::BLUE_NOISE), 0.2 * independente);
+}
+
+TEST(Amostrador, ImagemNaoDependeDasThreadsNemDosPacotes) {
+    auto mundo = Render::default_scene();
+
+    for (auto tipo : {SamplerType::SOBOL, SamplerType::BLUE_NOISE}) {
+        auto renderizar = [&](int threads, int pacote) {
+            Render render{64};
+            render.set_samples_per_pixel(4);
+            render.set_sampler(tipo);
+            render.set_thread_count(threads);
+            render.set_packet_size(pacote);
+            render.set_quiet(true);
+
+            Framebuffer imagem;
+            render.render(mundo, imagem);
+            return imagem;
+        };
+
+        auto referencia = renderizar(1, 0);
+        auto com_threads = renderizar(3, 0);
+        auto com_pacotes = renderizar(2, 8);
+
+        for (int j = 0; j < referencia.height(); ++j) {
+            for (int i = 0; i < referencia.width(); ++i) {
+                ASSERT_EQ(referencia.pixel(i, j).x(), com_threads.pixel(i, j).x());
+                ASSERT_EQ(referencia.pixel(i, j).z(), com_pacotes.pixel(i, j).z());
+            }
+        }
+    }
+
+    // O amostrador entra na chave do checkpoint
+    Render independente{64}, sobol{64};
+    sobol.set_sampler(SamplerType::SOBOL);
+    EXPECT_NE(independente.checkpoint_key(1), sobol.checkpoint_key(1));
+}
@@ -0,0 +1,137 @@
+#include "../lib/material.hpp"
+#include "../lib/objects.hpp"
+#include "../lib/sampler.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+    Sampling::Point2 ponto_aleatorio(Pcg32 &gerador) {
+        double u = gerador.next_double();
+        return Sampling::Point2{u, gerador.next_double()};
+    }
+
+} // namespace
+
+TEST(Amostragem, EsferaUniformeTemMediaZeroESegundoMomentoUmTerco) {
+    Pcg32 gerador{1};
+    constexpr int N = 200000;
+
+    Vec3 soma, soma_quadrados;
+    for (int k = 0; k < N; ++k) {
+        auto direcao = Sampling::uniform_sphere(ponto_aleatorio(gerador));
+        ASSERT_NEAR(direcao.length(), 1.0, 1e-12);
+
+        soma += direcao;
+        soma_quadrados += Utility::product_component(direcao, direcao);
+    }
+
+    // Para a distribuição uniforme, E[x] = 0 e E[x²] = 1/3 em cada eixo
+    for (int eixo = 0; eixo < 3; ++eixo) {
+        EXPECT_NEAR(soma[eixo] / N, 0.0, 0.01);
+        EXPECT_NEAR(soma_quadrados[eixo] / N, 1.0 / 3.0, 0.01);
+    }
+}
+
+TEST(Amostragem, DiscoConcentricoCobreODiscoComAreaUniforme) {
+    // Os cantos e o centro do quadrado
+    auto centro = Sampling::concentric_disk(Sampling::Point2{0.5, 0.5});
+    EXPECT_EQ(centro.u, 0.0);
+    EXPECT_EQ(centro.v, 0.0);
+
+    auto borda = Sampling::concentric_disk(Sampling::Point2{1.0, 0.5});
+    EXPECT_NEAR(borda.u, 1.0, 1e-15);
+    EXPECT_NEAR(borda.v, 0.0, 1e-15);
+
+    Pcg32 gerador{2};
+    constexpr int N = 200000;
+    int dentro_do_meio_raio = 0, primeiro_quadrante = 0;
+
+    for (int k = 0; k < N; ++k) {
+        auto ponto = Sampling::concentric_disk(ponto_aleatorio(gerador));
+        double raio_quadrado = ponto.u * ponto.u + ponto.v * ponto.v;
+        ASSERT_LE(raio_quadrado, 1.0 + 1e-12);
+
+        dentro_do_meio_raio += raio_quadrado < 0.25;
+        primeiro_quadrante += ponto.u > 0 && ponto.v > 0;
+    }
+
+    // Com área uniforme, o disco de raio 1/2 recebe 1/4 dos pontos, e cada quadrante também
+    EXPECT_NEAR(double(dentro_do_meio_raio) / N, 0.25, 0.005);
+    EXPECT_NEAR(double(primeiro_quadrante) / N, 0.25, 0.005);
+}
+
+TEST(Amostragem, HemisferioCossenoTemDensidadeCossenoSobrePi) {
+    Pcg32 gerador{3};
+    constexpr int N = 200000;
+
+    double soma_cosseno = 0.0, soma_inverso_da_densidade = 0.0;
+    for (int k = 0; k < N; ++k) {
+        auto direcao = Sampling::cosine_hemisphere(ponto_aleatorio(gerador));
+        ASSERT_NEAR(direcao.length(), 1.0, 1e-12);
+        ASSERT_GE(direcao.z(), 0.0);
+
+        soma_cosseno += direcao.z();
+        soma_inverso_da_densidade += 1.0 / std::max(Sampling::cosine_hemisphere_pdf(direcao.z()), 1e-3);
+    }
+
+    // E[cos θ] = ∫ cos² θ / π dω = 2/3
+    EXPECT_NEAR(soma_cosseno / N, 2.0 / 3.0, 0.005);
+
+    // Um estimador de Monte Carlo da área do hemisfério (2π) com a mesma densidade, cortado perto da
+    // borda onde a densidade vai a zero (a parte cortada é desprezível para esta tolerância)
+    EXPECT_NEAR(soma_inverso_da_densidade / N, 2.0 * Utility::PI, 0.1);
+}
+
+TEST(Amostragem, BaseDaNormalEOrtonormal) {
+    Pcg32 gerador{4};
+
+    std::vector<Vec3> normais = {Vec3{0, 0, 1}, Vec3{0, 0, -1}, Vec3{1, 0, 0}, Vec3{0, -1e-9, -1}.unit()};
+    for (int k = 0; k < 100; ++k)
+        normais.push_back(Sampling::uniform_sphere(ponto_aleatorio(gerador)));
+
+    for (const auto &normal : normais) {
+        Sampling::Frame base{normal};
+        auto x = base.to_world(Vec3{1, 0, 0});
+        auto y = base.to_world(Vec3{0, 1, 0});
+        auto z = base.to_world(Vec3{0, 0, 1});
+
+        EXPECT_NEAR(x.length(), 1.0, 1e-12);
+        EXPECT_NEAR(y.length(), 1.0, 1e-12);
+        EXPECT_NEAR(x * y, 0.0, 1e-12);
+        EXPECT_NEAR(x * normal, 0.0, 1e-12);
+        EXPECT_NEAR(y * normal, 0.0, 1e-12);
+        EXPECT_EQ(z.x(), normal.x());
+        EXPECT_EQ(z.z(), normal.z());
+    }
+}
+
+TEST(Amostragem, DifusoDesviaComDensidadeCossenoEmTornoDaNormal) {
+    MaterialTable materiais;
+    auto difuso = materiais.add(Lambertian{Vec3{0.2, 0.4, 0.6}});
+
+    HitRecord registro;
+    registro.point = Point3{1, 2, 3};
+    registro.normal_sur_vector = Vec3{1, -2, 2}.unit();
+
+    Random::begin_path(9, 0, 0);
+    Sampler amostrador;
+    constexpr int N = 100000;
+    double soma_cosseno = 0.0;
+
+    for (int k = 0; k < N; ++k) {
+        Vec3 atenuacao;
+        Ray desviado;
+        ASSERT_TRUE(materiais.scatter(difuso, Ray{Point3{0, 0, 0}, Vec3{0, 0, -1}}, registro, amostrador, atenuacao, desviado));
+
+        // O peso da amostra é o próprio albedo, sem depender da direção sorteada
+        EXPECT_EQ(atenuacao.y(), 0.4);
+        ASSERT_NEAR(desviado.direction().length(), 1.0, 1e-12);
+
+        double cosseno = desviado.direction() * registro.normal_sur_vector;
+        ASSERT_GE(cosseno, -1e-12);
+        soma_cosseno += cosseno;
+    }
+
+    EXPECT_NEAR(soma_cosseno / N, 2.0 / 3.0, 0.005);
+}
@@ -0,0 +1,132 @@
+#include "../lib/scene.hpp"
+#include "../lib/random.hpp"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+
+namespace {
+    const char *CENA_PEQUENA =
+        "# comentário\n"
+        "image 320\n"
+        "samples 12\n"
+        "depth 7\n"
+        "camera 0 1 2  0 0 -1  0 1 0  40\n"
+        "material chao lambertian 0.8 0.8 0.0\n"
+        "material espelho metal 0.9 0.9 0.9   # comentário no fim da linha\n"
+        "sphere 0 -100.5 -1 100 chao\n"
+        "sphere 0.5 0 -1 0.5 espelho\n";
+
+    std::string cena_com_muitas_esferas(std::size_t quantidade) {
+        Pcg32 gerador{5};
+        std::string texto = "material a lambertian 0.5 0.5 0.5\nmaterial b metal 0.1 0.2 0.3\n";
+
+        for (std::size_t k = 0; k < quantidade; ++k) {
+            texto += "sphere " + std::to_string(20 * gerador.next_double() - 10) + " " + std::to_string(20 * gerador.next_double() - 10)
+                   + " " + std::to_string(20 * gerador.next_double() - 10) + " " + std::to_string(0.1 + 0.5 * gerador.next_double())
+                   + (k % 3 ? " a\n" : " b\n");
+        }
+
+        return texto;
+    }
+}
+
+TEST(Cena, LeituraDoFormatoTexto) {
+    Scene cena;
+    std::string erro;
+
+    ASSERT_TRUE(cena.parse(CENA_PEQUENA, erro)) << erro;
+    EXPECT_EQ(cena.sphere_count(), 2u);
+    ASSERT_EQ(cena.materials().size(), 2u);
+    EXPECT_EQ(cena.materials()[1].type, MaterialDescription::Type::METAL);
+
+    Render render{854};
+    cena.configure(render);
+
+    EXPECT_EQ(render.image_width(), 320);
+    EXPECT_EQ(render.image_height(), 180);
+}
+
+TEST(Cena, HashIgnoraAmostrasETamanhoDaImagem) {
+    Scene original;
+    Scene mais_amostras;
+    Scene outra_esfera;
+    std::string erro;
+
+    // Com --resume, as amostras são aumentadas entre execuções sem invalidar o checkpoint
+    std::string texto = CENA_PEQUENA;
+    ASSERT_TRUE(original.parse(texto, erro)) << erro;
+    ASSERT_TRUE(mais_amostras.parse(texto + "image 640\nsamples 200\n", erro)) << erro;
+    ASSERT_TRUE(outra_esfera.parse(texto + "sphere 1 0 -1 0.5 chao\n", erro)) << erro;
+
+    EXPECT_EQ(mais_amostras.hash(), original.hash());
+    EXPECT_NE(outra_esfera.hash(), original.hash());
+}
+
+TEST(Cena, ErrosIndicamALinha) {
+    Scene cena;
+    std::string erro;
+
+    EXPECT_FALSE(cena.parse("material a lambertian 1 1 1\nsphere 0 0 0 1 b\n", erro));
+    EXPECT_EQ(erro.rfind("linha 2:", 0), 0u) << erro;
+
+    EXPECT_FALSE(cena.parse("\n\nsphere 0 0 x 1 a\n", erro));
+    EXPECT_EQ(erro.rfind("linha 3:", 0), 0u) << erro;
+
+    EXPECT_FALSE(cena.parse("triangle 0 0 0\n", erro));
+    EXPECT_FALSE(cena.parse("material a plastic 1 1 1\n", erro));
+    EXPECT_FALSE(cena.parse("camera 0 0 0  0 0 0  0 1 0  90\n", erro));
+    EXPECT_FALSE(cena.parse("image -3\n", erro));
+}
+
+TEST(Cena, CenaCompiladaEquivaleAoTexto) {
+    auto arquivo = (std::filesystem::temp_directory_path() / "ray_tracing_cena_teste.bin").string();
+
+    Scene texto;
+    std::string erro;
+    ASSERT_TRUE(texto.parse(cena_com_muitas_esferas(500), erro)) << erro;
+    ASSERT_TRUE(texto.compile(arquivo.c_str()));
+
+    Scene compilada;
+    ASSERT_TRUE(compilada.load(arquivo.c_str(), erro)) << erro;
+
+    EXPECT_EQ(compilada.sphere_count(), texto.sphere_count());
+    EXPECT_EQ(compilada.hash(), texto.hash());
+
+    auto mundo_texto = texto.world();
+    auto mundo_compilado = compilada.world();
+
+    Pcg32 gerador{3};
+    for (int k = 0; k < 2000; ++k) {
+        Ray raio{Vec3{0, 0, 20}, Vec3{gerador.next_double() - 0.5, gerador.next_double() - 0.5, -1}};
+
+        HitRecord registro_texto;
+        HitRecord registro_compilado;
+
+        bool acertou_texto = mundo_texto.hit(raio, Interval(0.001, Utility::INFTY), registro_texto);
+        bool acertou_compilado = mundo_compilado.hit(raio, Interval(0.001, Utility::INFTY), registro_compilado);
+
+        ASSERT_EQ(acertou_texto, acertou_compilado);
+        if (acertou_texto)
+            EXPECT_EQ(registro_texto.t, registro_compilado.t);
+    }
+
+    std::filesystem::remove(arquivo);
+}
+
+TEST(Cena, CenaCompiladaCorrompidaERejeitada) {
+    auto arquivo = (std::filesystem::temp_directory_path() / "ray_tracing_cena_corrompida.bin").string();
+
+    Scene texto;
+    std::string erro;
+    ASSERT_TRUE(texto.parse(cena_com_muitas_esferas(100), erro));
+    ASSERT_TRUE(texto.compile(arquivo.c_str()));
+
+    // Trunca o arquivo pela metade
+    std::filesystem::resize_file(arquivo, std::filesystem::file_size(arquivo) / 2);
+
+    Scene compilada;
+    EXPECT_FALSE(compilada.load(arquivo.c_str(), erro));
+
+    std::filesystem::remove(arquivo);
+}
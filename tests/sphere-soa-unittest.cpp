@@ -0,0 +1,63 @@
+#include "../lib/objects.hpp"
+#include "../lib/sphere_soa.hpp"
+#include "../lib/random.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+// Todos os kernels devem encontrar exatamente a mesma esfera e o mesmo t que o laço de Sphere::hit
+TEST(SphereSoA, KernelsConcordamComSphere) {
+    Pcg32 gerador{11};
+
+    HittableList lista;
+    SphereSoA esferas;
+
+    // 37 esferas: força o kernel a lidar com um trecho final incompleto
+    for (int k = 0; k < 37; ++k) {
+        Vec3 centro{6 * gerador.next_double() - 3, 6 * gerador.next_double() - 3, 6 * gerador.next_double() - 3};
+        double raio = 0.1 + gerador.next_double();
+
+        lista.add_to_obj_list(std::make_shared<Sphere>(centro, raio, 0));
+        esferas.add(centro, raio, 0);
+    }
+
+    for (auto kernel : {SphereSoA::Kernel::SCALAR, SphereSoA::Kernel::SSE2, SphereSoA::Kernel::AVX2}) {
+        if (!SphereSoA::kernel_supported(kernel))
+            continue;
+
+        esferas.set_kernel(kernel);
+
+        for (int k = 0; k < 2000; ++k) {
+            Vec3 origem{10 * gerador.next_double() - 5, 10 * gerador.next_double() - 5, 10 * gerador.next_double() - 5};
+            Ray raio{origem, Vec3{gerador.next_double() - 0.5, gerador.next_double() - 0.5, gerador.next_double() - 0.5}};
+
+            HitRecord registro_lista;
+            HitRecord registro_soa;
+
+            bool acertou_lista = lista.hit(raio, Interval(0.001, Utility::INFTY), registro_lista);
+            bool acertou_soa = esferas.hit(raio, Interval(0.001, Utility::INFTY), registro_soa);
+
+            ASSERT_EQ(acertou_lista, acertou_soa);
+
+            if (acertou_lista) {
+                EXPECT_EQ(registro_lista.t, registro_soa.t);
+                EXPECT_EQ(registro_lista.normal_sur_vector.x(), registro_soa.normal_sur_vector.x());
+            }
+        }
+    }
+}
+
+TEST(SphereSoA, TrechoIgnoraEsferasForaDele) {
+    SphereSoA esferas;
+    esferas.add(Vec3{0, 0, -1}, 0.5, 0);
+    esferas.add(Vec3{0, 0, -3}, 0.5, 0);
+    esferas.add(Vec3{0, 0, -5}, 0.5, 0);
+
+    Ray raio{Vec3{}, Vec3{0, 0, -1}};
+    HitRecord registro;
+
+    ASSERT_TRUE(esferas.hit_range(raio, 1, 2, Interval(0.001, Utility::INFTY), registro));
+    EXPECT_DOUBLE_EQ(registro.t, 2.5);
+
+    EXPECT_FALSE(esferas.hit_range(raio, 2, 1, Interval(0.001, 4.0), registro));
+}
@@ -0,0 +1,238 @@
+#include "../lib/triangle_mesh.hpp"
+#include "../lib/random.hpp"
+#include "../lib/scene.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace {
+
+    constexpr int LADO = 24;
+
+    // Grade de LADO x LADO quadrados (2 triângulos cada) em torno do plano z = -3, com os vértices
+    // deslocados aleatoriamente para que as arestas não fiquem alinhadas aos eixos
+    void grade(std::vector<double> &vertices, std::vector<std::uint32_t> &indices) {
+        Pcg32 gerador{21};
+
+        for (int j = 0; j <= LADO; ++j) {
+            for (int i = 0; i <= LADO; ++i) {
+                vertices.push_back(4.0 * i / LADO - 2.0 + 0.3 * (gerador.next_double() - 0.5) / LADO);
+                vertices.push_back(4.0 * j / LADO - 2.0 + 0.3 * (gerador.next_double() - 0.5) / LADO);
+                vertices.push_back(-3.0 + 0.2 * gerador.next_double());
+            }
+        }
+
+        for (int j = 0; j < LADO; ++j) {
+            for (int i = 0; i < LADO; ++i) {
+                std::uint32_t a = j * (LADO + 1) + i;
+                indices.insert(indices.end(), {a, a + 1, a + LADO + 2, a, a + LADO + 2, a + LADO + 1});
+            }
+        }
+    }
+
+    Point3 vertice(const std::vector<double> &vertices, std::size_t k) {
+        return Point3{vertices[3 * k], vertices[3 * k + 1], vertices[3 * k + 2]};
+    }
+
+    // Möller-Trumbore, testando todos os triângulos: referência para a travessia da BVH
+    bool forca_bruta(const std::vector<double> &vertices, const std::vector<std::uint32_t> &indices, const Ray &raio, double &t_mais_proximo) {
+        bool tocou = false;
+        t_mais_proximo = Utility::INFTY;
+
+        for (std::size_t k = 0; k < indices.size(); k += 3) {
+            auto a = vertice(vertices, indices[k]);
+            auto aresta1 = vertice(vertices, indices[k + 1]) - a;
+            auto aresta2 = vertice(vertices, indices[k + 2]) - a;
+
+            auto p = raio.direction() % aresta2;
+            auto det = aresta1 * p;
+            if (det == 0.0)
+                continue;
+
+            auto s = raio.origin() - a;
+            auto u = (s * p) / det;
+            auto q = s % aresta1;
+            auto v = (raio.direction() * q) / det;
+            auto t = (aresta2 * q) / det;
+
+            if (u >= 0 && v >= 0 && u + v <= 1 && t > 0.001 && t < t_mais_proximo) {
+                t_mais_proximo = t;
+                tocou = true;
+            }
+        }
+
+        return tocou;
+    }
+
+    std::string arquivo_temporario(const char *nome) {
+        return (std::filesystem::temp_directory_path() / nome).string();
+    }
+
+    void escrever(const std::string &arquivo, const char *conteudo) {
+        std::ofstream saida(arquivo);
+        saida << conteudo;
+    }
+
+} // namespace
+
+TEST(MalhaDeTriangulos, RaiosPelasArestasEVerticesNaoPassamPorFrestas) {
+    std::vector<double> vertices;
+    std::vector<std::uint32_t> indices;
+    grade(vertices, indices);
+
+    TriangleMesh malha{vertices, indices, 0};
+
+    // Raios da origem exatamente para os vértices internos e para pontos sobre as arestas compartilhadas
+    int falhas = 0;
+    for (int j = 1; j < LADO; ++j) {
+        for (int i = 1; i < LADO; ++i) {
+            std::size_t k = j * (LADO + 1) + i;
+            auto v = vertice(vertices, k);
+            auto vizinho = vertice(vertices, k + 1);
+            auto diagonal = vertice(vertices, k + LADO + 2);
+
+            for (const auto &alvo : {v, 0.5 * (v + vizinho), 0.25 * v + 0.75 * diagonal}) {
+                HitRecord registro;
+                if (!malha.hit(Ray{Point3{0, 0, 0}, alvo}, Interval(0.001, Utility::INFTY), registro))
+                    ++falhas;
+            }
+        }
+    }
+
+    EXPECT_EQ(falhas, 0);
+}
+
+TEST(MalhaDeTriangulos, BVHEncontraOMesmoTrianguloQueATestarTodos) {
+    std::vector<double> vertices;
+    std::vector<std::uint32_t> indices;
+    grade(vertices, indices);
+
+    TriangleMesh malha{vertices, indices, 3};
+    EXPECT_EQ(malha.triangle_count(), indices.size() / 3);
+    EXPECT_GT(malha.node_count(), 1u);
+
+    Pcg32 gerador{8};
+    int acertos = 0;
+
+    for (int k = 0; k < 3000; ++k) {
+        Ray raio{Point3{gerador.next_double() - 0.5, gerador.next_double() - 0.5, 0},
+                 Vec3{3 * gerador.next_double() - 1.5, 3 * gerador.next_double() - 1.5, -1}};
+
+        HitRecord registro;
+        double esperado;
+        bool tocou = malha.hit(raio, Interval(0.001, Utility::INFTY), registro);
+
+        ASSERT_EQ(tocou, forca_bruta(vertices, indices, raio, esperado));
+
+        if (tocou) {
+            EXPECT_NEAR(registro.t, esperado, 1e-9);
+            EXPECT_EQ(registro.material, 3u);
+            EXPECT_NEAR(registro.normal_sur_vector.length(), 1.0, 1e-12);
+            ++acertos;
+        }
+    }
+
+    EXPECT_GT(acertos, 500);
+}
+
+TEST(MalhaDeTriangulos, ImportaOBJ) {
+    auto arquivo = arquivo_temporario("ray_tracing_malha_teste.obj");
+    escrever(arquivo,
+             "# quadrado e um triângulo\n"
+             "mtllib nada.mtl\n"
+             "v 0 0 -1\n"
+             "v 1 0 -1\n"
+             "v 1 1 -1\n"
+             "v 0 1 -1 1.0\n"
+             "vn 0 0 1\n"
+             "vt 0.5 0.5\n"
+             "usemtl qualquer\n"
+             "f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+             "v 2 0 -1\n"
+             "f -1 -4//1 -3\n");
+
+    TriangleMesh malha;
+    std::string erro;
+    ASSERT_TRUE(malha.load_obj(arquivo.c_str(), 1, erro)) << erro;
+
+    EXPECT_EQ(malha.vertex_count(), 5u);
+    EXPECT_EQ(malha.triangle_count(), 3u);
+
+    HitRecord registro;
+    EXPECT_TRUE(malha.hit(Ray{Point3{0.2, 0.7, 0}, Vec3{0, 0, -1}}, Interval(0.001, Utility::INFTY), registro));
+    EXPECT_NEAR(registro.t, 1.0, 1e-12);
+    EXPECT_TRUE(malha.hit(Ray{Point3{1.5, 0.1, 0}, Vec3{0, 0, -1}}, Interval(0.001, Utility::INFTY), registro));
+    EXPECT_FALSE(malha.hit(Ray{Point3{1.5, 0.9, 0}, Vec3{0, 0, -1}}, Interval(0.001, Utility::INFTY), registro));
+
+    escrever(arquivo, "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n");
+    EXPECT_FALSE(malha.load_obj(arquivo.c_str(), 0, erro));
+    EXPECT_NE(erro.find("linha 4"), std::string::npos) << erro;
+
+    std::filesystem::remove(arquivo);
+}
+
+TEST(MalhaDeTriangulos, FormatoBinarioMapeadoEquivaleAMalhaOriginal) {
+    std::vector<double> vertices;
+    std::vector<std::uint32_t> indices;
+    grade(vertices, indices);
+
+    TriangleMesh original{vertices, indices, 2};
+
+    auto arquivo = arquivo_temporario("ray_tracing_malha_teste.rtmesh");
+    ASSERT_TRUE(original.save_binary(arquivo.c_str()));
+
+    TriangleMesh mapeada;
+    std::string erro;
+    ASSERT_TRUE(mapeada.load(arquivo.c_str(), 2, erro)) << erro;
+
+    EXPECT_EQ(mapeada.triangle_count(), original.triangle_count());
+    EXPECT_EQ(mapeada.node_count(), original.node_count());
+
+    Pcg32 gerador{4};
+    for (int k = 0; k < 500; ++k) {
+        Ray raio{Point3{0, 0, 0}, Vec3{4 * gerador.next_double() - 2, 4 * gerador.next_double() - 2, -3}};
+        HitRecord esperado, obtido;
+
+        bool tocou = original.hit(raio, Interval(0.001, Utility::INFTY), esperado);
+        ASSERT_EQ(tocou, mapeada.hit(raio, Interval(0.001, Utility::INFTY), obtido));
+
+        if (tocou)
+            EXPECT_EQ(obtido.t, esperado.t);
+    }
+
+    // Um arquivo truncado é rejeitado em vez de ler fora do mapeamento
+    std::filesystem::resize_file(arquivo, std::filesystem::file_size(arquivo) / 2);
+    EXPECT_FALSE(mapeada.load_binary(arquivo.c_str(), 2, erro));
+
+    std::filesystem::remove(arquivo);
+}
+
+TEST(MalhaDeTriangulos, CenaCarregaMalhaRelativaAoArquivoDaCena) {
+    auto diretorio = std::filesystem::temp_directory_path() / "ray_tracing_cena_com_malha";
+    std::filesystem::create_directories(diretorio / "modelos");
+
+    escrever((diretorio / "modelos" / "tri.obj").string(), "v -1 -1 -2\nv 1 -1 -2\nv 0 1 -2\nf 1 2 3\n");
+    escrever((diretorio / "cena.txt").string(),
+             "material m lambertian 0.5 0.5 0.5\n"
+             "sphere 0 0 -5 0.5 m\n"
+             "mesh modelos/tri.obj m\n");
+
+    Scene cena;
+    std::string erro;
+    ASSERT_TRUE(cena.load((diretorio / "cena.txt").string().c_str(), erro)) << erro;
+    ASSERT_EQ(cena.meshes().size(), 1u);
+
+    auto mundo = cena.world();
+    ASSERT_EQ(mundo.objects.size(), 2u);
+
+    // O triângulo fica na frente da esfera
+    HitRecord registro;
+    ASSERT_TRUE(mundo.hit(Ray{Point3{0, 0, 0}, Vec3{0, 0, -1}}, Interval(0.001, Utility::INFTY), registro));
+    EXPECT_NEAR(registro.t, 2.0, 1e-12);
+
+    // As malhas já têm o próprio formato binário
+    EXPECT_FALSE(cena.compile((diretorio / "cena.bin").string().c_str()));
+
+    std::filesystem::remove_all(diretorio);
+}
@@ -171,3 +171,24 @@ TEST(OperadorVetores3D, VetorRandom) {
     EXPECT_NE(vetor3.y(), vetor4.y());
     EXPECT_NE(vetor3.z(), vetor4.z());
 }
+
+TEST(OperadorVetores3D, AvaliacaoEmTempoDeCompilacao) {
+    constexpr Vec3 vetor_u{1, 2, 3};
+    constexpr Vec3 vetor_v{4, 5, 6};
+
+    static_assert((vetor_u * vetor_v) == 32);
+    static_assert((vetor_u % vetor_v).x() == -3);
+    static_assert((vetor_u + vetor_v).z() == 9);
+    static_assert((2 * vetor_u - vetor_v).y() == -1);
+    static_assert(!vetor_u.near_zero() && Vec3{}.near_zero());
+
+    EXPECT_EQ((vetor_u * 2).z(), 6);
+}
+
+TEST(OperadorVetores3D, VetorFloat) {
+    Vec3f vetor{3.0f, 0.0f, 4.0f};
+
+    EXPECT_FLOAT_EQ(vetor.length(), 5.0f);
+    EXPECT_FLOAT_EQ(vetor.unit().z(), 0.8f);
+    EXPECT_FLOAT_EQ((vetor / 2).x(), 1.5f);
+}
@@ -0,0 +1,136 @@
+#include "../lib/environment.hpp"
+#include "../lib/render.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+    // Cena padrão com uma lâmpada pequena acima das esferas e, opcionalmente, um céu em mapa de ambiente
+    HittableList cena_com_luzes(bool com_mapa) {
+        HittableList mundo;
+
+        auto chao = mundo.materials.add(Lambertian{Vec3{0.8, 0.8, 0.0}});
+        auto centro = mundo.materials.add(Lambertian{Vec3{0.1, 0.2, 0.5}});
+        auto esquerda = mundo.materials.add(Metal{Vec3{0.8, 0.8, 0.8}});
+        auto lampada = mundo.materials.add(Emissive{Vec3{20, 18, 15}});
+
+        mundo.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0, -100.5, -1.0), 100.0, chao));
+        mundo.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.0,    0.0, -1.2),   0.5, centro));
+        mundo.add_to_obj_list(std::make_shared<Sphere>(Vec3(-1.0,    0.0, -1.0),   0.5, esquerda));
+        mundo.add_to_obj_list(std::make_shared<Sphere>(Vec3( 0.6,    0.9, -0.8),   0.1, lampada));
+        mundo.build_acceleration();
+        mundo.lights.add_emissive(mundo.objects, mundo.materials);
+
+        if (com_mapa) {
+            // Céu escuro com uma faixa clara no horizonte
+            std::vector<float> rgb(3 * 32 * 16, 0.2f);
+            for (int x = 0; x < 32; ++x)
+                rgb[3 * (7 * 32 + x)] = 30.0f;
+
+            auto mapa = std::make_shared<EnvironmentMap>();
+            mapa->assign(32, 16, std::move(rgb));
+            mundo.lights.set_environment(std::move(mapa));
+        }
+
+        return mundo;
+    }
+
+    struct Resultado {
+        SampleBuffer amostras;
+        RenderStats::Totals contadores;
+    };
+
+    Resultado renderizar(const HittableList &mundo, Integrator integrador, SamplerType amostrador, int amostras_por_pixel,
+                         int threads, double limite_de_erro = 0.0) {
+        Render render{64};
+        render.set_samples_per_pixel(amostras_por_pixel);
+        render.set_sampler(amostrador);
+        render.set_integrator(integrador);
+        render.set_thread_count(threads);
+        render.set_adaptive_sampling(8, limite_de_erro);
+        render.set_quiet(true);
+
+        Resultado resultado;
+        while (!render.render(mundo, resultado.amostras)) {}
+        resultado.contadores = render.stats().totals();
+        return resultado;
+    }
+
+    // As amostras de cada pixel (cor, variância e atributos) e os contadores de raios são os mesmos
+    void esperar_identicos(const Resultado &megakernel, const Resultado &wavefront) {
+        ASSERT_EQ(megakernel.amostras.width(), wavefront.amostras.width());
+
+        for (int j = 0; j < megakernel.amostras.height(); ++j) {
+            for (int i = 0; i < megakernel.amostras.width(); ++i) {
+                const auto &a = megakernel.amostras.pixel(i, j);
+                const auto &b = wavefront.amostras.pixel(i, j);
+
+                ASSERT_EQ(a.count, b.count);
+                for (int eixo = 0; eixo < 3; ++eixo) {
+                    ASSERT_EQ(a.sum[eixo], b.sum[eixo]) << i << ", " << j;
+                    ASSERT_EQ(a.albedo_sum[eixo], b.albedo_sum[eixo]);
+                    ASSERT_EQ(a.normal_sum[eixo], b.normal_sum[eixo]);
+                }
+                ASSERT_EQ(a.luminance_m2, b.luminance_m2);
+                ASSERT_EQ(a.depth_sum, b.depth_sum);
+            }
+        }
+
+        EXPECT_EQ(megakernel.contadores.primary_rays, wavefront.contadores.primary_rays);
+        EXPECT_EQ(megakernel.contadores.secondary_rays, wavefront.contadores.secondary_rays);
+        EXPECT_EQ(megakernel.contadores.shadow_rays, wavefront.contadores.shadow_rays);
+        EXPECT_EQ(megakernel.contadores.bounces, wavefront.contadores.bounces);
+    }
+
+} // namespace
+
+TEST(Wavefront, MesmaImagemDoMegakernelNaCenaPadrao) {
+    auto mundo = Render::default_scene();
+
+    for (auto tipo : {SamplerType::INDEPENDENT, SamplerType::SOBOL, SamplerType::BLUE_NOISE}) {
+        esperar_identicos(renderizar(mundo, Integrator::MEGAKERNEL, tipo, 4, 1),
+                          renderizar(mundo, Integrator::WAVEFRONT, tipo, 4, 3));
+    }
+
+    // Com a amostragem adaptativa, cada rodada só inclui os pixels que ainda não convergiram
+    esperar_identicos(renderizar(mundo, Integrator::MEGAKERNEL, SamplerType::INDEPENDENT, 32, 2, 0.02),
+                      renderizar(mundo, Integrator::WAVEFRONT, SamplerType::INDEPENDENT, 32, 2, 0.02));
+}
+
+TEST(Wavefront, MesmaImagemComLuzesEMapaDeAmbiente) {
+    for (bool com_mapa : {false, true}) {
+        auto mundo = cena_com_luzes(com_mapa);
+
+        auto megakernel = renderizar(mundo, Integrator::MEGAKERNEL, SamplerType::SOBOL, 8, 2);
+        esperar_identicos(megakernel, renderizar(mundo, Integrator::WAVEFRONT, SamplerType::SOBOL, 8, 2));
+        EXPECT_GT(megakernel.contadores.shadow_rays, 0u);
+    }
+}
+
+TEST(Wavefront, RodadasMaioresQueOBufferSaoDivididasEmLotes) {
+    // Um tile de 16 x 16 pixels com 80 amostras tem mais caminhos que WavefrontPaths::MAX_PATHS
+    static_assert(16 * 16 * 80 > WavefrontPaths::MAX_PATHS);
+
+    auto mundo = cena_com_luzes(false);
+    esperar_identicos(renderizar(mundo, Integrator::MEGAKERNEL, SamplerType::INDEPENDENT, 80, 1),
+                      renderizar(mundo, Integrator::WAVEFRONT, SamplerType::INDEPENDENT, 80, 1));
+}
+
+TEST(Wavefront, OrdenarOsRaiosSecundariosNaoMudaAImagem) {
+    auto mundo = cena_com_luzes(true);
+    auto megakernel = renderizar(mundo, Integrator::MEGAKERNEL, SamplerType::INDEPENDENT, 8, 1);
+
+    Render render{64};
+    render.set_samples_per_pixel(8);
+    render.set_adaptive_sampling(8, 0.0);
+    render.set_integrator(Integrator::WAVEFRONT);
+    render.set_ray_sorting(true);
+    render.set_thread_count(2);
+    render.set_quiet(true);
+
+    Resultado ordenado;
+    while (!render.render(mundo, ordenado.amostras)) {}
+    ordenado.contadores = render.stats().totals();
+
+    esperar_identicos(megakernel, ordenado);
+}